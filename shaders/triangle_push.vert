@@ -0,0 +1,15 @@
+#version 450
+
+layout(location = 0) in vec3 aPosition;
+layout(location = 1) in vec3 aColor;
+layout(location = 0) out vec3 vColor;
+
+// Per-draw data recorded into the command buffer: no descriptor set, no UBO memory
+layout(push_constant) uniform Push {
+    mat4 mvp;
+} pc;
+
+void main() {
+    gl_Position = pc.mvp * vec4(aPosition, 1.0);
+    vColor = aColor;
+}
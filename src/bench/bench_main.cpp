@@ -0,0 +1,401 @@
+// Luster benchmark harness: fixed-dt scripted scenarios → frame-time percentiles as JSON
+#include "bench/bench_report.hpp"
+#include "bench/bench_scenario.hpp"
+#include "core/config.hpp"
+#include "core/input.hpp"
+#include "core/platform.hpp"
+#include "core/renderer.hpp"
+#include "core/utils/log.hpp"
+#include "core/window.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace
+{
+	struct Options
+	{
+		std::vector<std::string> scenarios{};
+		uint32_t frames = 600;
+		uint32_t warmupFrames = 60;
+		double dt = 1.0 / 60.0;
+		bool headless = false;
+		uint32_t width = 1280;
+		uint32_t height = 720;
+		double stutterFactor = 2.0;
+		std::string outPath = "bench_result.json";
+		std::string baselinePath{};
+		double threshold = 0.10;
+		bool perfCounters = true;
+		luster::FramePolicy policy = luster::FramePolicy::Custom;
+		bool stateFilter = true;
+		bool pushConstants = true;
+		uint32_t gridSize = 1;
+		int gpuIndex = -1;
+		std::string gpuName{};
+		bool asyncQueues = true;
+		bool computeClear = false;
+	};
+
+	void printUsage()
+	{
+		std::printf(
+			"usage: luster_bench [options]\n"
+			"  --scenario NAME     run NAME (repeatable; default: all)\n"
+			"  --frames N          measured frames per scenario (default 600)\n"
+			"  --warmup N          unmeasured warm-up frames (default 60)\n"
+			"  --dt SECONDS        fixed simulation step (default 1/60)\n"
+			"  --headless          offscreen rendering, no window\n"
+			"  --size WxH          render size (default 1280x720)\n"
+			"  --stutter-factor F  stutter = frame > F * median (default 2.0)\n"
+			"  --out FILE          JSON output (default bench_result.json)\n"
+			"  --baseline FILE     compare against a previous JSON result\n"
+			"  --threshold R       allowed relative regression (default 0.10)\n"
+			"  --no-perf-counters  skip VK_KHR_performance_query counters\n"
+			"  --grid N            N x N cubes (default 1)\n"
+			"  --gpu INDEX|NAME    use this GPU instead of the highest-scoring one\n"
+			"  --no-async-queues   no dedicated compute/transfer queues (A/B for async compute)\n"
+			"  --compute-clear     clear a buffer on the compute queue every frame (async compute path)\n"
+			"  --no-state-filter   forward redundant binds to Vulkan (A/B for state filtering)\n"
+			"  --per-draw MODE     per-draw data: push (push constants, default) | ubo (dynamic-offset UBO)\n"
+			"  --policy NAME       frame policy: low-latency|max-throughput|power-saver|vsync-strict\n"
+			"                      (default: IMMEDIATE present, 1 frame in flight)\n"
+			"  --list              list scenarios\n");
+	}
+
+	bool parseArgs(int argc, char** argv, Options& opt)
+	{
+		for (int i = 1; i < argc; ++i)
+		{
+			const std::string_view arg = argv[i];
+			const bool hasValue = i + 1 < argc;
+			if (arg == "--scenario" && hasValue) opt.scenarios.emplace_back(argv[++i]);
+			else if (arg == "--frames" && hasValue) opt.frames = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+			else if (arg == "--warmup" && hasValue) opt.warmupFrames = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+			else if (arg == "--dt" && hasValue) opt.dt = std::strtod(argv[++i], nullptr);
+			else if (arg == "--headless") opt.headless = true;
+			else if (arg == "--size" && hasValue)
+			{
+				char* end = nullptr;
+				const unsigned long w = std::strtoul(argv[++i], &end, 10);
+				const unsigned long h = (end && *end == 'x') ? std::strtoul(end + 1, nullptr, 10) : 0;
+				if (w == 0 || h == 0) return false;
+				opt.width = static_cast<uint32_t>(w);
+				opt.height = static_cast<uint32_t>(h);
+			}
+			else if (arg == "--stutter-factor" && hasValue) opt.stutterFactor = std::strtod(argv[++i], nullptr);
+			else if (arg == "--out" && hasValue) opt.outPath = argv[++i];
+			else if (arg == "--baseline" && hasValue) opt.baselinePath = argv[++i];
+			else if (arg == "--threshold" && hasValue) opt.threshold = std::strtod(argv[++i], nullptr);
+			else if (arg == "--no-perf-counters") opt.perfCounters = false;
+			else if (arg == "--no-state-filter") opt.stateFilter = false;
+			else if (arg == "--no-async-queues") opt.asyncQueues = false;
+			else if (arg == "--compute-clear") opt.computeClear = true;
+			else if (arg == "--per-draw" && hasValue)
+			{
+				const std::string_view mode = argv[++i];
+				if (mode != "push" && mode != "ubo") return false;
+				opt.pushConstants = mode == "push";
+			}
+			else if (arg == "--gpu" && hasValue)
+			{
+				const std::string_view gpu = argv[++i];
+				if (!gpu.empty() && std::all_of(gpu.begin(), gpu.end(), [](char c) { return c >= '0' && c <= '9'; }))
+					opt.gpuIndex = std::atoi(argv[i]);
+				else
+					opt.gpuName = gpu;
+			}
+			else if (arg == "--grid" && hasValue) opt.gridSize = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+			else if (arg == "--policy" && hasValue)
+			{
+				if (!luster::parseFramePolicy(argv[++i], opt.policy)) return false;
+			}
+			else if (arg == "--list")
+			{
+				for (const auto& s : luster::bench::builtinScenarios()) std::printf("%-12s %s\n", s.name, s.description);
+				luster::Log::shutdown(); // nothing started yet; keeps every exit path the same
+				std::exit(EXIT_SUCCESS);
+			}
+			else return false;
+		}
+		return opt.frames > 0 && opt.dt > 0.0;
+	}
+
+	luster::bench::ScenarioResult runScenario(luster::Renderer& renderer, luster::Window* window,
+	                                          const luster::bench::Scenario& scenario, const Options& opt)
+	{
+		using clock = std::chrono::steady_clock;
+		luster::bench::ScenarioResult result{};
+		result.name = scenario.name;
+		result.dt = opt.dt;
+
+		std::vector<double> cpuMs, gpuMs, recreateMs, presentMs;
+		std::vector<std::string> passNames;
+		std::vector<std::vector<double>> passMs;
+		std::vector<luster::bench::PassStatsSummary> passStats; // sums until the end of the run
+		std::vector<double> counterSums;
+		size_t counterFrames = 0;
+		cpuMs.reserve(opt.frames);
+		gpuMs.reserve(opt.frames);
+
+		const luster::InputSnapshot input{}; // scripted: camera comes from the scenario, not devices
+		const float dt = static_cast<float>(opt.dt);
+		renderer.resetSceneTime();
+		const uint32_t total = opt.warmupFrames + opt.frames;
+		for (uint32_t i = 0; i < total; ++i)
+		{
+			const auto t0 = clock::now();
+			const uint64_t recreatesBefore = renderer.recreateCount();
+			if (scenario.sizeAt)
+			{
+				uint32_t w = opt.width, h = opt.height;
+				scenario.sizeAt(static_cast<double>(i) * opt.dt, w, h);
+				const VkExtent2D cur = renderer.renderExtent();
+				if (w != cur.width || h != cur.height)
+				{
+					if (window) window->setSize(static_cast<int>(w), static_cast<int>(h)); // recreated via the resize event
+					else renderer.resizeOffscreen(w, h);
+				}
+			}
+			if (window)
+			{
+				bool resized = false;
+				if (!window->pollEvents(resized)) break;
+				if (resized) renderer.recreateSwapchain(*window);
+			}
+			renderer.update(dt, input);
+			const auto pose = scenario.cameraAt(static_cast<double>(i) * opt.dt);
+			renderer.camera().setViewLookAt(pose.eye, pose.target, {0.0f, 1.0f, 0.0f});
+			const bool ok = window ? renderer.drawFrame(*window) : renderer.drawFrameHeadless();
+			if (!ok) break;
+			const double frameCpuMs = std::chrono::duration<double, std::milli>(clock::now() - t0).count();
+			if (i < opt.warmupFrames) continue;
+
+			++result.frames;
+			cpuMs.push_back(frameCpuMs);
+			if (renderer.recreateCount() != recreatesBefore) recreateMs.push_back(renderer.lastRecreateMs());
+			const luster::FrameStats& stats = renderer.lastFrameStats();
+			if (stats.gpuMs > 0.0) gpuMs.push_back(stats.gpuMs);
+			if (stats.presentIntervalMs > 0.0) presentMs.push_back(stats.presentIntervalMs);
+			result.commandsIssued += stats.commands.issued;
+			result.commandsSkipped += stats.commands.skipped;
+			result.draws += stats.commands.draws;
+			constexpr double kMiB = 1024.0 * 1024.0;
+			result.gpuMemoryPeakMiB = std::max(result.gpuMemoryPeakMiB, static_cast<double>(stats.gpuMemoryUsedBytes) / kMiB);
+			result.gpuMemoryBudgetMiB = static_cast<double>(stats.gpuMemoryBudgetBytes) / kMiB;
+			result.gpuMemoryEvictedMiB += static_cast<double>(stats.gpuMemoryEvictedBytes) / kMiB;
+			for (const auto& pass : stats.passes)
+			{
+				size_t idx = 0;
+				while (idx < passNames.size() && passNames[idx] != pass.name) ++idx;
+				if (idx == passNames.size())
+				{
+					passNames.emplace_back(pass.name);
+					passMs.emplace_back().reserve(opt.frames);
+				}
+				passMs[idx].push_back(pass.gpuMs);
+
+				if (!pass.hasStats) continue;
+				size_t s = 0;
+				while (s < passStats.size() && passStats[s].name != pass.name) ++s;
+				if (s == passStats.size()) passStats.emplace_back().name = pass.name;
+				auto& sum = passStats[s];
+				++sum.samples;
+				sum.inputAssemblyVertices += static_cast<double>(pass.stats.inputAssemblyVertices);
+				sum.inputAssemblyPrimitives += static_cast<double>(pass.stats.inputAssemblyPrimitives);
+				sum.vertexShaderInvocations += static_cast<double>(pass.stats.vertexShaderInvocations);
+				sum.clippingInvocations += static_cast<double>(pass.stats.clippingInvocations);
+				sum.clippingPrimitives += static_cast<double>(pass.stats.clippingPrimitives);
+				sum.fragmentShaderInvocations += static_cast<double>(pass.stats.fragmentShaderInvocations);
+				sum.computeShaderInvocations += static_cast<double>(pass.stats.computeShaderInvocations);
+			}
+			if (!stats.counters.empty())
+			{
+				counterSums.resize(stats.counters.size(), 0.0);
+				for (size_t c = 0; c < stats.counters.size(); ++c) counterSums[c] += stats.counters[c];
+				++counterFrames;
+			}
+		}
+
+		if (scenario.sizeAt)
+		{
+			// Later scenarios run at the configured size again
+			if (window)
+			{
+				window->setSize(static_cast<int>(opt.width), static_cast<int>(opt.height));
+				renderer.recreateSwapchain(*window);
+			}
+			else renderer.resizeOffscreen(opt.width, opt.height);
+		}
+
+		result.cpu = luster::summarizeFrameTimes(std::move(cpuMs), opt.stutterFactor);
+		result.gpu = luster::summarizeFrameTimes(std::move(gpuMs), opt.stutterFactor);
+		result.recreate = luster::summarizeFrameTimes(std::move(recreateMs), opt.stutterFactor);
+		result.present = luster::summarizeFrameTimes(std::move(presentMs), opt.stutterFactor);
+		if (result.frames > 0)
+		{
+			const double n = static_cast<double>(result.frames);
+			result.commandsIssued /= n;
+			result.commandsSkipped /= n;
+			result.draws /= n;
+		}
+		for (size_t p = 0; p < passNames.size(); ++p)
+			result.passes.push_back({passNames[p], luster::summarizeFrameTimes(std::move(passMs[p]), opt.stutterFactor)});
+		for (auto& ps : passStats)
+		{
+			const double n = static_cast<double>(ps.samples);
+			for (double* v : {&ps.inputAssemblyVertices, &ps.inputAssemblyPrimitives, &ps.vertexShaderInvocations,
+			                  &ps.clippingInvocations, &ps.clippingPrimitives, &ps.fragmentShaderInvocations,
+			                  &ps.computeShaderInvocations})
+				*v /= n;
+		}
+		result.passStats = std::move(passStats);
+		const auto& counterNames = renderer.gpuCounterNames();
+		for (size_t c = 0; c < counterSums.size() && c < counterNames.size(); ++c)
+			result.counters.push_back({counterNames[c], counterSums[c] / static_cast<double>(counterFrames)});
+		const luster::gfx::MemoryStats memory = renderer.device().memoryBudget().stats();
+		result.driverMemoryBudget = memory.driverBudget;
+		for (size_t c = 0; c < luster::gfx::kMemoryCategoryCount; ++c)
+			result.memoryCategories.push_back({luster::gfx::toString(static_cast<luster::gfx::MemoryCategory>(c)),
+			                                   static_cast<double>(memory.categoryBytes[c]) / (1024.0 * 1024.0)});
+		return result;
+	}
+
+	void printSummary(const luster::bench::ScenarioResult& r)
+	{
+		std::printf("%-12s frames=%u  cpu p50=%.3f p95=%.3f p99=%.3f max=%.3f stutters=%u | "
+		            "gpu p50=%.3f p95=%.3f p99=%.3f\n",
+		            r.name.c_str(), r.frames, r.cpu.p50Ms, r.cpu.p95Ms, r.cpu.p99Ms, r.cpu.maxMs, r.cpu.stutterCount,
+		            r.gpu.p50Ms, r.gpu.p95Ms, r.gpu.p99Ms);
+		if (r.recreate.count > 0)
+			std::printf("%-12s recreates=%zu  p50=%.3f p95=%.3f max=%.3f ms\n", "", r.recreate.count,
+			            r.recreate.p50Ms, r.recreate.p95Ms, r.recreate.maxMs);
+		std::printf("%-12s commands/frame issued=%.1f skipped=%.1f draws=%.1f\n", "", r.commandsIssued,
+		            r.commandsSkipped, r.draws);
+		std::printf("%-12s gpu memory peak=%.1f / %.1f MiB%s\n", "", r.gpuMemoryPeakMiB, r.gpuMemoryBudgetMiB,
+		            r.driverMemoryBudget ? "" : " (estimated budget)");
+		if (r.present.count > 0)
+			std::printf("%-12s present interval p50=%.3f p95=%.3f p99=%.3f stutters=%u\n", "", r.present.p50Ms,
+			            r.present.p95Ms, r.present.p99Ms, r.present.stutterCount);
+	}
+}
+
+int main(int argc, char** argv)
+{
+	Options opt{};
+	if (!parseArgs(argc, argv, opt))
+	{
+		printUsage();
+		return EXIT_FAILURE;
+	}
+
+	std::vector<const luster::bench::Scenario*> scenarios;
+	if (opt.scenarios.empty())
+		for (const auto& s : luster::bench::builtinScenarios()) scenarios.push_back(&s);
+	for (const auto& name : opt.scenarios)
+	{
+		const auto* s = luster::bench::findScenario(name);
+		if (!s)
+		{
+			std::fprintf(stderr, "unknown scenario: %s\n", name.c_str());
+			return EXIT_FAILURE;
+		}
+		scenarios.push_back(s);
+	}
+
+	luster::bench::Report report{};
+	int exitCode = EXIT_SUCCESS;
+	try
+	{
+		luster::Log::init();
+		luster::EngineConfig config{};
+		config.headless.enabled = opt.headless;
+		config.headless.width = opt.width;
+		config.headless.height = opt.height;
+		// Measure the renderer, not the display: don't let vsync cap the numbers
+		config.swapchain.preferredPresentMode = VK_PRESENT_MODE_IMMEDIATE_KHR;
+		config.framePolicy = opt.policy; // a named policy replaces the IMMEDIATE default
+		config.device.enablePerformanceQuery = opt.perfCounters;
+		config.pipeline.filterRedundantState = opt.stateFilter;
+		config.pipeline.pushConstants = opt.pushConstants;
+		config.scene.gridSize = opt.gridSize;
+		config.device.preferredDeviceIndex = opt.gpuIndex;
+		config.device.preferredDeviceName = opt.gpuName;
+		config.device.enableAsyncQueues = opt.asyncQueues;
+		config.compute.clearPass = opt.computeClear;
+
+		std::unique_ptr<luster::Window> window;
+		luster::Renderer renderer;
+		if (opt.headless)
+		{
+			renderer.initHeadless(config);
+		}
+		else
+		{
+			luster::Platform::init();
+			window = std::make_unique<luster::Window>("Luster Bench", static_cast<int>(opt.width),
+			                                          static_cast<int>(opt.height),
+			                                          luster::WindowFlags::Vulkan | luster::WindowFlags::Resizable);
+			renderer.init(*window, config);
+		}
+
+		report.mode = opt.headless ? "headless" : "windowed";
+		report.device = renderer.device().name();
+		report.policy = luster::toString(renderer.framePolicy());
+		report.presentMode = opt.headless ? "none" : luster::gfx::toString(renderer.presentMode());
+		report.perDraw = renderer.usesPushConstants() ? "push" : "ubo";
+		report.width = renderer.renderExtent().width;
+		report.height = renderer.renderExtent().height;
+		for (const auto* s : scenarios)
+		{
+			report.scenarios.push_back(runScenario(renderer, window.get(), *s, opt));
+			printSummary(report.scenarios.back());
+		}
+
+		renderer.cleanup();
+		window.reset();
+		if (!opt.headless) luster::Platform::shutdown();
+		luster::Log::shutdown(); // the rest reports through stdio
+	}
+	catch (const std::exception& e)
+	{
+		luster::Log::shutdown();
+		std::fprintf(stderr, "benchmark failed: %s\n", e.what());
+		return EXIT_FAILURE;
+	}
+
+	std::vector<luster::bench::Regression> regressions;
+	if (!opt.baselinePath.empty())
+	{
+		std::ifstream in(opt.baselinePath, std::ios::binary);
+		std::stringstream ss;
+		ss << in.rdbuf();
+		if (!in || !luster::bench::compareToBaseline(report, ss.str(), opt.threshold, regressions))
+		{
+			std::fprintf(stderr, "cannot read baseline: %s\n", opt.baselinePath.c_str());
+			exitCode = EXIT_FAILURE;
+		}
+		// compareToBaseline only reports metrics with a positive baseline: the ratio is always defined
+		for (const auto& r : regressions)
+			std::printf("REGRESSION %s %s: %.3f -> %.3f ms (+%.1f%%)\n", r.scenario.c_str(), r.metric.c_str(),
+			            r.baseline, r.current, (r.current / r.baseline - 1.0) * 100.0);
+		if (!regressions.empty()) exitCode = 2;
+	}
+
+	std::ofstream out(opt.outPath, std::ios::binary);
+	out << luster::bench::toJson(report, regressions);
+	if (!out)
+	{
+		std::fprintf(stderr, "cannot write %s\n", opt.outPath.c_str());
+		return EXIT_FAILURE;
+	}
+	std::printf("wrote %s\n", opt.outPath.c_str());
+	return exitCode;
+}
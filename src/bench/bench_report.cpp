@@ -0,0 +1,256 @@
+#include "bench/bench_report.hpp"
+#include <cctype>
+#include <cstdlib>
+#include <spdlog/fmt/fmt.h>
+
+namespace luster::bench
+{
+	namespace
+	{
+		void appendSummary(std::string& out, const char* key, const FrameTimeSummary& s)
+		{
+			out += fmt::format(
+				"\"{}\": {{\"min\": {:.4f}, \"mean\": {:.4f}, \"p50\": {:.4f}, \"p95\": {:.4f}, \"p99\": {:.4f}, "
+				"\"max\": {:.4f}, \"stutters\": {}, \"samples\": {}}}",
+				key, s.minMs, s.meanMs, s.p50Ms, s.p95Ms, s.p99Ms, s.maxMs, s.stutterCount, s.count);
+		}
+
+		std::string escape(const std::string& s)
+		{
+			std::string out;
+			out.reserve(s.size());
+			for (char c : s)
+			{
+				if (c == '"' || c == '\\') out += '\\';
+				out += c;
+			}
+			return out;
+		}
+
+		// Minimal JSON reader: enough to load reports written by toJson()
+		struct JsonValue
+		{
+			enum class Type { Null, Number, String, Object, Array } type = Type::Null;
+			double number = 0.0;
+			std::string string;
+			std::vector<std::string> keys; // object members, parallel to `array`
+			std::vector<JsonValue> array;
+
+			const JsonValue* find(const std::string& key) const
+			{
+				if (type != Type::Object) return nullptr;
+				for (size_t i = 0; i < keys.size(); ++i)
+					if (keys[i] == key) return &array[i];
+				return nullptr;
+			}
+		};
+
+		class JsonParser
+		{
+		public:
+			explicit JsonParser(const std::string& text) : s_(text) {}
+
+			bool parse(JsonValue& out)
+			{
+				return value(out) && (skipWs(), pos_ == s_.size());
+			}
+
+		private:
+			void skipWs()
+			{
+				while (pos_ < s_.size() && std::isspace(static_cast<unsigned char>(s_[pos_]))) ++pos_;
+			}
+
+			bool consume(char c)
+			{
+				skipWs();
+				if (pos_ < s_.size() && s_[pos_] == c)
+				{
+					++pos_;
+					return true;
+				}
+				return false;
+			}
+
+			bool str(std::string& out)
+			{
+				if (!consume('"')) return false;
+				while (pos_ < s_.size() && s_[pos_] != '"')
+				{
+					if (s_[pos_] == '\\' && pos_ + 1 < s_.size()) ++pos_;
+					out += s_[pos_++];
+				}
+				return pos_ < s_.size() && s_[pos_++] == '"';
+			}
+
+			bool value(JsonValue& out)
+			{
+				skipWs();
+				if (pos_ >= s_.size()) return false;
+				const char c = s_[pos_];
+				if (c == '{')
+				{
+					out.type = JsonValue::Type::Object;
+					++pos_;
+					if (consume('}')) return true;
+					do
+					{
+						out.keys.emplace_back();
+						out.array.emplace_back();
+						if (!str(out.keys.back()) || !consume(':') || !value(out.array.back())) return false;
+					}
+					while (consume(','));
+					return consume('}');
+				}
+				if (c == '[')
+				{
+					out.type = JsonValue::Type::Array;
+					++pos_;
+					if (consume(']')) return true;
+					do
+					{
+						out.array.emplace_back();
+						if (!value(out.array.back())) return false;
+					}
+					while (consume(','));
+					return consume(']');
+				}
+				if (c == '"')
+				{
+					out.type = JsonValue::Type::String;
+					return str(out.string);
+				}
+				if (s_.compare(pos_, 4, "null") == 0 || s_.compare(pos_, 4, "true") == 0)
+				{
+					pos_ += 4;
+					return true;
+				}
+				if (s_.compare(pos_, 5, "false") == 0)
+				{
+					pos_ += 5;
+					return true;
+				}
+				char* end = nullptr;
+				out.number = std::strtod(s_.c_str() + pos_, &end);
+				if (end == s_.c_str() + pos_) return false;
+				out.type = JsonValue::Type::Number;
+				pos_ = static_cast<size_t>(end - s_.c_str());
+				return true;
+			}
+
+			const std::string& s_;
+			size_t pos_ = 0;
+		};
+	}
+
+	std::string toJson(const Report& report, const std::vector<Regression>& regressions)
+	{
+		std::string out;
+		out += "{\n";
+		out += fmt::format("  \"version\": 1,\n  \"mode\": \"{}\",\n  \"device\": \"{}\",\n", report.mode,
+		                   escape(report.device));
+		out += fmt::format("  \"policy\": \"{}\",\n  \"present_mode\": \"{}\",\n", report.policy, report.presentMode);
+		out += fmt::format("  \"per_draw\": \"{}\",\n", report.perDraw);
+		out += fmt::format("  \"width\": {},\n  \"height\": {},\n", report.width, report.height);
+		out += "  \"scenarios\": [\n";
+		for (size_t i = 0; i < report.scenarios.size(); ++i)
+		{
+			const auto& sc = report.scenarios[i];
+			out += fmt::format("    {{\n      \"name\": \"{}\",\n      \"frames\": {},\n      \"dt\": {:.6f},\n      ",
+			                   escape(sc.name), sc.frames, sc.dt);
+			appendSummary(out, "cpu_ms", sc.cpu);
+			out += ",\n      ";
+			appendSummary(out, "gpu_ms", sc.gpu);
+			out += ",\n      ";
+			appendSummary(out, "recreate_ms", sc.recreate);
+			out += ",\n      ";
+			appendSummary(out, "present_interval_ms", sc.present);
+			out += fmt::format(",\n      \"commands\": {{\"issued\": {:.1f}, \"skipped\": {:.1f}, \"draws\": {:.1f}}}",
+			                   sc.commandsIssued, sc.commandsSkipped, sc.draws);
+			out += ",\n      \"passes\": {";
+			for (size_t p = 0; p < sc.passes.size(); ++p)
+			{
+				out += p ? ",\n        " : "\n        ";
+				appendSummary(out, escape(sc.passes[p].name).c_str(), sc.passes[p].gpu);
+			}
+			out += sc.passes.empty() ? "}" : "\n      }";
+			out += ",\n      \"pipeline_stats\": {";
+			for (size_t p = 0; p < sc.passStats.size(); ++p)
+			{
+				const auto& ps = sc.passStats[p];
+				out += fmt::format(
+					"{}\n        \"{}\": {{\"ia_vertices\": {:.1f}, \"ia_primitives\": {:.1f}, \"vs_invocations\": {:.1f}, "
+					"\"clipping_invocations\": {:.1f}, \"clipping_primitives\": {:.1f}, \"fs_invocations\": {:.1f}, "
+					"\"cs_invocations\": {:.1f}, \"samples\": {}}}",
+					p ? "," : "", escape(ps.name), ps.inputAssemblyVertices, ps.inputAssemblyPrimitives,
+					ps.vertexShaderInvocations, ps.clippingInvocations, ps.clippingPrimitives,
+					ps.fragmentShaderInvocations, ps.computeShaderInvocations, ps.samples);
+			}
+			out += sc.passStats.empty() ? "}" : "\n      }";
+			out += ",\n      \"counters\": {";
+			for (size_t c = 0; c < sc.counters.size(); ++c)
+				out += fmt::format("{}\n        \"{}\": {:.4f}", c ? "," : "", escape(sc.counters[c].name),
+				                   sc.counters[c].mean);
+			out += sc.counters.empty() ? "}" : "\n      }";
+			out += fmt::format(",\n      \"gpu_memory\": {{\"peak_mib\": {:.2f}, \"budget_mib\": {:.2f}, "
+			                   "\"evicted_mib\": {:.2f}, \"driver_budget\": {}, \"categories_mib\": {{",
+			                   sc.gpuMemoryPeakMiB, sc.gpuMemoryBudgetMiB, sc.gpuMemoryEvictedMiB,
+			                   sc.driverMemoryBudget ? "true" : "false");
+			for (size_t c = 0; c < sc.memoryCategories.size(); ++c)
+				out += fmt::format("{}\"{}\": {:.2f}", c ? ", " : "", escape(sc.memoryCategories[c].name),
+				                   sc.memoryCategories[c].mib);
+			out += "}}\n";
+			out += i + 1 < report.scenarios.size() ? "    },\n" : "    }\n";
+		}
+		out += "  ],\n  \"regressions\": [";
+		for (size_t i = 0; i < regressions.size(); ++i)
+		{
+			const auto& r = regressions[i];
+			out += fmt::format("{}\n    {{\"scenario\": \"{}\", \"metric\": \"{}\", \"baseline\": {:.4f}, "
+			                   "\"current\": {:.4f}}}", i ? "," : "", escape(r.scenario), r.metric, r.baseline,
+			                   r.current);
+		}
+		out += regressions.empty() ? "]\n}\n" : "\n  ]\n}\n";
+		return out;
+	}
+
+	bool compareToBaseline(const Report& report, const std::string& baselineJson, double threshold,
+	                       std::vector<Regression>& outRegressions)
+	{
+		JsonValue root;
+		if (!JsonParser(baselineJson).parse(root) || root.type != JsonValue::Type::Object) return false;
+		const JsonValue* scenarios = root.find("scenarios");
+		if (!scenarios || scenarios->type != JsonValue::Type::Array) return false;
+
+		for (const auto& current : report.scenarios)
+		{
+			const JsonValue* base = nullptr;
+			for (const auto& s : scenarios->array)
+			{
+				const JsonValue* n = s.find("name");
+				if (n && n->string == current.name) base = &s;
+			}
+			if (!base) continue; // new scenario: nothing to compare against
+
+			const std::pair<const char*, const FrameTimeSummary*> groups[] = {
+				{"cpu_ms", &current.cpu}, {"gpu_ms", &current.gpu}, {"recreate_ms", &current.recreate}
+			};
+			for (const auto& [group, summary] : groups)
+			{
+				const JsonValue* g = base->find(group);
+				if (!g || summary->count == 0) continue;
+				const std::pair<const char*, double> metrics[] = {
+					{"p50", summary->p50Ms}, {"p95", summary->p95Ms}, {"p99", summary->p99Ms}
+				};
+				for (const auto& [metric, value] : metrics)
+				{
+					const JsonValue* b = g->find(metric);
+					if (!b || b->type != JsonValue::Type::Number || b->number <= 0.0) continue;
+					if (value > b->number * (1.0 + threshold))
+						outRegressions.push_back({current.name, std::string(group) + "." + metric, b->number, value});
+				}
+			}
+		}
+		return true;
+	}
+}
@@ -0,0 +1,94 @@
+#pragma once
+
+#include "core/utils/frame_time_stats.hpp"
+#include <string>
+#include <vector>
+
+namespace luster::bench
+{
+	struct PassSummary
+	{
+		std::string name;
+		FrameTimeSummary gpu{};
+	};
+
+	// Per-frame means of a top-level pass's pipeline statistics
+	struct PassStatsSummary
+	{
+		std::string name;
+		size_t samples = 0;
+		double inputAssemblyVertices = 0.0;
+		double inputAssemblyPrimitives = 0.0;
+		double vertexShaderInvocations = 0.0;
+		double clippingInvocations = 0.0;
+		double clippingPrimitives = 0.0;
+		double fragmentShaderInvocations = 0.0;
+		double computeShaderInvocations = 0.0;
+	};
+
+	// Per-frame mean of a VK_KHR_performance_query counter
+	struct CounterSummary
+	{
+		std::string name;
+		double mean = 0.0;
+	};
+
+	// Tracked device memory of one MemoryCategory at the end of a run
+	struct MemoryCategorySummary
+	{
+		std::string name;
+		double mib = 0.0;
+	};
+
+	struct ScenarioResult
+	{
+		std::string name;
+		uint32_t frames = 0;
+		double dt = 0.0;
+		FrameTimeSummary cpu{};
+		FrameTimeSummary gpu{};
+		FrameTimeSummary recreate{}; // swapchain/target recreation time, resize scenarios only
+		FrameTimeSummary present{}; // present-to-present intervals, windowed only
+		// Per-frame means of CommandContext counters
+		double commandsIssued = 0.0;
+		double commandsSkipped = 0.0;
+		double draws = 0.0;
+		std::vector<PassSummary> passes;
+		std::vector<PassStatsSummary> passStats; // empty without pipeline statistics support
+		std::vector<CounterSummary> counters; // empty without VK_KHR_performance_query
+		// Device-local memory: peak usage and budget over the run (driver numbers with VK_EXT_memory_budget)
+		double gpuMemoryPeakMiB = 0.0;
+		double gpuMemoryBudgetMiB = 0.0;
+		double gpuMemoryEvictedMiB = 0.0;
+		bool driverMemoryBudget = false;
+		std::vector<MemoryCategorySummary> memoryCategories;
+	};
+
+	struct Report
+	{
+		std::string mode; // "headless" | "windowed"
+		std::string device;
+		std::string policy; // FramePolicy name
+		std::string presentMode; // granted present mode, "none" headless
+		std::string perDraw; // per-draw data path: "push" | "ubo"
+		uint32_t width = 0;
+		uint32_t height = 0;
+		std::vector<ScenarioResult> scenarios;
+	};
+
+	struct Regression
+	{
+		std::string scenario;
+		std::string metric; // e.g. "cpu_ms.p95"
+		double baseline = 0.0;
+		double current = 0.0;
+	};
+
+	std::string toJson(const Report& report, const std::vector<Regression>& regressions = {});
+
+	// Compares p50/p95/p99 of cpu_ms, gpu_ms and recreate_ms per scenario against a previously written report.
+	// A metric regresses when current > baseline * (1 + threshold); metrics that were 0 (or missing) in the baseline
+	// are skipped, there is no ratio to compare. Returns false if the baseline is unreadable.
+	bool compareToBaseline(const Report& report, const std::string& baselineJson, double threshold,
+	                       std::vector<Regression>& outRegressions);
+}
@@ -0,0 +1,61 @@
+#include "bench/bench_scenario.hpp"
+#include <algorithm>
+#include <cmath>
+#include <iterator>
+
+namespace luster::bench
+{
+	static CameraPose staticCamera(double /*seconds*/)
+	{
+		return CameraPose{};
+	}
+
+	static CameraPose orbitCamera(double seconds)
+	{
+		// One revolution every 8 s at radius 3, slight bob to vary depth
+		const double a = seconds * (2.0 * 3.14159265358979323846 / 8.0);
+		CameraPose p{};
+		p.eye = {static_cast<float>(3.0 * std::sin(a)), static_cast<float>(0.5 * std::sin(a * 0.5)),
+		         static_cast<float>(-3.0 * std::cos(a))};
+		return p;
+	}
+
+	static CameraPose flythroughCamera(double seconds)
+	{
+		// Dolly from far to very close (fills the screen) and strafe sideways
+		const double s = 0.5 + 0.5 * std::sin(seconds * 0.75);
+		CameraPose p{};
+		p.eye = {static_cast<float>(1.5 * std::sin(seconds * 0.4)), 0.25f, static_cast<float>(-(0.9 + 6.0 * s))};
+		p.target = {0.0f, 0.0f, 0.0f};
+		return p;
+	}
+
+	static void resizeStormSize(double seconds, uint32_t& width, uint32_t& height)
+	{
+		// New size every 50 ms, like a user dragging the window corner
+		static constexpr double scales[] = {1.0, 0.8, 0.6, 0.9, 0.7, 0.95};
+		const auto step = static_cast<size_t>(seconds * 20.0);
+		const double s = scales[step % std::size(scales)];
+		width = std::max<uint32_t>(64, static_cast<uint32_t>(width * s));
+		height = std::max<uint32_t>(64, static_cast<uint32_t>(height * s));
+	}
+
+	const std::vector<Scenario>& builtinScenarios()
+	{
+		static const std::vector<Scenario> scenarios = {
+			{"static", "Fixed camera, rotating cube", &staticCamera},
+			{"orbit", "Camera orbits the cube at constant radius", &orbitCamera},
+			{"flythrough", "Camera dollies in/out and strafes (varying coverage)", &flythroughCamera},
+			{"resize_storm", "Orbit while the target is resized every 50 ms (recreate cost)", &orbitCamera,
+			 &resizeStormSize},
+		};
+		return scenarios;
+	}
+
+	const Scenario* findScenario(std::string_view name)
+	{
+		for (const auto& s : builtinScenarios())
+			if (name == s.name) return &s;
+		return nullptr;
+	}
+}
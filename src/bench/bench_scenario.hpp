@@ -0,0 +1,28 @@
+#pragma once
+
+#include <glm/glm.hpp>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+namespace luster::bench
+{
+	struct CameraPose
+	{
+		glm::vec3 eye{0.0f, 0.0f, -3.0f};
+		glm::vec3 target{0.0f, 0.0f, 0.0f};
+	};
+
+	// A scripted scenario: camera is a pure function of scenario time so runs are reproducible
+	struct Scenario
+	{
+		const char* name = "";
+		const char* description = "";
+		CameraPose (*cameraAt)(double seconds) = nullptr;
+		// Optional size script: width/height come in as the configured size; nullptr = fixed size
+		void (*sizeAt)(double seconds, uint32_t& width, uint32_t& height) = nullptr;
+	};
+
+	const std::vector<Scenario>& builtinScenarios();
+	const Scenario* findScenario(std::string_view name);
+}
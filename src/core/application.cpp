@@ -1,30 +1,92 @@
 #include "core/application.hpp"
 #include "core/config.hpp"
 #include "core/platform.hpp"
+#include "core/memory/alloc_tracker.hpp"
+#include "core/utils/profiler.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <iterator>
 #include <stdexcept>
 
 namespace luster
 {
+	// Binary PPM (P6): RGBA8 → RGB8, no external image library required
+	static bool writePpm(const std::string& path, const std::vector<uint8_t>& rgba, uint32_t width, uint32_t height)
+	{
+		FILE* f = std::fopen(path.c_str(), "wb");
+		if (!f) return false;
+		std::fprintf(f, "P6\n%u %u\n255\n", width, height);
+		std::vector<uint8_t> row(static_cast<size_t>(width) * 3);
+		for (uint32_t y = 0; y < height; ++y)
+		{
+			const uint8_t* src = rgba.data() + static_cast<size_t>(y) * width * 4;
+			for (uint32_t x = 0; x < width; ++x)
+			{
+				row[x * 3 + 0] = src[x * 4 + 0];
+				row[x * 3 + 1] = src[x * 4 + 1];
+				row[x * 3 + 2] = src[x * 4 + 2];
+			}
+			std::fwrite(row.data(), 1, row.size(), f);
+		}
+		std::fclose(f);
+		return true;
+	}
+
 	Application::Application() = default;
+	Application::Application(const EngineConfig& config) : config_(config) {}
 	Application::~Application() { cleanup(); }
 
 	void Application::init()
 	{
-		Log::init();
+		{
+			LUSTER_ALLOC_TAG(Logging);
+			Log::init();
+		}
+		Profiler::setRingCapacity(config_.profiling.ringEvents);
+		Profiler::setThreadName("main");
+		if (config_.profiling.captureFrames > 0)
+			Profiler::requestCapture(config_.profiling.captureFrames, config_.profiling.captureDelayFrames);
+		renderer_ = std::make_unique<Renderer>();
+		const double stepHz = config_.simulation.stepHz > 0.0 ? config_.simulation.stepHz : 120.0;
+		simClock_.configure(1.0 / stepHz, config_.simulation.maxStepsPerFrame);
+		if (config_.headless.enabled)
+		{
+			// No SDL video subsystem, window or surface: works on display-less machines (e.g. lavapipe in CI)
+			spdlog::info("Luster starting headless ({}x{}, {} frames)...",
+			             config_.headless.width, config_.headless.height, config_.headless.frameCount);
+			renderer_->initHeadless(config_);
+			if (config_.threading.renderThread)
+				renderThread_.start(*renderer_, nullptr, config_.threading.snapshotArenaBytes);
+			return;
+		}
+
 		spdlog::info("Luster sandbox starting (SDL + Vulkan triangle)...");
+		if (config_.latency.lateLatch && config_.threading.renderThread)
+		{
+			// Input can only be re-sampled on the thread that owns SDL events
+			spdlog::warn("Late latch needs single-threaded rendering; disabled with --render-thread");
+			config_.latency.lateLatch = false;
+		}
+		pacer_.setTargetFps(config_.framePacing.targetFps);
 
-		Platform::init();
+		{
+			LUSTER_ALLOC_TAG(Platform);
+			Platform::init();
 
-		constexpr int width = 1280;
-		constexpr int height = 720;
-		window_ = std::make_unique<Window>(
-			"Luster (Vulkan)", width, height, WindowFlags::Vulkan | WindowFlags::Resizable);
-		renderer_ = std::make_unique<Renderer>();
-		EngineConfig cfg{};
+			constexpr int width = 1280;
+			constexpr int height = 720;
+			window_ = std::make_unique<Window>(
+				"Luster (Vulkan)", width, height, WindowFlags::Vulkan | WindowFlags::Resizable);
+		}
 		// 示例：按需修改 present mode 或 FPS 上报周期
-		// cfg.swapchain.preferredPresentMode = VK_PRESENT_MODE_MAILBOX_KHR; // 如需低延迟（若可用）
-		// cfg.fpsReportIntervalMs = 500.0;
-		renderer_->init(*window_, cfg);
+		// config_.swapchain.preferredPresentMode = VK_PRESENT_MODE_MAILBOX_KHR; // 如需低延迟（若可用）
+		// config_.fpsReportIntervalMs = 500.0;
+		renderer_->init(*window_, config_);
+		if (config_.threading.renderThread)
+		{
+			spdlog::info("Pipelined rendering: game thread builds snapshots, render thread records and presents");
+			renderThread_.start(*renderer_, window_.get(), config_.threading.snapshotArenaBytes);
+		}
 	}
 
 	void Application::mainLoop()
@@ -40,14 +102,29 @@ namespace luster
 		bool prevPToggled = false;
 		bool mouseCaptured = false;
 		bool prevF1 = false;
+		FramePolicy policy = config_.framePolicy;
 		while (running)
 		{
+			PROFILE_FRAME_MARK();
+			flushProfilerCapture();
 			auto now = std::chrono::steady_clock::now();
 			float dt = std::chrono::duration<float>(now - last).count();
 			last = now;
-			running = window_->pollEvents(framebufferResized);
+			{
+				LUSTER_ALLOC_TAG(Platform); // SDL event processing
+				running = window_->pollEvents(framebufferResized);
+			}
+			if (running && !window_->isVisible())
+			{
+				// Nothing to present: sleep until an event (restore/expose) arrives instead of spinning
+				Platform::waitEventsMs(config_.framePacing.backgroundWaitMs);
+				last = std::chrono::steady_clock::now();
+				pacer_.reset();
+				continue;
+			}
 			// Capture input snapshot once per frame
 			auto input = Input::captureSnapshot();
+			renderer_->markInputSampled();
 			// ESC to quit (independent of event handling)
 			{
 				// Pause toggle on P press edge
@@ -63,12 +140,27 @@ namespace luster
 					Platform::setCursorVisible(!mouseCaptured);
 				}
 
+				// F2 cycles frame-delivery policies; the recording thread applies it before its next frame
+				if (input.pressedF2)
+				{
+					const auto& policies = kSelectableFramePolicies;
+					const auto it = std::find(std::begin(policies), std::end(policies), policy);
+					policy = (it == std::end(policies) || it + 1 == std::end(policies)) ? policies[0] : *(it + 1);
+					renderer_->requestFramePolicy(policy);
+				}
+
+				// F3 dumps heap usage per subsystem and the busiest allocation sites (LUSTER_TRACK_ALLOCATIONS)
+				if (input.pressedF3)
+				{
+					spdlog::info("{}", AllocTracker::summary());
+				}
+
 				if (input.keyEsc)
 				{
 					running = false;
 				}
 			}
-			if (framebufferResized)
+			if (framebufferResized && !renderThread_.running())
 			{
 				renderer_->recreateSwapchain(*window_);
 				framebufferResized = false;
@@ -76,12 +168,14 @@ namespace luster
 
 			if (!paused)
 			{
-				renderer_->update(dt, input);
-				if (!renderer_->drawFrame(*window_))
+				stepSimulation(dt, input);
+				// The render thread owns the swapchain: the resize travels with the next snapshot
+				if (!renderFrame(framebufferResized))
 				{
 					// On hard failure, exit the loop
 					running = false;
 				}
+				framebufferResized = false;
 			}
 
 			// Update window title with FPS every second
@@ -90,8 +184,20 @@ namespace luster
 			if (accumSeconds >= 1.0)
 			{
 				const double fps = static_cast<double>(framesSinceUpdate) / (accumSeconds > 0.0 ? accumSeconds : 1.0);
-				char title[160] = {};
-				if (!paused)
+				char title[224] = {};
+				if (!paused && !renderThread_.running())
+				{
+					// Frame stats are owned by the recording thread: only shown when that is this thread
+					const FrameStats& stats = renderer_->lastFrameStats();
+					const FrameTimeSummary present = renderer_->presentIntervalSummary();
+					std::snprintf(title, sizeof(title),
+					              "Luster (Vulkan) - %.1f FPS | input->submit %.2f ms%s | %s %s present p50 %.2f ms | "
+					              "scale %.0f%%%s",
+					              fps, stats.inputToSubmitMs, stats.lateLatched ? " (latched)" : "",
+					              toString(renderer_->framePolicy()), gfx::toString(renderer_->presentMode()),
+					              present.p50Ms, stats.renderScale * 100.0f, mouseCaptured ? " [MouseCaptured]" : "");
+				}
+				else if (!paused)
 					std::snprintf(title, sizeof(title), "Luster (Vulkan) - %.1f FPS%s", fps, mouseCaptured ? " [MouseCaptured]" : "");
 				else
 					std::snprintf(title, sizeof(title), "Luster (Vulkan) - Paused%s", mouseCaptured ? " [MouseCaptured]" : "");
@@ -100,24 +206,112 @@ namespace luster
 				framesSinceUpdate = 0;
 			}
 
-			Platform::sleepMs(1);
+			if (paused)
+			{
+				// Nothing animates while paused: idle until input instead of redrawing at full rate
+				Platform::waitEventsMs(config_.framePacing.backgroundWaitMs);
+				pacer_.reset();
+			}
+			else
+			{
+				pacer_.wait();
+			}
+		}
+	}
+
+	void Application::mainLoopHeadless()
+	{
+		const uint32_t frameCount = config_.headless.frameCount;
+		const InputSnapshot input{}; // no input devices headless
+		const auto start = std::chrono::steady_clock::now();
+		auto last = start;
+		uint32_t frames = 0;
+		// Unthrottled: no present, no sleep — frames run as fast as the GPU allows
+		while (frameCount == 0 || frames < frameCount)
+		{
+			PROFILE_FRAME_MARK();
+			flushProfilerCapture();
+			auto now = std::chrono::steady_clock::now();
+			float dt = std::chrono::duration<float>(now - last).count();
+			last = now;
+			stepSimulation(dt, input);
+			if (!renderFrame(false))
+				break;
+			++frames;
+		}
+		renderThread_.stop(); // drains queued frames before timing and readback
+		PROFILE_FRAME_MARK(); // closes a capture that spans the last frame
+		flushProfilerCapture();
+		const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+		spdlog::info("Headless: {} frames in {:.3f}s ({:.1f} FPS)", frames, seconds,
+		             seconds > 0.0 ? static_cast<double>(frames) / seconds : 0.0);
+
+		if (!config_.headless.readbackPath.empty())
+		{
+			std::vector<uint8_t> rgba;
+			uint32_t w = 0, h = 0;
+			if (renderer_->readbackColor(rgba, w, h) && writePpm(config_.headless.readbackPath, rgba, w, h))
+				spdlog::info("Headless readback written: {}", config_.headless.readbackPath);
+			else
+				spdlog::error("Headless readback failed: {}", config_.headless.readbackPath);
+		}
+	}
+
+	void Application::stepSimulation(double frameSeconds, const InputSnapshot& input)
+	{
+		// Mouse deltas are per frame: hand them to the first step only, and keep them for a later frame
+		// when this one runs no step at all (render rate above the simulation rate)
+		pendingMouseDx_ += input.mouseDx;
+		pendingMouseDy_ += input.mouseDy;
+		const uint32_t steps = simClock_.advance(frameSeconds);
+		InputSnapshot stepInput = input;
+		for (uint32_t i = 0; i < steps; ++i)
+		{
+			stepInput.mouseDx = i == 0 ? pendingMouseDx_ : 0.0f;
+			stepInput.mouseDy = i == 0 ? pendingMouseDy_ : 0.0f;
+			renderer_->simulate(static_cast<float>(simClock_.step()), stepInput);
 		}
+		if (steps > 0) pendingMouseDx_ = pendingMouseDy_ = 0.0f;
+		renderer_->setInterpolationAlpha(static_cast<float>(simClock_.alpha()));
+	}
+
+	bool Application::renderFrame(bool resized)
+	{
+		if (!renderThread_.running())
+			return window_ ? renderer_->drawFrame(*window_) : renderer_->drawFrameHeadless();
+		// Blocks only while the render thread is a full frame behind
+		LinearArena& arena = renderThread_.beginFrame();
+		return renderThread_.submit(renderer_->buildSnapshot(arena, resized));
+	}
+
+	void Application::flushProfilerCapture() const
+	{
+		if (!Profiler::hasCompletedCapture()) return;
+		if (Profiler::writeChromeTrace(config_.profiling.tracePath))
+			spdlog::info("Profiler trace written: {}", config_.profiling.tracePath);
+		else
+			spdlog::error("Profiler trace write failed: {}", config_.profiling.tracePath);
 	}
 
 	void Application::run()
 	{
 		init();
-		mainLoop();
+		if (config_.headless.enabled)
+			mainLoopHeadless();
+		else
+			mainLoop();
+		if (AllocTracker::kEnabled) spdlog::info("{}", AllocTracker::summary());
 		cleanup();
 	}
 
-	void Application::cleanup() const
+	void Application::cleanup()
 	{
-		if (renderer_)
-		{
-			renderer_->cleanup();
-		}
+		renderThread_.stop(); // before any GPU object goes away
+		if (!renderer_) return; // init() never ran, or cleaned up already (run(), then the destructor)
+		renderer_->cleanup();
+		renderer_.reset();
 		Platform::shutdown();
 		spdlog::info("Luster sandbox exiting.");
+		Log::shutdown(); // last: the writer drains everything above, then joins
 	}
 } // namespace luster
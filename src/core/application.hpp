@@ -3,6 +3,10 @@
 
 #include "renderer.hpp"
 #include "core/core.hpp"
+#include "core/config.hpp"
+#include "core/frame_pacer.hpp"
+#include "core/render_thread.hpp"
+#include "core/utils/fixed_step_clock.hpp"
 #include "core/window.hpp"
 #include "core/utils/log.hpp"
 
@@ -12,6 +16,7 @@ namespace luster
 	{
 	public:
 		Application();
+		explicit Application(const EngineConfig& config);
 		~Application();
 
 		void run();
@@ -19,8 +24,19 @@ namespace luster
 	private:
 		void init();
 		void mainLoop();
-		void cleanup() const;
+		void mainLoopHeadless();
+		void stepSimulation(double frameSeconds, const InputSnapshot& input);
+		// Records the current state inline, or hands a snapshot to the render thread; false on failure
+		bool renderFrame(bool resized);
+		void flushProfilerCapture() const;
+		void cleanup();
 
+		EngineConfig config_{};
+		FramePacer pacer_{};
+		FixedStepClock simClock_{};
+		RenderThread renderThread_{};
+		float pendingMouseDx_ = 0.0f;
+		float pendingMouseDy_ = 0.0f;
 		std::unique_ptr<Renderer> renderer_ = nullptr;
 		std::unique_ptr<Window> window_ = nullptr;
 	};
@@ -3,7 +3,21 @@
 
 namespace luster
 {
-    void CameraController::update(Camera& cam, float dt, const InputSnapshot& in) const
+    void CameraController::update(Camera& cam, float dt, const InputSnapshot& in)
+    {
+        step(cam, yaw_, pitch_, dt, in);
+    }
+
+    Camera CameraController::predict(const Camera& cam, float dt, const InputSnapshot& in) const
+    {
+        Camera out = cam;
+        float yaw = yaw_;
+        float pitch = pitch_;
+        step(out, yaw, pitch, dt, in);
+        return out;
+    }
+
+    void CameraController::step(Camera& cam, float& yaw, float& pitch, float dt, const InputSnapshot& in) const
     {
         // Compute basis from camera data
         glm::vec3 eye = cam.eye();
@@ -24,8 +38,6 @@ namespace luster
         if (in.keyE) { eye += up * speed;      target += up * speed; }
 
         // Mouse look (LMB)
-        static float yaw = 0.0f;
-        static float pitch = 0.0f;
         if (in.mouseButtons & SDL_BUTTON_LMASK)
         {
             yaw   += in.mouseDx * mouseSensitivity_;
@@ -19,9 +19,17 @@ namespace luster
         float slowMultiplier() const { return slowMultiplier_; }
         float mouseSensitivity() const { return mouseSensitivity_; }
 
-        void update(Camera& cam, float dt, const InputSnapshot& in) const;
+        // Simulation step: moves `cam` and advances the mouse-look angles
+        void update(Camera& cam, float dt, const InputSnapshot& in);
+        // Where update() would put `cam`, without changing anything (late latch prediction)
+        Camera predict(const Camera& cam, float dt, const InputSnapshot& in) const;
 
     private:
+        void step(Camera& cam, float& yaw, float& pitch, float dt, const InputSnapshot& in) const;
+
+        // Mouse-look angles (radians), accumulated by update()
+        float yaw_ = 0.0f;
+        float pitch_ = 0.0f;
         float moveSpeed_ = 8.0f;
         float fastMultiplier_ = 3.0f;
         float slowMultiplier_ = 0.3f;
@@ -2,6 +2,8 @@
 
 #include "core/gfx/device.hpp"
 #include "core/gfx/swapchain.hpp"
+#include "core/frame_policy.hpp"
+#include <string>
 
 namespace luster
 {
@@ -9,6 +11,9 @@ namespace luster
 	{
 		gfx::Device::InitParams device{};
 		gfx::SwapchainCreateInfo swapchain{}; // preferredPresentMode 可设置为 FIFO/MAILBOX 等
+		// 帧交付策略：非 Custom 时统一决定 present mode、交换链图像数与 CPU 在途帧数（覆盖 swapchain/framesInFlight）
+		FramePolicy framePolicy = FramePolicy::Custom;
+		uint32_t framesInFlight = 1; // 1..3
 		double fpsReportIntervalMs = 500.0; // FPS 输出间隔
 		struct CameraControllerOptions
 		{
@@ -21,6 +26,78 @@ namespace luster
 		{
 			bool enableDepthTest = true;
 			bool enableDepthWrite = true;
+			bool filterRedundantState = true; // CommandContext drops rebinds of already-bound state
+			// 每个 draw 的 MVP 走 push constants；false 为动态偏移 UBO（开启 late latch 时强制 UBO）
+			bool pushConstants = true;
 		} pipeline;
+		// 无窗口离屏渲染：不创建 SDL 窗口/Surface/Swapchain，渲染到 gfx::Image
+		struct HeadlessOptions
+		{
+			bool enabled = false;
+			uint32_t width = 1280;
+			uint32_t height = 720;
+			uint32_t frameCount = 300; // frames to render before exiting (0 = unbounded)
+			std::string readbackPath{}; // non-empty: write the last frame as PPM
+		} headless;
+		// 场景：gridSize x gridSize 个立方体，按视锥剔除（1 = 原点处单个立方体）
+		struct SceneOptions
+		{
+			uint32_t gridSize = 1;
+			float spacing = 2.5f;
+			bool sortDraws = true; // 按排序键（状态，再由近到远）提交；false 为场景顺序
+		} scene;
+		// 渲染线程：游戏线程生成帧快照，渲染线程录制/提交/呈现（流水线，延迟一帧）
+		struct ThreadingOptions
+		{
+			bool renderThread = false;
+			size_t snapshotArenaBytes = 256 * 1024; // per arena, two alternate between frames
+			uint32_t drawSortThreads = 1; // radix sort threads; only lists above 16k draws go parallel
+		} threading;
+		// 延迟：late latch 在提交前重新采样输入并重写相机矩阵（仅单线程模式；渲染线程模式下忽略）
+		struct LatencyOptions
+		{
+			bool lateLatch = false;
+			float maxLatchSeconds = 0.05f; // clamp for the re-integration step (stalls, breakpoints)
+		} latency;
+		// 固定步长模拟：与渲染帧率解耦，渲染时按 alpha 插值
+		struct SimulationOptions
+		{
+			double stepHz = 120.0;
+			uint32_t maxStepsPerFrame = 8; // 超出部分丢弃，防止“死亡螺旋”
+		} simulation;
+		// 帧节奏：目标帧率（0 = 不限制，交由 present mode/vsync），窗口最小化或被遮挡时阻塞等待事件
+		struct FramePacingOptions
+		{
+			double targetFps = 0.0;
+			uint32_t backgroundWaitMs = 100; // max wait per loop iteration while not visible
+		} framePacing;
+		// 动态分辨率（仅窗口模式）：场景渲染到交换链尺寸的离屏目标的左上子区域，按 GPU 帧时间调整比例，再线性 blit 放大
+		struct DynamicResolutionOptions
+		{
+			bool enabled = false;
+			double targetGpuMs = 12.0;
+			float minScale = 0.5f;
+			float maxScale = 1.0f;
+		} dynamicResolution;
+		// 内存：GPU 内存整理（Renderer::gpuAllocator() 中的资源从稀疏块逐帧搬到更满的块，空块归还驱动）与每帧 CPU 线性内存
+		struct MemoryOptions
+		{
+			uint32_t defragBudgetKiB = 4096; // bytes copied per frame at most; 0 = off
+			size_t frameArenaBytes = 64 * 1024; // Renderer::frameArena(), per frame in flight
+		} memory;
+		// 异步计算：clearPass 每帧在计算队列上清零一小块缓冲并交给图形阶段，用于验证提交/信号量/所有权转移路径
+		// （仅在未通过 Renderer::setComputeRecorder 注册计算工作时生效）
+		struct ComputeOptions
+		{
+			bool clearPass = false;
+		} compute;
+		// CPU profiler capture (Chrome trace JSON, also opens in ui.perfetto.dev)
+		struct ProfilingOptions
+		{
+			uint32_t captureFrames = 0; // 0 = no capture
+			uint32_t captureDelayFrames = 0; // skip start-up frames before capturing
+			std::string tracePath = "luster_trace.json";
+			uint32_t ringEvents = 1u << 16; // per recording thread (24 B each); longer captures need more
+		} profiling;
 	};
 }
@@ -0,0 +1,29 @@
+#include "core/draw_list.hpp"
+#include "core/utils/profiler.hpp"
+#include "core/utils/radix_sort.hpp"
+
+namespace luster
+{
+	void DrawList::reserve(size_t n)
+	{
+		keys_.reserve(n);
+		draws_.reserve(n);
+		keyScratch_.reserve(n);
+		drawScratch_.reserve(n);
+	}
+
+	void DrawList::clear()
+	{
+		keys_.clear();
+		draws_.clear();
+	}
+
+	void DrawList::sort(uint32_t threadCount)
+	{
+		PROFILE_SCOPE("DrawList::sort");
+		keyScratch_.resize(keys_.size());
+		drawScratch_.resize(draws_.size());
+		radixSortPairs(keys_.data(), draws_.data(), keys_.size(), keyScratch_.data(), drawScratch_.data(),
+		               threadCount);
+	}
+}
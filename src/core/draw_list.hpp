@@ -0,0 +1,69 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace luster
+{
+	// 64-bit draw sort keys. Ascending key order is submission order.
+	//   opaque:      pass:4 | pipeline:12 | material:12 | mesh:12 | depth:24      (state first, then front-to-back)
+	//   transparent: pass:4 | ~depth:24   | pipeline:12 | material:12 | mesh:12  (back-to-front first, for blending)
+	// IDs are truncated to their field width; depth is a normalized [0,1] view distance.
+	namespace sortkey
+	{
+		inline constexpr uint32_t kPassBits = 4;
+		inline constexpr uint32_t kIdBits = 12;
+		inline constexpr uint32_t kDepthBits = 24;
+
+		inline uint64_t quantizeDepth(float depth01)
+		{
+			const float d = depth01 < 0.0f ? 0.0f : (depth01 > 1.0f ? 1.0f : depth01);
+			return static_cast<uint64_t>(d * static_cast<float>((1u << kDepthBits) - 1) + 0.5f);
+		}
+
+		inline uint64_t opaque(uint32_t pass, uint32_t pipeline, uint32_t material, uint32_t mesh, float depth01)
+		{
+			constexpr uint64_t id = (1u << kIdBits) - 1;
+			return (static_cast<uint64_t>(pass & 0xFu) << 60) | ((pipeline & id) << 48) | ((material & id) << 36) |
+				((mesh & id) << 24) | quantizeDepth(depth01);
+		}
+
+		inline uint64_t transparent(uint32_t pass, float depth01, uint32_t pipeline, uint32_t material, uint32_t mesh)
+		{
+			constexpr uint64_t id = (1u << kIdBits) - 1;
+			constexpr uint64_t depthMask = (uint64_t{1} << kDepthBits) - 1;
+			return (static_cast<uint64_t>(pass & 0xFu) << 60) | ((depthMask - quantizeDepth(depth01)) << 36) |
+				((pipeline & id) << 24) | ((material & id) << 12) | (mesh & id);
+		}
+	}
+
+	// Visible draws of one frame between culling and recording: add (key, draw index) pairs, sort, then
+	// record in order(). Buffers are kept across frames, so steady-state frames do not allocate.
+	class DrawList
+	{
+	public:
+		void reserve(size_t n);
+		void clear();
+		void add(uint64_t key, uint32_t draw)
+		{
+			keys_.push_back(key);
+			draws_.push_back(draw);
+		}
+
+		// Stable radix sort by key; threadCount > 1 parallelizes large lists
+		void sort(uint32_t threadCount = 1);
+
+		size_t size() const { return keys_.size(); }
+		bool empty() const { return keys_.empty(); }
+		const uint64_t* keys() const { return keys_.data(); }
+		// Draw indices in submission order (after sort())
+		const uint32_t* order() const { return draws_.data(); }
+
+	private:
+		std::vector<uint64_t> keys_{};
+		std::vector<uint32_t> draws_{};
+		std::vector<uint64_t> keyScratch_{};
+		std::vector<uint32_t> drawScratch_{};
+	};
+}
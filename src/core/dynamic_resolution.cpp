@@ -0,0 +1,50 @@
+#include "core/dynamic_resolution.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace luster
+{
+	void DynamicResolutionController::configure(const Settings& settings)
+	{
+		settings_ = settings;
+		settings_.minScale = std::clamp(settings_.minScale, 0.1f, 1.0f);
+		settings_.maxScale = std::clamp(settings_.maxScale, settings_.minScale, 1.0f);
+		reset();
+	}
+
+	void DynamicResolutionController::reset()
+	{
+		scale_ = settings_.maxScale;
+		smoothedMs_ = 0.0;
+		cooldown_ = 0;
+	}
+
+	float DynamicResolutionController::update(double gpuMs)
+	{
+		if (gpuMs <= 0.0 || settings_.targetGpuMs <= 0.0) return scale_;
+		smoothedMs_ = smoothedMs_ > 0.0 ? smoothedMs_ + (gpuMs - smoothedMs_) * settings_.smoothing : gpuMs;
+		if (cooldown_ > 0)
+		{
+			--cooldown_;
+			return scale_;
+		}
+
+		const double target = settings_.targetGpuMs;
+		const bool over = smoothedMs_ > target;
+		const bool under = smoothedMs_ < target * (1.0 - settings_.headroom);
+		if (!over && !under) return scale_;
+
+		// Aim for the middle of the band: pixels scale with area, so the axis scale goes with the square root
+		const double aim = over ? target * (1.0 - settings_.headroom * 0.5) : target;
+		const float ideal = scale_ * static_cast<float>(std::sqrt(aim / smoothedMs_));
+		const float next = std::clamp(std::clamp(ideal, scale_ - settings_.maxStep, scale_ + settings_.maxStep),
+		                              settings_.minScale, settings_.maxScale);
+		if (next == scale_) return scale_;
+
+		// Predict the new cost so the EMA does not drag the old resolution's history along
+		smoothedMs_ *= static_cast<double>(next * next) / static_cast<double>(scale_ * scale_);
+		scale_ = next;
+		cooldown_ = settings_.cooldownFrames;
+		return scale_;
+	}
+}
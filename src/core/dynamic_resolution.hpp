@@ -0,0 +1,43 @@
+#pragma once
+
+#include <cstdint>
+
+namespace luster
+{
+	// Picks a render scale (fraction of the output extent per axis) that holds the GPU frame time near a
+	// budget. GPU cost is assumed proportional to pixel count, i.e. scale^2; timings arrive a frame or two
+	// late, so every change is followed by a cooldown instead of reacting to stale samples.
+	class DynamicResolutionController
+	{
+	public:
+		struct Settings
+		{
+			double targetGpuMs = 12.0;
+			float minScale = 0.5f;
+			float maxScale = 1.0f;
+			double headroom = 0.15; // grow only below (1 - headroom) * target: avoids oscillating at the edge
+			float maxStep = 0.1f; // per adjustment
+			uint32_t cooldownFrames = 6; // resolved samples ignored after a change
+			double smoothing = 0.25; // EMA weight of the newest sample
+		};
+
+		DynamicResolutionController() = default;
+		explicit DynamicResolutionController(const Settings& settings) { configure(settings); }
+
+		void configure(const Settings& settings);
+		// Feed one resolved GPU frame time; returns the scale to render with from now on
+		float update(double gpuMs);
+		// Back to maxScale (e.g. after the output was resized)
+		void reset();
+
+		float scale() const { return scale_; }
+		double smoothedGpuMs() const { return smoothedMs_; }
+		const Settings& settings() const { return settings_; }
+
+	private:
+		Settings settings_{};
+		float scale_ = 1.0f;
+		double smoothedMs_ = 0.0;
+		uint32_t cooldown_ = 0;
+	};
+}
@@ -0,0 +1,61 @@
+#include "core/frame_pacer.hpp"
+#include "core/platform.hpp"
+#include <algorithm>
+#include <cmath>
+#include <thread>
+
+namespace luster
+{
+	namespace
+	{
+		// Below this much remaining time we only spin: a sleep could not return in time anyway
+		constexpr double kMinSleepNs = 200'000.0;
+		constexpr double kEmaAlpha = 0.1;
+	}
+
+	void FramePacer::setTargetFps(double fps)
+	{
+		targetFps_ = fps > 0.0 ? fps : 0.0;
+		period_ = targetFps_ > 0.0
+			? std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0 / targetFps_))
+			: Clock::duration{0};
+		deadline_ = {};
+	}
+
+	void FramePacer::wait()
+	{
+		if (!isLimited()) return;
+		const auto now = Clock::now();
+		if (deadline_ == Clock::time_point{})
+		{
+			deadline_ = now + period_;
+		}
+		else
+		{
+			deadline_ += period_;
+			// More than a frame behind: resynchronise instead of rushing frames to catch up
+			if (deadline_ + period_ < now) deadline_ = now;
+		}
+		sleepUntil(deadline_);
+	}
+
+	void FramePacer::sleepUntil(Clock::time_point deadline)
+	{
+		for (;;)
+		{
+			const auto now = Clock::now();
+			const double remainingNs = std::chrono::duration<double, std::nano>(deadline - now).count();
+			// Keep a margin of the expected overshoot plus two deviations, so late wakeups are rare
+			const double margin = overshootNs_ + 2.0 * overshootDevNs_;
+			if (remainingNs - margin < kMinSleepNs) break;
+
+			const double requestNs = remainingNs - margin;
+			Platform::sleepNs(static_cast<uint64_t>(requestNs));
+			const double sleptNs = std::chrono::duration<double, std::nano>(Clock::now() - now).count();
+			const double overshoot = std::max(0.0, sleptNs - requestNs);
+			overshootDevNs_ += kEmaAlpha * (std::abs(overshoot - overshootNs_) - overshootDevNs_);
+			overshootNs_ += kEmaAlpha * (overshoot - overshootNs_);
+		}
+		while (Clock::now() < deadline) std::this_thread::yield();
+	}
+}
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+
+namespace luster
+{
+	// Paces the main loop to a target frame rate with a hybrid wait: an OS sleep for the bulk of the
+	// interval, stopped early by the predicted sleep overshoot, then a short spin to the exact deadline.
+	// Deadlines advance by whole periods so jitter in one frame does not shift the following ones.
+	class FramePacer
+	{
+	public:
+		using Clock = std::chrono::steady_clock;
+
+		FramePacer() = default;
+		explicit FramePacer(double targetFps) { setTargetFps(targetFps); }
+
+		// <= 0 disables pacing (unlimited; presentation may still block on vsync)
+		void setTargetFps(double fps);
+		double targetFps() const { return targetFps_; }
+		bool isLimited() const { return period_.count() > 0; }
+
+		// Blocks until the next frame deadline
+		void wait();
+		// Forget the deadline (e.g. after the loop was paused or throttled in the background)
+		void reset() { deadline_ = {}; }
+
+		// Current sleep overshoot prediction
+		double overshootEstimateUs() const { return overshootNs_ / 1000.0; }
+
+	private:
+		void sleepUntil(Clock::time_point deadline);
+
+		double targetFps_ = 0.0;
+		Clock::duration period_{0};
+		Clock::time_point deadline_{};
+		// EMA of how much longer than requested OS sleeps take; starts pessimistic (1 ms)
+		double overshootNs_ = 1.0e6;
+		double overshootDevNs_ = 0.0;
+	};
+}
@@ -0,0 +1,95 @@
+#pragma once
+
+#include "core/gfx/swapchain.hpp"
+#include <cstdint>
+#include <string_view>
+
+namespace luster
+{
+	// Named frame-delivery policies: each picks present mode, swapchain image count and CPU frames in flight
+	// together. Custom leaves EngineConfig::swapchain / framesInFlight as configured.
+	enum class FramePolicy : uint8_t
+	{
+		Custom,
+		LowLatency, // MAILBOX (else IMMEDIATE), 1 frame in flight: newest frame wins, CPU never runs ahead
+		MaxThroughput, // IMMEDIATE (else MAILBOX), 3 frames in flight: GPU never starves, tearing allowed
+		PowerSaver, // FIFO, minimum images, 1 frame in flight: capped at refresh, idle as much as possible
+		VsyncStrict, // FIFO only (never FIFO_RELAXED), 2 frames in flight: no tearing, smooth pacing
+	};
+
+	inline constexpr FramePolicy kSelectableFramePolicies[] = {
+		FramePolicy::LowLatency, FramePolicy::MaxThroughput, FramePolicy::PowerSaver, FramePolicy::VsyncStrict
+	};
+
+	struct FramePolicySettings
+	{
+		gfx::SwapchainCreateInfo swapchain{};
+		uint32_t framesInFlight = 1;
+	};
+
+	// `base` supplies format/color space (and everything for Custom)
+	inline FramePolicySettings framePolicySettings(FramePolicy policy, const gfx::SwapchainCreateInfo& base,
+	                                               uint32_t baseFramesInFlight)
+	{
+		FramePolicySettings s{base, baseFramesInFlight};
+		auto& sc = s.swapchain;
+		switch (policy)
+		{
+		case FramePolicy::Custom:
+			break;
+		case FramePolicy::LowLatency:
+			sc.preferredPresentMode = VK_PRESENT_MODE_MAILBOX_KHR;
+			sc.fallbackPresentModes = {VK_PRESENT_MODE_IMMEDIATE_KHR, VK_PRESENT_MODE_FIFO_RELAXED_KHR, VK_PRESENT_MODE_FIFO_KHR};
+			sc.fallbackPresentModeCount = 3;
+			sc.extraImages = 1; // MAILBOX needs a spare image to replace
+			s.framesInFlight = 1;
+			break;
+		case FramePolicy::MaxThroughput:
+			sc.preferredPresentMode = VK_PRESENT_MODE_IMMEDIATE_KHR;
+			sc.fallbackPresentModes = {VK_PRESENT_MODE_MAILBOX_KHR, VK_PRESENT_MODE_FIFO_RELAXED_KHR, VK_PRESENT_MODE_FIFO_KHR};
+			sc.fallbackPresentModeCount = 3;
+			sc.extraImages = 2;
+			s.framesInFlight = 3;
+			break;
+		case FramePolicy::PowerSaver:
+			sc.preferredPresentMode = VK_PRESENT_MODE_FIFO_KHR;
+			sc.fallbackPresentModeCount = 0; // FIFO only
+			sc.extraImages = 0;
+			s.framesInFlight = 1;
+			break;
+		case FramePolicy::VsyncStrict:
+			sc.preferredPresentMode = VK_PRESENT_MODE_FIFO_KHR;
+			sc.fallbackPresentModeCount = 0; // FIFO only
+			sc.extraImages = 1;
+			s.framesInFlight = 2;
+			break;
+		}
+		return s;
+	}
+
+	inline const char* toString(FramePolicy policy)
+	{
+		switch (policy)
+		{
+		case FramePolicy::LowLatency: return "low-latency";
+		case FramePolicy::MaxThroughput: return "max-throughput";
+		case FramePolicy::PowerSaver: return "power-saver";
+		case FramePolicy::VsyncStrict: return "vsync-strict";
+		default: return "custom";
+		}
+	}
+
+	inline bool parseFramePolicy(std::string_view name, FramePolicy& out)
+	{
+		for (FramePolicy p : {FramePolicy::Custom, FramePolicy::LowLatency, FramePolicy::MaxThroughput,
+		                      FramePolicy::PowerSaver, FramePolicy::VsyncStrict})
+		{
+			if (name == toString(p))
+			{
+				out = p;
+				return true;
+			}
+		}
+		return false;
+	}
+}
@@ -0,0 +1,35 @@
+#pragma once
+
+#include "core/core.hpp"
+#include <glm/glm.hpp>
+#include <chrono>
+#include <cstdint>
+
+namespace luster
+{
+	// Per-draw data uploaded into the renderer's dynamic uniform buffer
+	struct DrawConstants
+	{
+		glm::mat4 mvp{1.0f};
+	};
+
+	// Immutable input for recording one frame. Built on the game thread (Renderer::buildSnapshot) out of a
+	// LinearArena, consumed by whichever thread records; the arena must outlive renderSnapshot().
+	struct FrameSnapshot
+	{
+		uint64_t frameIndex = 0;
+		glm::mat4 view{1.0f};
+		glm::mat4 proj{1.0f};
+		glm::mat4 viewProj{1.0f};
+		glm::vec3 eye{0.0f}; // interpolated camera the view was built from (late latch re-integrates it)
+		glm::vec3 target{0.0f};
+		VkExtent2D extent{}; // extent the projection was built for
+		std::chrono::steady_clock::time_point inputSampleTime{}; // when the input behind this frame was read
+		const uint32_t* visibleObjects = nullptr; // indices into the scene, drawCount entries
+		const DrawConstants* drawConstants = nullptr; // parallel to visibleObjects
+		const glm::mat4* models = nullptr; // parallel to visibleObjects, for rebuilding MVPs
+		uint32_t drawCount = 0;
+		uint32_t culledCount = 0;
+		bool resized = false; // window framebuffer changed: recreate the swapchain before drawing
+	};
+}
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+namespace luster
+{
+	// VK_QUERY_TYPE_PIPELINE_STATISTICS counters of one pass
+	struct PipelineStatistics
+	{
+		uint64_t inputAssemblyVertices = 0;
+		uint64_t inputAssemblyPrimitives = 0;
+		uint64_t vertexShaderInvocations = 0;
+		uint64_t clippingInvocations = 0; // primitives entering clipping
+		uint64_t clippingPrimitives = 0; // primitives leaving clipping (culled ones are gone)
+		uint64_t fragmentShaderInvocations = 0;
+		uint64_t computeShaderInvocations = 0;
+	};
+
+	struct PassTiming
+	{
+		const char* name = ""; // static string literal
+		double gpuMs = 0.0;
+		uint32_t depth = 0; // GPU scope nesting level, 0 = top-level pass
+		bool hasStats = false; // top-level passes only, when the device supports pipeline statistics
+		PipelineStatistics stats{};
+	};
+
+	// Commands recorded through CommandContext in one frame: issued vs. dropped as redundant rebinds
+	struct CommandCounts
+	{
+		uint32_t issued = 0;
+		uint32_t skipped = 0;
+		uint32_t draws = 0;
+	};
+
+	// Per-frame measurements published by Renderer after each submitted frame
+	struct FrameStats
+	{
+		uint64_t frameNumber = 0;
+		double cpuMs = 0.0; // CPU time spent in drawFrame (record + submit + present)
+		double gpuMs = 0.0; // 0 when no GPU frame resolved since the previous one (timings lag 1-2 frames)
+		// Latency markers: last input sample (the late-latch sample when enabled) → vkQueueSubmit, and
+		// vkQueueSubmit → vkQueuePresentKHR returned (0 headless)
+		double inputToSubmitMs = 0.0;
+		double submitToPresentMs = 0.0;
+		bool lateLatched = false;
+		// Time since the previous present returned (0 headless and on the first frame after a policy switch)
+		double presentIntervalMs = 0.0;
+		// Dynamic resolution: fraction of the output extent per axis the scene was rendered at (1 when off)
+		float renderScale = 1.0f;
+		CommandCounts commands{};
+		// Device-local heaps after this frame (driver numbers with VK_EXT_memory_budget, else tracked allocations),
+		// and bytes evicted over budget this frame
+		uint64_t gpuMemoryUsedBytes = 0;
+		uint64_t gpuMemoryBudgetBytes = 0;
+		uint64_t gpuMemoryEvictedBytes = 0;
+		uint64_t gpuMemoryDefragBytes = 0; // moved by the defragmenter in this frame
+		// Global heap allocations of the recording thread during the frame (Debug builds; 0 when not counted)
+		uint64_t heapAllocations = 0;
+		// LUSTER_TRACK_ALLOCATIONS builds: the process allocated far more than usual during this frame
+		bool heapAllocationSpike = false;
+		std::vector<PassTiming> passes{};
+		// Whole-frame VK_KHR_performance_query counters, parallel to Renderer::gpuCounterNames()
+		std::vector<double> counters{};
+	};
+}
@@ -0,0 +1,186 @@
+#include "core/gfx/async_compute.hpp"
+#include "core/gfx/command_context.hpp"
+#include "core/gfx/device.hpp"
+#include <stdexcept>
+
+namespace luster::gfx
+{
+	void AsyncCompute::create(const Device& device)
+	{
+		device_ = device.logical();
+		vk_ = &device.vk();
+		queue_ = device.computeQueue();
+		computeFamily_ = device.computeQueueFamily();
+		graphicsFamily_ = device.gfxQueueFamily();
+
+		VkCommandPoolCreateInfo pci{VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO};
+		pci.queueFamilyIndex = computeFamily_;
+		pci.flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
+		if (vk_->CreateCommandPool(device_, &pci, nullptr, &pool_) != VK_SUCCESS)
+			throw std::runtime_error("vkCreateCommandPool (compute) failed");
+
+		std::array<VkCommandBuffer, kMaxSlots> cmds{};
+		VkCommandBufferAllocateInfo ai{VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO};
+		ai.commandPool = pool_;
+		ai.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+		ai.commandBufferCount = kMaxSlots;
+		if (vk_->AllocateCommandBuffers(device_, &ai, cmds.data()) != VK_SUCCESS)
+			throw std::runtime_error("vkAllocateCommandBuffers (compute) failed");
+		for (uint32_t i = 0; i < kMaxSlots; ++i) slots_[i].cmd = cmds[i];
+
+		VkSemaphoreTypeCreateInfo type{VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO};
+		type.semaphoreType = VK_SEMAPHORE_TYPE_TIMELINE;
+		type.initialValue = 0;
+		VkSemaphoreCreateInfo sci{VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO};
+		if (device.capabilities().timelineSemaphore)
+		{
+			sci.pNext = &type;
+			if (vk_->CreateSemaphore(device_, &sci, nullptr, &timeline_) != VK_SUCCESS)
+				throw std::runtime_error("vkCreateSemaphore (compute timeline) failed");
+		}
+		else
+		{
+			for (auto& s : slots_)
+				if (vk_->CreateSemaphore(device_, &sci, nullptr, &s.done) != VK_SUCCESS)
+					throw std::runtime_error("vkCreateSemaphore (compute) failed");
+		}
+		submitted_ = 0;
+		spdlog::info("Async compute: {} (family {})", isAsync() ? "dedicated queue" : "graphics queue",
+		             computeFamily_);
+	}
+
+	void AsyncCompute::cleanup(const Device& device)
+	{
+		const VkDevice dev = device.logical();
+		for (auto& s : slots_)
+		{
+			if (s.done) device.vk().DestroySemaphore(dev, s.done, nullptr);
+			s = {};
+		}
+		if (timeline_) device.vk().DestroySemaphore(dev, timeline_, nullptr);
+		if (pool_) device.vk().DestroyCommandPool(dev, pool_, nullptr);
+		timeline_ = VK_NULL_HANDLE;
+		pool_ = VK_NULL_HANDLE;
+		cmd_ = VK_NULL_HANDLE;
+		queue_ = VK_NULL_HANDLE;
+		device_ = VK_NULL_HANDLE;
+		vk_ = nullptr;
+		acquires_.reset();
+		acquireStages_ = 0;
+		writeStages_ = 0;
+	}
+
+	VkCommandBuffer AsyncCompute::begin(uint32_t slot, std::pmr::memory_resource* frameMemory)
+	{
+		slot_ = slot % kMaxSlots;
+		cmd_ = slots_[slot_].cmd;
+		acquires_.emplace(frameMemory);
+		acquireStages_ = 0;
+		writeStages_ = 0;
+		vk_->ResetCommandBuffer(cmd_, 0);
+		VkCommandBufferBeginInfo bi{VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO};
+		bi.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+		if (vk_->BeginCommandBuffer(cmd_, &bi) != VK_SUCCESS)
+			throw std::runtime_error("vkBeginCommandBuffer (compute) failed");
+		return cmd_;
+	}
+
+	void AsyncCompute::releaseBuffer(VkBuffer buffer, VkDeviceSize offset, VkDeviceSize size,
+	                                 VkPipelineStageFlags srcStage, VkAccessFlags srcAccess,
+	                                 VkPipelineStageFlags dstStage, VkAccessFlags dstAccess)
+	{
+		acquireStages_ |= dstStage;
+		// Same queue: the semaphore wait already makes the writes visible to the waiting stages
+		if (!isAsync()) return;
+
+		VkBufferMemoryBarrier release{VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER};
+		release.srcAccessMask = srcAccess;
+		release.dstAccessMask = 0; // ignored on the releasing queue
+		release.srcQueueFamilyIndex = computeFamily_;
+		release.dstQueueFamilyIndex = graphicsFamily_;
+		release.buffer = buffer;
+		release.offset = offset;
+		release.size = size;
+		vk_->CmdPipelineBarrier(cmd_, srcStage, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, 0, 0, nullptr, 1, &release, 0,
+		                        nullptr);
+
+		// The acquire repeats the release's ranges and families
+		VkBufferMemoryBarrier acquire = release;
+		acquire.srcAccessMask = 0; // ignored on the acquiring queue
+		acquire.dstAccessMask = dstAccess;
+		acquires_->buffers.push_back(acquire);
+	}
+
+	void AsyncCompute::releaseImage(VkImage image, VkImageAspectFlags aspect, VkImageLayout oldLayout,
+	                                VkImageLayout newLayout, VkPipelineStageFlags srcStage, VkAccessFlags srcAccess,
+	                                VkPipelineStageFlags dstStage, VkAccessFlags dstAccess)
+	{
+		VkImageMemoryBarrier barrier{VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER};
+		barrier.oldLayout = oldLayout;
+		barrier.newLayout = newLayout;
+		barrier.image = image;
+		barrier.subresourceRange = {aspect, 0, 1, 0, 1};
+		acquireStages_ |= dstStage;
+		if (!isAsync())
+		{
+			// Same queue: a plain barrier in the graphics command buffer; submission order puts the compute
+			// writes in its first scope
+			barrier.srcAccessMask = srcAccess;
+			barrier.dstAccessMask = dstAccess;
+			barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+			barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+			writeStages_ |= srcStage;
+			acquires_->images.push_back(barrier);
+			return;
+		}
+
+		barrier.srcAccessMask = srcAccess;
+		barrier.dstAccessMask = 0;
+		barrier.srcQueueFamilyIndex = computeFamily_;
+		barrier.dstQueueFamilyIndex = graphicsFamily_;
+		vk_->CmdPipelineBarrier(cmd_, srcStage, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, 0, 0, nullptr, 0, nullptr, 1,
+		                        &barrier);
+		// Both halves carry the same layout transition; it executes once
+		barrier.srcAccessMask = 0;
+		barrier.dstAccessMask = dstAccess;
+		acquires_->images.push_back(barrier);
+	}
+
+	void AsyncCompute::submit(CommandContext& graphics)
+	{
+		if (vk_->EndCommandBuffer(cmd_) != VK_SUCCESS)
+			throw std::runtime_error("vkEndCommandBuffer (compute) failed");
+
+		VkSemaphore signal = timeline_ ? timeline_ : slots_[slot_].done;
+		const uint64_t value = ++submitted_;
+		VkTimelineSemaphoreSubmitInfo tsi{VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO};
+		tsi.signalSemaphoreValueCount = 1;
+		tsi.pSignalSemaphoreValues = &value;
+		VkSubmitInfo si{VK_STRUCTURE_TYPE_SUBMIT_INFO};
+		si.pNext = timeline_ ? &tsi : nullptr;
+		si.commandBufferCount = 1;
+		si.pCommandBuffers = &cmd_;
+		si.signalSemaphoreCount = 1;
+		si.pSignalSemaphores = &signal;
+		if (vk_->QueueSubmit(queue_, 1, &si, VK_NULL_HANDLE) != VK_SUCCESS)
+			throw std::runtime_error("vkQueueSubmit (compute) failed");
+		cmd_ = VK_NULL_HANDLE;
+
+		// Nothing released: plain ordering, graphics must not start anything before the compute work ends
+		const VkPipelineStageFlags wait = acquireStages_ ? acquireStages_ : VK_PIPELINE_STAGE_ALL_COMMANDS_BIT;
+		graphics.addWait(signal, wait, timeline_ ? value : 0);
+	}
+
+	void AsyncCompute::recordAcquires(VkCommandBuffer graphicsCmd)
+	{
+		if (!acquires_ || (acquires_->buffers.empty() && acquires_->images.empty())) return;
+		// Cross-family: the source stages are the semaphore's wait stages, which chains the acquire (and its layout
+		// transition) after the wait. Same family: the stages that wrote the images.
+		const VkPipelineStageFlags src = isAsync() ? acquireStages_ : writeStages_;
+		vk_->CmdPipelineBarrier(graphicsCmd, src, acquireStages_, 0, 0, nullptr,
+		                        static_cast<uint32_t>(acquires_->buffers.size()), acquires_->buffers.data(),
+		                        static_cast<uint32_t>(acquires_->images.size()), acquires_->images.data());
+		acquires_->buffers.clear();
+		acquires_->images.clear();
+	}
+}
@@ -0,0 +1,100 @@
+#pragma once
+
+#include "core/core.hpp"
+#include <array>
+#include <memory_resource>
+#include <optional>
+#include <vector>
+
+namespace luster::gfx
+{
+	class Device;
+	struct DeviceDispatch;
+	class CommandContext;
+
+	// Compute work (culling, simulation, post) submitted on the dedicated compute queue ahead of a graphics frame,
+	// which waits for it by semaphore: on GPUs with async compute it overlaps the previous frame's rasterization.
+	// Without a dedicated compute family (lavapipe, many integrated GPUs) the same calls submit to the graphics
+	// queue and ownership transfers are skipped, so callers do not branch.
+	//
+	// Per frame: begin(slot) → record dispatches → release*() the results graphics reads → submit(ctx) →
+	// recordAcquires(graphics command buffer) before the first use. Slots follow CommandContext::frameSlot(), so a
+	// slot's command buffer is reused only after the graphics frame that waited on it completed (its fence).
+	// Released resources are not handed back: the next compute write discards their contents, which needs no
+	// ownership transfer. Resources written again while a previous frame reads them need one copy per slot.
+	class AsyncCompute
+	{
+	public:
+		static constexpr uint32_t kMaxSlots = 3; // CommandContext::kMaxFramesInFlight
+
+		AsyncCompute() = default;
+		~AsyncCompute() = default;
+
+		void create(const Device& device);
+		void cleanup(const Device& device);
+
+		// Separate queue family: releases become queue family ownership transfers
+		bool isAsync() const { return computeFamily_ != graphicsFamily_; }
+		uint32_t queueFamily() const { return computeFamily_; }
+
+		// `frameMemory` holds this frame's acquire list: it must stay valid until recordAcquires() (a FrameArenas
+		// resource, reset once the slot's frame retired)
+		VkCommandBuffer begin(uint32_t slot, std::pmr::memory_resource* frameMemory = std::pmr::get_default_resource());
+		VkCommandBuffer commandBuffer() const { return cmd_; }
+
+		// Makes compute writes visible to graphics at dstStage/dstAccess. The release half is recorded now (after
+		// the writes), the acquire half is queued for recordAcquires().
+		void releaseBuffer(VkBuffer buffer, VkDeviceSize offset, VkDeviceSize size,
+		                   VkPipelineStageFlags srcStage, VkAccessFlags srcAccess,
+		                   VkPipelineStageFlags dstStage, VkAccessFlags dstAccess);
+		// Same for a single-mip, single-layer image; the layout transition happens as part of the transfer
+		void releaseImage(VkImage image, VkImageAspectFlags aspect, VkImageLayout oldLayout, VkImageLayout newLayout,
+		                  VkPipelineStageFlags srcStage, VkAccessFlags srcAccess,
+		                  VkPipelineStageFlags dstStage, VkAccessFlags dstAccess);
+
+		// Ends recording, submits and adds the semaphore wait to `graphics`' next submit
+		void submit(CommandContext& graphics);
+		// Acquire half of this frame's transfers (same family: the image layout transitions); call at the start
+		// of the graphics command buffer, after submit()
+		void recordAcquires(VkCommandBuffer graphicsCmd);
+
+	private:
+		struct Slot
+		{
+			VkCommandBuffer cmd = VK_NULL_HANDLE;
+			VkSemaphore done = VK_NULL_HANDLE; // binary; unused with a timeline semaphore
+		};
+		struct Acquires
+		{
+			static constexpr size_t kReserve = 8; // arena storage: growing leaves the old buffer behind
+
+			explicit Acquires(std::pmr::memory_resource* memory) : buffers(memory), images(memory)
+			{
+				buffers.reserve(kReserve);
+				images.reserve(kReserve);
+			}
+
+			std::pmr::vector<VkBufferMemoryBarrier> buffers;
+			std::pmr::vector<VkImageMemoryBarrier> images;
+		};
+
+		VkDevice device_ = VK_NULL_HANDLE;
+		const DeviceDispatch* vk_ = nullptr; // owned by the Device passed to create()
+		VkQueue queue_ = VK_NULL_HANDLE;
+		uint32_t computeFamily_ = 0;
+		uint32_t graphicsFamily_ = 0;
+		VkCommandPool pool_ = VK_NULL_HANDLE;
+		std::array<Slot, kMaxSlots> slots_{};
+		uint32_t slot_ = 0;
+		VkCommandBuffer cmd_ = VK_NULL_HANDLE; // recording, between begin() and submit()
+		// Timeline semaphore when supported: one object, value = submissions so far
+		VkSemaphore timeline_ = VK_NULL_HANDLE;
+		uint64_t submitted_ = 0;
+
+		// Acquire barriers of the frame being recorded (rebuilt on begin() in that frame's memory), and the
+		// stages graphics waits in
+		std::optional<Acquires> acquires_{};
+		VkPipelineStageFlags acquireStages_ = 0;
+		VkPipelineStageFlags writeStages_ = 0; // same family: source stages of the image barriers
+	};
+}
@@ -0,0 +1,195 @@
+#pragma once
+
+#include "core/core.hpp"
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstring>
+
+namespace luster::gfx
+{
+	struct CommandCounter
+	{
+		uint32_t issued = 0;
+		uint32_t skipped = 0;
+	};
+
+	// Per command buffer: what reached Vulkan vs. what was filtered as redundant
+	struct CommandStats
+	{
+		CommandCounter pipelines{};
+		CommandCounter vertexBuffers{};
+		CommandCounter indexBuffers{};
+		CommandCounter descriptorSets{};
+		CommandCounter pushConstants{};
+		CommandCounter dynamicState{}; // viewport + scissor pairs
+		uint32_t draws = 0;
+
+		uint32_t issued() const
+		{
+			return pipelines.issued + vertexBuffers.issued + indexBuffers.issued + descriptorSets.issued +
+				pushConstants.issued + dynamicState.issued;
+		}
+
+		uint32_t skipped() const
+		{
+			return pipelines.skipped + vertexBuffers.skipped + indexBuffers.skipped + descriptorSets.skipped +
+				pushConstants.skipped + dynamicState.skipped;
+		}
+	};
+
+	// Shadow of the state bound in one command buffer. Each set* returns true when the call changes
+	// something (and records it), false when it would rebind exactly what is already bound. Bookkeeping only:
+	// issuing the Vulkan command is the caller's job. State is undefined in a fresh command buffer: reset().
+	class BindStateCache
+	{
+	public:
+		static constexpr uint32_t kMaxVertexBindings = 8;
+		static constexpr uint32_t kMaxDescriptorSets = 4;
+		static constexpr uint32_t kMaxDynamicOffsets = 8; // per set; more are never filtered
+		static constexpr uint32_t kMaxPushConstantBytes = 128; // guaranteed minimum maxPushConstantsSize
+
+		void reset() { *this = BindStateCache{}; }
+
+		// A pipeline with static viewport/scissor replaces the dynamic ones when bound: forget them
+		bool setPipeline(VkPipeline pipeline, bool dynamicViewport = true)
+		{
+			if (pipeline == pipeline_) return false;
+			pipeline_ = pipeline;
+			if (!dynamicViewport) viewportValid_ = false;
+			return true;
+		}
+
+		bool setVertexBuffers(uint32_t firstBinding, const VkBuffer* buffers, const VkDeviceSize* offsets,
+		                      uint32_t count)
+		{
+			if (firstBinding + count > kMaxVertexBindings)
+			{
+				// Untracked range: forget what we knew about the overlapping bindings
+				for (uint32_t b = firstBinding; b < kMaxVertexBindings; ++b) vertex_[b] = {};
+				return true;
+			}
+			bool changed = false;
+			for (uint32_t i = 0; i < count; ++i)
+			{
+				auto& slot = vertex_[firstBinding + i];
+				if (slot.valid && slot.buffer == buffers[i] && slot.offset == offsets[i]) continue;
+				slot = {buffers[i], offsets[i], true};
+				changed = true;
+			}
+			return changed;
+		}
+
+		bool setIndexBuffer(VkBuffer buffer, VkDeviceSize offset, VkIndexType type)
+		{
+			if (indexValid_ && indexBuffer_ == buffer && indexOffset_ == offset && indexType_ == type) return false;
+			indexBuffer_ = buffer;
+			indexOffset_ = offset;
+			indexType_ = type;
+			indexValid_ = true;
+			return true;
+		}
+
+		bool setDescriptorSets(VkPipelineLayout layout, uint32_t firstSet, const VkDescriptorSet* sets,
+		                       uint32_t count, const uint32_t* dynamicOffsets, uint32_t dynamicOffsetCount)
+		{
+			// Dynamic offsets are only attributable to a set when a single set is bound
+			const bool trackable = firstSet + count <= kMaxDescriptorSets &&
+				(dynamicOffsetCount == 0 || (count == 1 && dynamicOffsetCount <= kMaxDynamicOffsets));
+			if (!trackable)
+			{
+				for (uint32_t s = std::min(firstSet, kMaxDescriptorSets); s < kMaxDescriptorSets; ++s) sets_[s] = {};
+				return true;
+			}
+			bool changed = false;
+			for (uint32_t i = 0; i < count; ++i)
+			{
+				const auto& slot = sets_[firstSet + i];
+				if (!slot.valid || slot.set != sets[i] || slot.layout != layout) changed = true;
+			}
+			if (!changed && count == 1)
+			{
+				const auto& slot = sets_[firstSet];
+				changed = slot.offsetCount != dynamicOffsetCount ||
+					!std::equal(dynamicOffsets, dynamicOffsets + dynamicOffsetCount, slot.offsets.begin());
+			}
+			if (!changed) return false;
+			for (uint32_t i = 0; i < count; ++i)
+			{
+				auto& slot = sets_[firstSet + i];
+				slot.set = sets[i];
+				slot.layout = layout;
+				slot.offsetCount = count == 1 ? dynamicOffsetCount : 0;
+				if (count == 1) std::copy_n(dynamicOffsets, dynamicOffsetCount, slot.offsets.begin());
+				slot.valid = true;
+			}
+			// A different layout may disturb higher sets (pipeline layout compatibility): forget them
+			for (uint32_t s = firstSet + count; s < kMaxDescriptorSets; ++s)
+				if (sets_[s].valid && sets_[s].layout != layout) sets_[s] = {};
+			return true;
+		}
+
+		bool setPushConstants(VkPipelineLayout layout, VkShaderStageFlags stages, uint32_t offset, uint32_t size,
+		                      const void* data)
+		{
+			if (offset + size > kMaxPushConstantBytes)
+			{
+				pushLayout_ = VK_NULL_HANDLE;
+				return true;
+			}
+			if (pushLayout_ != layout || pushStages_ != stages)
+			{
+				// Different layout/stages: previously pushed bytes are no longer known to be valid
+				pushLayout_ = layout;
+				pushStages_ = stages;
+				pushValid_.fill(false);
+			}
+			bool changed = false;
+			for (uint32_t i = offset; i < offset + size && !changed; ++i) changed = !pushValid_[i];
+			if (!changed) changed = std::memcmp(pushBytes_.data() + offset, data, size) != 0;
+			if (!changed) return false;
+			std::memcpy(pushBytes_.data() + offset, data, size);
+			std::fill_n(pushValid_.begin() + offset, size, true);
+			return true;
+		}
+
+		bool setViewportScissor(VkExtent2D extent)
+		{
+			if (viewportValid_ && viewport_.width == extent.width && viewport_.height == extent.height) return false;
+			viewport_ = extent;
+			viewportValid_ = true;
+			return true;
+		}
+
+	private:
+		struct VertexBinding
+		{
+			VkBuffer buffer = VK_NULL_HANDLE;
+			VkDeviceSize offset = 0;
+			bool valid = false;
+		};
+
+		struct SetBinding
+		{
+			VkDescriptorSet set = VK_NULL_HANDLE;
+			VkPipelineLayout layout = VK_NULL_HANDLE;
+			std::array<uint32_t, kMaxDynamicOffsets> offsets{};
+			uint32_t offsetCount = 0;
+			bool valid = false;
+		};
+
+		VkPipeline pipeline_ = VK_NULL_HANDLE;
+		std::array<VertexBinding, kMaxVertexBindings> vertex_{};
+		VkBuffer indexBuffer_ = VK_NULL_HANDLE;
+		VkDeviceSize indexOffset_ = 0;
+		VkIndexType indexType_ = VK_INDEX_TYPE_UINT16;
+		bool indexValid_ = false;
+		std::array<SetBinding, kMaxDescriptorSets> sets_{};
+		VkPipelineLayout pushLayout_ = VK_NULL_HANDLE;
+		VkShaderStageFlags pushStages_ = 0;
+		std::array<uint8_t, kMaxPushConstantBytes> pushBytes_{};
+		std::array<bool, kMaxPushConstantBytes> pushValid_{};
+		VkExtent2D viewport_{};
+		bool viewportValid_ = false;
+	};
+}
@@ -0,0 +1,77 @@
+#include "core/gfx/block_allocator.hpp"
+#include <algorithm>
+
+namespace luster::gfx
+{
+	void BlockAllocator::reset(Size capacity)
+	{
+		free_.clear();
+		capacity_ = capacity;
+		used_ = 0;
+		if (capacity) free_.emplace(0, capacity);
+	}
+
+	std::optional<BlockAllocator::Size> BlockAllocator::allocate(Size size, Size alignment)
+	{
+		if (size == 0) return std::nullopt;
+		alignment = std::max<Size>(alignment, 1);
+		auto best = free_.end();
+		Size bestStart = 0;
+		Size bestLeftover = 0;
+		for (auto it = free_.begin(); it != free_.end(); ++it)
+		{
+			const Size start = (it->first + alignment - 1) & ~(alignment - 1);
+			const Size end = it->first + it->second;
+			if (start + size > end) continue;
+			const Size leftover = end - (start + size) + (start - it->first);
+			if (best == free_.end() || leftover < bestLeftover)
+			{
+				best = it;
+				bestStart = start;
+				bestLeftover = leftover;
+				if (leftover == 0) break;
+			}
+		}
+		if (best == free_.end()) return std::nullopt;
+
+		// Split into the alignment gap before and the tail after; both stay free
+		const Size rangeOffset = best->first;
+		const Size rangeEnd = best->first + best->second;
+		free_.erase(best);
+		if (bestStart > rangeOffset) free_.emplace(rangeOffset, bestStart - rangeOffset);
+		if (bestStart + size < rangeEnd) free_.emplace(bestStart + size, rangeEnd - (bestStart + size));
+		used_ += size;
+		return bestStart;
+	}
+
+	void BlockAllocator::free(Size offset, Size size)
+	{
+		if (size == 0) return;
+		used_ -= std::min(used_, size);
+		auto next = free_.lower_bound(offset);
+		// Merge with the preceding range if it ends here
+		if (next != free_.begin())
+		{
+			auto prev = std::prev(next);
+			if (prev->first + prev->second == offset)
+			{
+				offset = prev->first;
+				size += prev->second;
+				free_.erase(prev);
+			}
+		}
+		if (next != free_.end() && offset + size == next->first)
+		{
+			size += next->second;
+			free_.erase(next);
+		}
+		free_.emplace(offset, size);
+	}
+
+	BlockAllocator::Size BlockAllocator::largestFreeRange() const
+	{
+		Size largest = 0;
+		for (const auto& [offset, size] : free_) largest = std::max(largest, size);
+		return largest;
+	}
+}
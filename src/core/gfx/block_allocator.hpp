@@ -0,0 +1,37 @@
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <optional>
+
+namespace luster::gfx
+{
+	// Offset allocator for one device memory block: best-fit over a free list ordered by offset, neighbours
+	// coalesced on free. Pure bookkeeping, no Vulkan calls.
+	class BlockAllocator
+	{
+	public:
+		using Size = uint64_t;
+
+		BlockAllocator() = default;
+		explicit BlockAllocator(Size capacity) { reset(capacity); }
+
+		void reset(Size capacity);
+		// Offset of `size` bytes aligned to `alignment` (power of two), or nullopt when no free range fits
+		std::optional<Size> allocate(Size size, Size alignment);
+		// `offset`/`size` exactly as returned/requested by allocate()
+		void free(Size offset, Size size);
+
+		Size capacity() const { return capacity_; }
+		Size used() const { return used_; }
+		Size freeBytes() const { return capacity_ - used_; }
+		Size largestFreeRange() const;
+		size_t freeRangeCount() const { return free_.size(); }
+		bool empty() const { return used_ == 0; }
+
+	private:
+		std::map<Size, Size> free_{}; // offset -> size
+		Size capacity_ = 0;
+		Size used_ = 0;
+	};
+}
@@ -1,23 +1,12 @@
 // Single, clean implementation (removed duplicate definitions)
 #include "core/gfx/buffer.hpp"
 #include "core/gfx/device.hpp"
+#include "core/gfx/gpu_allocator.hpp"
 #include <stdexcept>
 #include <cstring>
 
 namespace luster::gfx
 {
-	static uint32_t findMemoryType(VkPhysicalDevice gpu, uint32_t typeFilter, VkMemoryPropertyFlags properties)
-	{
-		VkPhysicalDeviceMemoryProperties memProperties{};
-		vkGetPhysicalDeviceMemoryProperties(gpu, &memProperties);
-		for (uint32_t i = 0; i < memProperties.memoryTypeCount; i++)
-		{
-			if ((typeFilter & (1u << i)) && (memProperties.memoryTypes[i].propertyFlags & properties) == properties)
-				return i;
-		}
-		throw std::runtime_error("No suitable memory type found");
-	}
-
 	void Buffer::create(const Device& device, const BufferCreateInfo& info)
 	{
 		cleanup(device);
@@ -28,62 +17,94 @@ namespace luster::gfx
 		bi.usage = info.usage;
 		bi.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
 
-		VkResult r = vkCreateBuffer(device.logical(), &bi, nullptr, &buffer_);
+		VkResult r = device.vk().CreateBuffer(device.logical(), &bi, nullptr, &buffer_);
 		if (r != VK_SUCCESS) throw std::runtime_error("vkCreateBuffer failed");
 
 		VkMemoryRequirements req{};
-		vkGetBufferMemoryRequirements(device.logical(), buffer_, &req);
-
-		VkMemoryAllocateInfo ai{VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO};
-		ai.allocationSize = req.size;
-		ai.memoryTypeIndex = findMemoryType(device.physical(), req.memoryTypeBits, info.properties);
+		device.vk().GetBufferMemoryRequirements(device.logical(), buffer_, &req);
 
-		r = vkAllocateMemory(device.logical(), &ai, nullptr, &memory_);
-		if (r != VK_SUCCESS) throw std::runtime_error("vkAllocateMemory failed");
+		allocation_ = device.allocateMemory(req, info.properties, info.category);
+		device.vk().BindBufferMemory(device.logical(), buffer_, allocation_.memory, 0);
+		hostVisible_ = (info.properties & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT) != 0;
+		if (info.persistentMap && hostVisible_)
+		{
+			r = device.vk().MapMemory(device.logical(), allocation_.memory, 0, size_, 0, &mapped_);
+			if (r != VK_SUCCESS) throw std::runtime_error("vkMapMemory failed");
+		}
+	}
 
-		vkBindBufferMemory(device.logical(), buffer_, memory_, 0);
+	void Buffer::create(GpuAllocator& allocator, const BufferCreateInfo& info)
+	{
+		if (allocator_) allocator_->destroy(resource_);
+		resource_ = allocator.createBuffer(info);
+		allocator_ = &allocator;
+		size_ = info.size;
 		hostVisible_ = (info.properties & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT) != 0;
+		mapped_ = allocator.mapped(resource_); // the block's mapping: never moves, never unmapped
 	}
 
 	void Buffer::cleanup(const Device& device)
 	{
-		if (memory_)
+		if (allocator_)
 		{
-			vkFreeMemory(device.logical(), memory_, nullptr);
-			memory_ = VK_NULL_HANDLE;
+			// Released at the allocator's next collect(): callers destroy only once the GPU is done with it
+			allocator_->destroy(resource_);
+			allocator_ = nullptr;
+			resource_ = {};
+			mapped_ = nullptr;
+			size_ = 0;
+			return;
 		}
+		if (mapped_)
+		{
+			device.vk().UnmapMemory(device.logical(), allocation_.memory);
+			mapped_ = nullptr;
+		}
+		device.freeMemory(allocation_);
 		if (buffer_)
 		{
-			vkDestroyBuffer(device.logical(), buffer_, nullptr);
+			device.vk().DestroyBuffer(device.logical(), buffer_, nullptr);
 			buffer_ = VK_NULL_HANDLE;
 		}
 		size_ = 0;
 	}
 
+	VkBuffer Buffer::handle() const
+	{
+		return allocator_ ? allocator_->buffer(resource_) : buffer_;
+	}
+
 	void* Buffer::map(const Device& device)
 	{
+		if (mapped_) return mapped_;
 		void* data = nullptr;
-		VkResult r = vkMapMemory(device.logical(), memory_, 0, size_, 0, &data);
+		VkResult r = device.vk().MapMemory(device.logical(), allocation_.memory, 0, size_, 0, &data);
 		if (r != VK_SUCCESS) throw std::runtime_error("vkMapMemory failed");
 		return data;
 	}
 
 	void Buffer::unmap(const Device& device)
 	{
-		vkUnmapMemory(device.logical(), memory_);
+		if (mapped_) return;
+		device.vk().UnmapMemory(device.logical(), allocation_.memory);
 	}
 
 	void Buffer::upload(const Device& device, const void* src, VkDeviceSize size)
 	{
 		if (size == 0 || !src) return;
+		if (allocator_)
+		{
+			allocator_->upload(resource_, src, size);
+			return;
+		}
 		// Try direct map
 		if (hostVisible_)
 		{
 			void* dst = nullptr;
-			if (vkMapMemory(device.logical(), memory_, 0, size_, 0, &dst) != VK_SUCCESS)
+			if (device.vk().MapMemory(device.logical(), allocation_.memory, 0, size_, 0, &dst) != VK_SUCCESS)
 				throw std::runtime_error("vkMapMemory failed for host-visible buffer");
 			std::memcpy(dst, src, std::min(size_, size));
-			vkUnmapMemory(device.logical(), memory_);
+			device.vk().UnmapMemory(device.logical(), allocation_.memory);
 			return;
 		}
 
@@ -93,6 +114,7 @@ namespace luster::gfx
 		ci.size = size;
 		ci.usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
 		ci.properties = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+		ci.category = MemoryCategory::Staging;
 		staging.create(device, ci);
 		void* mapped = staging.map(device);
 		std::memcpy(mapped, src, size);
@@ -104,7 +126,7 @@ namespace luster::gfx
 		{
 			VkBufferCopy region{};
 			region.size = size;
-			vkCmdCopyBuffer(cmd, staging.handle(), buffer_, 1, &region);
+			device.vk().CmdCopyBuffer(cmd, staging.handle(), buffer_, 1, &region);
 		});
 		staging.cleanup(device);
 	}
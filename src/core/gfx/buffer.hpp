@@ -1,16 +1,23 @@
 #pragma once
 
 #include "core/core.hpp"
+#include "core/gfx/memory_budget.hpp"
+#include "core/utils/handle_pool.hpp"
 
 namespace luster::gfx
 {
 	class Device;
+	class GpuAllocator;
+	struct GpuAllocation;
 
 	struct BufferCreateInfo
 	{
 		VkDeviceSize size = 0;
 		VkBufferUsageFlags usage = 0;
 		VkMemoryPropertyFlags properties = 0;
+		bool persistentMap = false; // host-visible only: mapped once at create, unmapped at cleanup
+		MemoryCategory category = MemoryCategory::Other; // MemoryBudget accounting
+		bool movable = false; // GpuAllocator, DEVICE_LOCAL only: the defragmenter may move it
 	};
 
 	class Buffer
@@ -20,21 +27,29 @@ namespace luster::gfx
 		~Buffer() = default;
 
 		void create(const Device& device, const BufferCreateInfo& info);
+		// Suballocated from `allocator`, which must outlive the buffer; host-visible ones are mapped for good
+		void create(GpuAllocator& allocator, const BufferCreateInfo& info);
 		void cleanup(const Device& device);
 
+		// Persistently mapped buffers return the cached pointer and ignore unmap()
 		void* map(const Device& device);
 		void unmap(const Device& device);
+		void* mapped() const { return mapped_; }
 
 		// Convenience: upload data via staging if memory is DEVICE_LOCAL, else direct map
 		void upload(const Device& device, const void* data, VkDeviceSize size);
 
-		VkBuffer handle() const { return buffer_; }
+		// Allocator-backed buffers may be moved by the defragmenter: resolve when recording, do not cache
+		VkBuffer handle() const;
 		VkDeviceSize size() const { return size_; }
 
 	private:
+		GpuAllocator* allocator_ = nullptr;
+		Handle<GpuAllocation> resource_{};
 		VkBuffer buffer_ = VK_NULL_HANDLE;
-		VkDeviceMemory memory_ = VK_NULL_HANDLE;
+		DeviceAllocation allocation_{};
 		VkDeviceSize size_ = 0;
 		bool hostVisible_ = false;
+		void* mapped_ = nullptr; // persistent mapping
 	};
 }
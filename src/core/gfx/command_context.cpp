@@ -2,6 +2,7 @@
 #include "core/gfx/device.hpp"
 #include "core/gfx/render_pass.hpp"
 #include "core/gfx/pipeline.hpp"
+#include <algorithm>
 #include <stdexcept>
 #include "core/utils/profiler.hpp"
 
@@ -16,69 +17,119 @@ namespace luster::gfx
 		}
 	}
 
-	void CommandContext::create(const Device& device, uint32_t queueFamilyIndex)
+	void CommandContext::create(const Device& device, uint32_t queueFamilyIndex, uint32_t framesInFlight)
 	{
 		device_ = device.logical();
+		vk_ = &device.vk();
 		VkCommandPoolCreateInfo pci{VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO};
 		pci.flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
 		pci.queueFamilyIndex = queueFamilyIndex;
-		VkResult r = vkCreateCommandPool(device.logical(), &pci, nullptr, &cmdPool_);
+		VkResult r = device.vk().CreateCommandPool(device.logical(), &pci, nullptr, &cmdPool_);
 		if (r != VK_SUCCESS) throw std::runtime_error(std::string("vkCreateCommandPool failed: ") + vk_err(r));
+		allocateFrames(device, framesInFlight);
+	}
 
+	void CommandContext::allocateFrames(const Device& device, uint32_t count)
+	{
+		frames_.resize(std::clamp(count, 1u, kMaxFramesInFlight));
+		std::vector<VkCommandBuffer> cmds(frames_.size());
 		VkCommandBufferAllocateInfo ai{VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO};
 		ai.commandPool = cmdPool_;
 		ai.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
-		ai.commandBufferCount = 1;
-		r = vkAllocateCommandBuffers(device.logical(), &ai, &cmdBuf_);
+		ai.commandBufferCount = static_cast<uint32_t>(cmds.size());
+		VkResult r = device.vk().AllocateCommandBuffers(device.logical(), &ai, cmds.data());
 		if (r != VK_SUCCESS) throw std::runtime_error(std::string("vkAllocateCommandBuffers failed: ") + vk_err(r));
+		for (size_t i = 0; i < frames_.size(); ++i) frames_[i].cmd = cmds[i];
+		slot_ = 0;
+		cmdBuf_ = frames_[0].cmd;
 	}
 
 	void CommandContext::createSync(const Device& device)
 	{
-		VkSemaphoreCreateInfo sci{VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO};
-		VkResult r = vkCreateSemaphore(device.logical(), &sci, nullptr, &semImageAvailable_);
-		if (r != VK_SUCCESS) throw std::runtime_error(std::string("vkCreateSemaphore failed: ") + vk_err(r));
-		r = vkCreateSemaphore(device.logical(), &sci, nullptr, &semRenderFinished_);
-		if (r != VK_SUCCESS) throw std::runtime_error(std::string("vkCreateSemaphore failed: ") + vk_err(r));
+		for (auto& f : frames_)
+		{
+			VkSemaphoreCreateInfo sci{VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO};
+			VkResult r = device.vk().CreateSemaphore(device.logical(), &sci, nullptr, &f.imageAvailable);
+			if (r != VK_SUCCESS) throw std::runtime_error(std::string("vkCreateSemaphore failed: ") + vk_err(r));
+			r = device.vk().CreateSemaphore(device.logical(), &sci, nullptr, &f.renderFinished);
+			if (r != VK_SUCCESS) throw std::runtime_error(std::string("vkCreateSemaphore failed: ") + vk_err(r));
+
+			VkFenceCreateInfo fci{VK_STRUCTURE_TYPE_FENCE_CREATE_INFO};
+			fci.flags = VK_FENCE_CREATE_SIGNALED_BIT;
+			r = device.vk().CreateFence(device.logical(), &fci, nullptr, &f.inFlight);
+			if (r != VK_SUCCESS) throw std::runtime_error(std::string("vkCreateFence failed: ") + vk_err(r));
+		}
+	}
 
-		VkFenceCreateInfo fci{VK_STRUCTURE_TYPE_FENCE_CREATE_INFO};
-		fci.flags = VK_FENCE_CREATE_SIGNALED_BIT;
-		r = vkCreateFence(device.logical(), &fci, nullptr, &inFlight_);
-		if (r != VK_SUCCESS) throw std::runtime_error(std::string("vkCreateFence failed: ") + vk_err(r));
+	void CommandContext::destroyFrames(const Device& device)
+	{
+		for (auto& f : frames_)
+		{
+			if (f.inFlight) device.vk().DestroyFence(device.logical(), f.inFlight, nullptr);
+			if (f.renderFinished) device.vk().DestroySemaphore(device.logical(), f.renderFinished, nullptr);
+			if (f.imageAvailable) device.vk().DestroySemaphore(device.logical(), f.imageAvailable, nullptr);
+			if (f.cmd) device.vk().FreeCommandBuffers(device.logical(), cmdPool_, 1, &f.cmd);
+		}
+		frames_.clear();
+		cmdBuf_ = VK_NULL_HANDLE;
+		slot_ = 0;
 	}
 
 	void CommandContext::cleanup(const Device& device)
 	{
-		if (inFlight_) vkDestroyFence(device.logical(), inFlight_, nullptr);
-		if (semRenderFinished_) vkDestroySemaphore(device.logical(), semRenderFinished_, nullptr);
-		if (semImageAvailable_) vkDestroySemaphore(device.logical(), semImageAvailable_, nullptr);
-		if (cmdBuf_) vkFreeCommandBuffers(device.logical(), cmdPool_, 1, &cmdBuf_);
-		if (cmdPool_) vkDestroyCommandPool(device.logical(), cmdPool_, nullptr);
+		destroyFrames(device);
+		if (cmdPool_) device.vk().DestroyCommandPool(device.logical(), cmdPool_, nullptr);
 		device_ = VK_NULL_HANDLE;
+		vk_ = nullptr;
 		cmdPool_ = VK_NULL_HANDLE;
-		cmdBuf_ = VK_NULL_HANDLE;
-		semImageAvailable_ = VK_NULL_HANDLE;
-		semRenderFinished_ = VK_NULL_HANDLE;
-		inFlight_ = VK_NULL_HANDLE;
+	}
+
+	void CommandContext::setFramesInFlight(const Device& device, uint32_t framesInFlight)
+	{
+		framesInFlight = std::clamp(framesInFlight, 1u, kMaxFramesInFlight);
+		if (framesInFlight == frames_.size()) return;
+		// Semaphores may still be pending on the presentation engine: the caller waits for device idle
+		waitAllFences(device);
+		destroyFrames(device);
+		allocateFrames(device, framesInFlight);
+		createSync(device);
+	}
+
+	void CommandContext::advanceFrame()
+	{
+		slot_ = (slot_ + 1) % static_cast<uint32_t>(frames_.size());
+		cmdBuf_ = frames_[slot_].cmd;
 	}
 
 	void CommandContext::waitFence(const Device& device, uint64_t timeoutNs) const
 	{
-		VkResult r = vkWaitForFences(device.logical(), 1, &inFlight_, VK_TRUE, timeoutNs);
+		VkResult r = device.vk().WaitForFences(device.logical(), 1, &frames_[slot_].inFlight, VK_TRUE, timeoutNs);
 		if (r != VK_SUCCESS) throw std::runtime_error(std::string("vkWaitForFences failed: ") + vk_err(r));
 	}
 
 	void CommandContext::resetFence(const Device& device) const
 	{
-		vkResetFences(device.logical(), 1, &inFlight_);
+		device.vk().ResetFences(device.logical(), 1, &frames_[slot_].inFlight);
+	}
+
+	void CommandContext::waitAllFences(const Device& device) const
+	{
+		std::vector<VkFence> fences;
+		for (const auto& f : frames_) if (f.inFlight) fences.push_back(f.inFlight);
+		if (fences.empty()) return;
+		VkResult r = device.vk().WaitForFences(device.logical(), static_cast<uint32_t>(fences.size()), fences.data(), VK_TRUE,
+		                             UINT64_MAX);
+		if (r != VK_SUCCESS) throw std::runtime_error(std::string("vkWaitForFences failed: ") + vk_err(r));
 	}
 
 	VkCommandBuffer CommandContext::begin()
 	{
 		PROFILE_SCOPE("cmd_begin");
-		vkResetCommandBuffer(cmdBuf_, 0);
+		vk_->ResetCommandBuffer(cmdBuf_, 0);
+		state_.reset(); // nothing is bound in a fresh command buffer
+		stats_ = {};
 		VkCommandBufferBeginInfo bi{VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO};
-		VkResult r = vkBeginCommandBuffer(cmdBuf_, &bi);
+		VkResult r = vk_->BeginCommandBuffer(cmdBuf_, &bi);
 		if (r != VK_SUCCESS) throw std::runtime_error(std::string("vkBeginCommandBuffer failed: ") + vk_err(r));
 		return cmdBuf_;
 	}
@@ -86,7 +137,7 @@ namespace luster::gfx
 	void CommandContext::end()
 	{
 		PROFILE_SCOPE("cmd_end");
-		VkResult r = vkEndCommandBuffer(cmdBuf_);
+		VkResult r = vk_->EndCommandBuffer(cmdBuf_);
 		if (r != VK_SUCCESS) throw std::runtime_error(std::string("vkEndCommandBuffer failed: ") + vk_err(r));
 	}
 
@@ -105,7 +156,7 @@ namespace luster::gfx
 		rpbi.renderArea.extent = extent;
 		rpbi.clearValueCount = 2;
 		rpbi.pClearValues = clears;
-		vkCmdBeginRenderPass(cmdBuf_, &rpbi, VK_SUBPASS_CONTENTS_INLINE);
+		vk_->CmdBeginRenderPass(cmdBuf_, &rpbi, VK_SUBPASS_CONTENTS_INLINE);
 		renderPassOpen_ = true;
 	}
 
@@ -117,86 +168,194 @@ namespace luster::gfx
 		beginRender(rp, framebuffer, extent, clear);
 	}
 
+	void CommandContext::beginRendering(VkImageView color, VkImageView depth, VkExtent2D extent,
+	                                    const VkClearValue& clear)
+	{
+		VkRenderingAttachmentInfo colorAtt{VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_INFO};
+		colorAtt.imageView = color;
+		colorAtt.imageLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+		colorAtt.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
+		colorAtt.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
+		colorAtt.clearValue = clear;
+
+		VkRenderingAttachmentInfo depthAtt{VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_INFO};
+		depthAtt.imageView = depth;
+		depthAtt.imageLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
+		depthAtt.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
+		depthAtt.storeOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+		depthAtt.clearValue.depthStencil = {1.0f, 0};
+
+		VkRenderingInfo ri{VK_STRUCTURE_TYPE_RENDERING_INFO};
+		ri.renderArea = {{0, 0}, extent};
+		ri.layerCount = 1;
+		ri.colorAttachmentCount = 1;
+		ri.pColorAttachments = &colorAtt;
+		ri.pDepthAttachment = depth ? &depthAtt : nullptr;
+		vk_->CmdBeginRendering(cmdBuf_, &ri);
+		renderingOpen_ = true;
+	}
+
 	void CommandContext::endRender()
 	{
 		if (renderPassOpen_)
 		{
-			vkCmdEndRenderPass(cmdBuf_);
+			vk_->CmdEndRenderPass(cmdBuf_);
 			renderPassOpen_ = false;
 		}
+		if (renderingOpen_)
+		{
+			vk_->CmdEndRendering(cmdBuf_);
+			renderingOpen_ = false;
+		}
+	}
+
+	void CommandContext::imageBarrier(VkImage image, VkImageAspectFlags aspect, VkImageLayout oldLayout,
+	                                  VkImageLayout newLayout, VkPipelineStageFlags2 srcStage,
+	                                  VkAccessFlags2 srcAccess, VkPipelineStageFlags2 dstStage,
+	                                  VkAccessFlags2 dstAccess)
+	{
+		VkImageMemoryBarrier2 b{VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER_2};
+		b.srcStageMask = srcStage;
+		b.srcAccessMask = srcAccess;
+		b.dstStageMask = dstStage;
+		b.dstAccessMask = dstAccess;
+		b.oldLayout = oldLayout;
+		b.newLayout = newLayout;
+		b.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+		b.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+		b.image = image;
+		b.subresourceRange = {aspect, 0, 1, 0, 1};
+		VkDependencyInfo dep{VK_STRUCTURE_TYPE_DEPENDENCY_INFO};
+		dep.imageMemoryBarrierCount = 1;
+		dep.pImageMemoryBarriers = &b;
+		vk_->CmdPipelineBarrier2(cmdBuf_, &dep);
 	}
 
 	void CommandContext::beginLabel(const char* name, float r, float g, float b, float a)
 	{
-		if (!device_) return;
-		auto pfn = reinterpret_cast<PFN_vkCmdBeginDebugUtilsLabelEXT>(vkGetDeviceProcAddr(
-			device_, "vkCmdBeginDebugUtilsLabelEXT"));
-		if (!pfn) return;
+		if (!vk_ || !vk_->CmdBeginDebugUtilsLabelEXT) return;
 		VkDebugUtilsLabelEXT label{VK_STRUCTURE_TYPE_DEBUG_UTILS_LABEL_EXT};
 		label.pLabelName = name;
 		label.color[0] = r;
 		label.color[1] = g;
 		label.color[2] = b;
 		label.color[3] = a;
-		pfn(cmdBuf_, &label);
+		vk_->CmdBeginDebugUtilsLabelEXT(cmdBuf_, &label);
 	}
 
 	void CommandContext::endLabel()
 	{
-		if (!device_) return;
-		auto pfn = reinterpret_cast<PFN_vkCmdEndDebugUtilsLabelEXT>(vkGetDeviceProcAddr(
-			device_, "vkCmdEndDebugUtilsLabelEXT"));
-		if (!pfn) return;
-		pfn(cmdBuf_);
+		if (!vk_ || !vk_->CmdEndDebugUtilsLabelEXT) return;
+		vk_->CmdEndDebugUtilsLabelEXT(cmdBuf_);
+	}
+
+	// Cache update always runs so that turning filtering back on starts from the true state
+	static bool shouldIssue(bool changed, bool filter, CommandCounter& counter)
+	{
+		if (changed || !filter)
+		{
+			++counter.issued;
+			return true;
+		}
+		++counter.skipped;
+		return false;
 	}
 
 	void CommandContext::bindPipeline(const Pipeline& pipeline)
 	{
-		vkCmdBindPipeline(cmdBuf_, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline.handle());
+		if (!shouldIssue(state_.setPipeline(pipeline.handle(), pipeline.dynamicViewport()), filterState_, stats_.pipelines)) return;
+		vk_->CmdBindPipeline(cmdBuf_, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline.handle());
 	}
 
 	void CommandContext::bindVertexBuffers(uint32_t firstBinding, const VkBuffer* buffers, const VkDeviceSize* offsets,
 	                                       uint32_t count)
 	{
-		vkCmdBindVertexBuffers(cmdBuf_, firstBinding, count, buffers, offsets);
+		const bool changed = state_.setVertexBuffers(firstBinding, buffers, offsets, count);
+		if (!shouldIssue(changed, filterState_, stats_.vertexBuffers)) return;
+		vk_->CmdBindVertexBuffers(cmdBuf_, firstBinding, count, buffers, offsets);
 	}
 
 	void CommandContext::bindDescriptorSets(VkPipelineLayout layout, uint32_t firstSet, const VkDescriptorSet* sets,
-	                                        uint32_t count)
+	                                        uint32_t count, const uint32_t* dynamicOffsets,
+	                                        uint32_t dynamicOffsetCount)
+	{
+		const bool changed = state_.setDescriptorSets(layout, firstSet, sets, count, dynamicOffsets,
+		                                              dynamicOffsetCount);
+		if (!shouldIssue(changed, filterState_, stats_.descriptorSets)) return;
+		vk_->CmdBindDescriptorSets(cmdBuf_, VK_PIPELINE_BIND_POINT_GRAPHICS, layout, firstSet, count, sets,
+		                        dynamicOffsetCount, dynamicOffsets);
+	}
+
+	void CommandContext::pushConstants(VkPipelineLayout layout, VkShaderStageFlags stages, uint32_t offset,
+	                                   uint32_t size, const void* data)
 	{
-		vkCmdBindDescriptorSets(cmdBuf_, VK_PIPELINE_BIND_POINT_GRAPHICS, layout, firstSet, count, sets, 0, nullptr);
+		const bool changed = state_.setPushConstants(layout, stages, offset, size, data);
+		if (!shouldIssue(changed, filterState_, stats_.pushConstants)) return;
+		vk_->CmdPushConstants(cmdBuf_, layout, stages, offset, size, data);
+	}
+
+	void CommandContext::setViewportScissor(VkExtent2D extent)
+	{
+		if (!shouldIssue(state_.setViewportScissor(extent), filterState_, stats_.dynamicState)) return;
+		VkViewport vp{};
+		vp.width = static_cast<float>(extent.width);
+		vp.height = static_cast<float>(extent.height);
+		vp.minDepth = 0.f;
+		vp.maxDepth = 1.f;
+		vk_->CmdSetViewport(cmdBuf_, 0, 1, &vp);
+		const VkRect2D sc{{0, 0}, extent};
+		vk_->CmdSetScissor(cmdBuf_, 0, 1, &sc);
 	}
 
 	void CommandContext::bindIndexBuffer(VkBuffer buffer, VkDeviceSize offset, VkIndexType indexType)
 	{
-		vkCmdBindIndexBuffer(cmdBuf_, buffer, offset, indexType);
+		if (!shouldIssue(state_.setIndexBuffer(buffer, offset, indexType), filterState_, stats_.indexBuffers)) return;
+		vk_->CmdBindIndexBuffer(cmdBuf_, buffer, offset, indexType);
 	}
 
 	void CommandContext::draw(uint32_t vertexCount, uint32_t instanceCount, uint32_t firstVertex,
 	                          uint32_t firstInstance)
 	{
-		vkCmdDraw(cmdBuf_, vertexCount, instanceCount, firstVertex, firstInstance);
+		++stats_.draws;
+		vk_->CmdDraw(cmdBuf_, vertexCount, instanceCount, firstVertex, firstInstance);
 	}
 
 	void CommandContext::drawIndexed(uint32_t indexCount, uint32_t instanceCount, uint32_t firstIndex,
 	                                 int32_t vertexOffset, uint32_t firstInstance)
 	{
-		vkCmdDrawIndexed(cmdBuf_, indexCount, instanceCount, firstIndex, vertexOffset, firstInstance);
+		++stats_.draws;
+		vk_->CmdDrawIndexed(cmdBuf_, indexCount, instanceCount, firstIndex, vertexOffset, firstInstance);
+	}
+
+	void CommandContext::addWait(VkSemaphore semaphore, VkPipelineStageFlags stage, uint64_t timelineValue)
+	{
+		waitSemaphores_.push_back(semaphore);
+		waitStages_.push_back(stage);
+		waitValues_.push_back(timelineValue);
 	}
 
 	void CommandContext::submit(VkQueue gfxQueue, VkSemaphore waitSemaphore, VkSemaphore signalSemaphore,
-	                            VkFence fence) const
+	                            VkFence fence)
 	{
-		VkPipelineStageFlags waitStages = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+		if (waitSemaphore) addWait(waitSemaphore, VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT);
+		const bool timeline = std::ranges::any_of(waitValues_, [](uint64_t v) { return v != 0; });
+		// Values of binary semaphores in the array are ignored
+		VkTimelineSemaphoreSubmitInfo tsi{VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO};
+		tsi.waitSemaphoreValueCount = static_cast<uint32_t>(waitValues_.size());
+		tsi.pWaitSemaphoreValues = waitValues_.data();
 		VkSubmitInfo si{VK_STRUCTURE_TYPE_SUBMIT_INFO};
-		si.waitSemaphoreCount = waitSemaphore ? 1u : 0u;
-		si.pWaitSemaphores = waitSemaphore ? &waitSemaphore : nullptr;
-		si.pWaitDstStageMask = waitSemaphore ? &waitStages : nullptr;
+		si.pNext = timeline ? &tsi : nullptr;
+		si.waitSemaphoreCount = static_cast<uint32_t>(waitSemaphores_.size());
+		si.pWaitSemaphores = waitSemaphores_.empty() ? nullptr : waitSemaphores_.data();
+		si.pWaitDstStageMask = waitStages_.empty() ? nullptr : waitStages_.data();
 		si.commandBufferCount = 1;
 		si.pCommandBuffers = &cmdBuf_;
 		si.signalSemaphoreCount = signalSemaphore ? 1u : 0u;
 		si.pSignalSemaphores = signalSemaphore ? &signalSemaphore : nullptr;
-		VkResult r = vkQueueSubmit(gfxQueue, 1, &si, fence);
+		VkResult r = vk_->QueueSubmit(gfxQueue, 1, &si, fence);
+		waitSemaphores_.clear();
+		waitStages_.clear();
+		waitValues_.clear();
 		if (r != VK_SUCCESS) throw std::runtime_error(std::string("vkQueueSubmit failed: ") + vk_err(r));
 	}
 }
@@ -1,26 +1,44 @@
 #pragma once
 
 #include "core/core.hpp"
+#include "core/gfx/bind_state_cache.hpp"
+#include <type_traits>
+#include <vector>
 
 namespace luster::gfx
 {
 	class Device;
+	struct DeviceDispatch;
 	class RenderPass;
 	class Pipeline;
 	class GpuProfiler;
 
+	// Command recording plus per-frame sync. With N frames in flight each frame slot owns a command
+	// buffer, acquire/render semaphores and a fence; recording frame k waits only for frame k - N.
 	class CommandContext
 	{
 	public:
+		// Bounded by GpuProfiler::kFrameLatency: its query ring slot is reused every third frame
+		static constexpr uint32_t kMaxFramesInFlight = 3;
+
 		CommandContext() = default;
 		~CommandContext() = default;
 
-		void create(const Device& device, uint32_t queueFamilyIndex);
+		void create(const Device& device, uint32_t queueFamilyIndex, uint32_t framesInFlight = 1);
 		void createSync(const Device& device);
 		void cleanup(const Device& device);
+		// Rebuilds the per-frame objects; call with the device idle
+		void setFramesInFlight(const Device& device, uint32_t framesInFlight);
+
+		uint32_t framesInFlight() const { return static_cast<uint32_t>(frames_.size()); }
+		uint32_t frameSlot() const { return slot_; }
+		// Moves to the next frame slot; call once per submitted frame
+		void advanceFrame();
 
+		// Current slot's fence (signaled once the frame that last used this slot completed)
 		void waitFence(const Device& device, uint64_t timeoutNs = UINT64_C(1'000'000'000)) const;
 		void resetFence(const Device& device) const;
+		void waitAllFences(const Device& device) const;
 
 		VkCommandBuffer begin();
 		void end();
@@ -29,41 +47,92 @@ namespace luster::gfx
 		void beginRender(const RenderPass& rp, VkFramebuffer framebuffer, VkExtent2D extent, const VkClearValue& clear);
 		void beginRender(const RenderPass& rp, VkFramebuffer framebuffer, VkExtent2D extent,
 		                 float r, float g, float b, float a);
+		// Dynamic rendering (Vulkan 1.3): no render pass/framebuffer objects. Attachments must already be in
+		// COLOR_ATTACHMENT_OPTIMAL / DEPTH_STENCIL_ATTACHMENT_OPTIMAL; color is cleared, depth cleared to 1 and discarded.
+		void beginRendering(VkImageView color, VkImageView depth, VkExtent2D extent, const VkClearValue& clear);
+		// Ends either kind of render pass
 		void endRender();
+		// synchronization2 layout transition of a whole single-mip, single-layer image
+		void imageBarrier(VkImage image, VkImageAspectFlags aspect, VkImageLayout oldLayout, VkImageLayout newLayout,
+		                  VkPipelineStageFlags2 srcStage, VkAccessFlags2 srcAccess,
+		                  VkPipelineStageFlags2 dstStage, VkAccessFlags2 dstAccess);
 		// Debug label helpers (no-op if extension not present)
 		void beginLabel(const char* name, float r = 0.2f, float g = 0.6f, float b = 0.9f, float a = 1.0f);
 		void endLabel();
+		// Binds and dynamic state below skip calls that would rebind what is already bound in this command
+		// buffer (see stats()). Call invalidateState() after recording such commands directly with vkCmd*.
 		void bindPipeline(const Pipeline& pipeline);
 		void bindVertexBuffers(uint32_t firstBinding, const VkBuffer* buffers, const VkDeviceSize* offsets,
 		                       uint32_t count);
 		void bindDescriptorSets(VkPipelineLayout layout, uint32_t firstSet, const VkDescriptorSet* sets,
-		                        uint32_t count);
+		                        uint32_t count, const uint32_t* dynamicOffsets = nullptr,
+		                        uint32_t dynamicOffsetCount = 0);
+		// Full-extent viewport (depth 0..1) and scissor, for pipelines with dynamic viewport state
+		void setViewportScissor(VkExtent2D extent);
 		void bindIndexBuffer(VkBuffer buffer, VkDeviceSize offset, VkIndexType indexType);
+		void pushConstants(VkPipelineLayout layout, VkShaderStageFlags stages, uint32_t offset, uint32_t size,
+		                   const void* data);
+		// Typed form: pushes all of `data` at `offset` (must lie in a range declared in the pipeline layout)
+		template <typename T>
+		void pushConstants(VkPipelineLayout layout, VkShaderStageFlags stages, const T& data, uint32_t offset = 0)
+		{
+			static_assert(std::is_trivially_copyable_v<T>, "push constants are copied bytewise");
+			static_assert(sizeof(T) % 4 == 0, "push constant sizes must be a multiple of 4");
+			pushConstants(layout, stages, offset, static_cast<uint32_t>(sizeof(T)), &data);
+		}
+		void invalidateState() { state_.reset(); }
+		// false: forward every call (A/B comparisons); counters still run
+		void setStateFiltering(bool enabled) { filterState_ = enabled; }
+		// Counters of the command buffer recorded last (reset by begin())
+		const CommandStats& stats() const { return stats_; }
 		void draw(uint32_t vertexCount, uint32_t instanceCount = 1, uint32_t firstVertex = 0,
 		          uint32_t firstInstance = 0);
 		void drawIndexed(uint32_t indexCount, uint32_t instanceCount = 1, uint32_t firstIndex = 0,
 		                 int32_t vertexOffset = 0, uint32_t firstInstance = 0);
 
 		// Submit current command buffer with common triangle pipeline usage
-		void submit(VkQueue gfxQueue, VkSemaphore waitSemaphore, VkSemaphore signalSemaphore, VkFence fence) const;
+		void submit(VkQueue gfxQueue, VkSemaphore waitSemaphore, VkSemaphore signalSemaphore, VkFence fence);
+		// Extra wait of the next submit() only, e.g. on AsyncCompute work. timelineValue != 0 marks a timeline
+		// semaphore wait (requires DeviceCapabilities::timelineSemaphore).
+		void addWait(VkSemaphore semaphore, VkPipelineStageFlags stage, uint64_t timelineValue = 0);
 
 		// Accessors
 		VkCommandPool commandPool() const { return cmdPool_; }
 		VkCommandBuffer commandBuffer() const { return cmdBuf_; }
-		VkSemaphore imageAvailable() const { return semImageAvailable_; }
-		VkSemaphore renderFinished() const { return semRenderFinished_; }
-		VkFence inFlight() const { return inFlight_; }
+		VkSemaphore imageAvailable() const { return frames_[slot_].imageAvailable; }
+		VkSemaphore renderFinished() const { return frames_[slot_].renderFinished; }
+		VkFence inFlight() const { return frames_[slot_].inFlight; }
 
 	private:
 		friend class GpuProfiler;
+
+		struct FrameSync
+		{
+			VkCommandBuffer cmd = VK_NULL_HANDLE;
+			VkSemaphore imageAvailable = VK_NULL_HANDLE;
+			VkSemaphore renderFinished = VK_NULL_HANDLE;
+			VkFence inFlight = VK_NULL_HANDLE;
+		};
+
+		void allocateFrames(const Device& device, uint32_t count);
+		void destroyFrames(const Device& device);
+
 		VkCommandPool cmdPool_ = VK_NULL_HANDLE;
-		VkCommandBuffer cmdBuf_ = VK_NULL_HANDLE;
-		VkSemaphore semImageAvailable_ = VK_NULL_HANDLE;
-		VkSemaphore semRenderFinished_ = VK_NULL_HANDLE;
-		VkFence inFlight_ = VK_NULL_HANDLE;
+		VkCommandBuffer cmdBuf_ = VK_NULL_HANDLE; // current slot's command buffer
+		std::vector<FrameSync> frames_{};
+		uint32_t slot_ = 0;
 		VkDevice device_ = VK_NULL_HANDLE;
+		const DeviceDispatch* vk_ = nullptr; // owned by the Device passed to create()
 
 		// cached for beginRender/endRender
 		bool renderPassOpen_ = false;
+		bool renderingOpen_ = false;
+		BindStateCache state_{};
+		CommandStats stats_{};
+		bool filterState_ = true;
+		// addWait() entries, consumed by submit(); capacity is kept across frames
+		std::vector<VkSemaphore> waitSemaphores_{};
+		std::vector<VkPipelineStageFlags> waitStages_{};
+		std::vector<uint64_t> waitValues_{};
 	};
 }
@@ -9,13 +9,13 @@ namespace luster::gfx
 		VkDescriptorSetLayoutCreateInfo ci{VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO};
 		ci.bindingCount = count;
 		ci.pBindings = bindings;
-		VkResult r = vkCreateDescriptorSetLayout(device.logical(), &ci, nullptr, &layout_);
+		VkResult r = device.vk().CreateDescriptorSetLayout(device.logical(), &ci, nullptr, &layout_);
 		if (r != VK_SUCCESS) throw std::runtime_error("vkCreateDescriptorSetLayout failed");
 	}
 
 	void DescriptorSetLayout::cleanup(const Device& device)
 	{
-		if (layout_) vkDestroyDescriptorSetLayout(device.logical(), layout_, nullptr);
+		if (layout_) device.vk().DestroyDescriptorSetLayout(device.logical(), layout_, nullptr);
 		layout_ = VK_NULL_HANDLE;
 	}
 
@@ -26,13 +26,13 @@ namespace luster::gfx
 		ci.poolSizeCount = sizeCount;
 		ci.pPoolSizes = sizes;
 		ci.maxSets = maxSets;
-		VkResult r = vkCreateDescriptorPool(device.logical(), &ci, nullptr, &pool_);
+		VkResult r = device.vk().CreateDescriptorPool(device.logical(), &ci, nullptr, &pool_);
 		if (r != VK_SUCCESS) throw std::runtime_error("vkCreateDescriptorPool failed");
 	}
 
 	void DescriptorPool::cleanup(const Device& device)
 	{
-		if (pool_) vkDestroyDescriptorPool(device.logical(), pool_, nullptr);
+		if (pool_) device.vk().DestroyDescriptorPool(device.logical(), pool_, nullptr);
 		pool_ = VK_NULL_HANDLE;
 	}
 
@@ -43,11 +43,12 @@ namespace luster::gfx
 		ai.descriptorPool = pool.handle();
 		ai.descriptorSetCount = 1;
 		ai.pSetLayouts = &l;
-		VkResult r = vkAllocateDescriptorSets(device.logical(), &ai, &set_);
+		VkResult r = device.vk().AllocateDescriptorSets(device.logical(), &ai, &set_);
 		if (r != VK_SUCCESS) throw std::runtime_error("vkAllocateDescriptorSets failed");
 	}
 
-	void DescriptorSet::updateUniformBuffer(const Device& device, uint32_t binding, VkBuffer buffer, VkDeviceSize range)
+	void DescriptorSet::updateUniformBuffer(const Device& device, uint32_t binding, VkBuffer buffer, VkDeviceSize range,
+	                                        VkDescriptorType type)
 	{
 		VkDescriptorBufferInfo dbi{};
 		dbi.buffer = buffer;
@@ -56,9 +57,9 @@ namespace luster::gfx
 		VkWriteDescriptorSet write{VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET};
 		write.dstSet = set_;
 		write.dstBinding = binding;
-		write.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+		write.descriptorType = type;
 		write.descriptorCount = 1;
 		write.pBufferInfo = &dbi;
-		vkUpdateDescriptorSets(device.logical(), 1, &write, 0, nullptr);
+		device.vk().UpdateDescriptorSets(device.logical(), 1, &write, 0, nullptr);
 	}
 }
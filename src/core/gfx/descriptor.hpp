@@ -35,7 +35,9 @@ namespace luster::gfx
 	{
 	public:
 		void allocate(const Device& device, const DescriptorPool& pool, const DescriptorSetLayout& layout);
-		void updateUniformBuffer(const Device& device, uint32_t binding, VkBuffer buffer, VkDeviceSize range);
+		// type: UNIFORM_BUFFER or UNIFORM_BUFFER_DYNAMIC (range is then the size visible per dynamic offset)
+		void updateUniformBuffer(const Device& device, uint32_t binding, VkBuffer buffer, VkDeviceSize range,
+		                         VkDescriptorType type = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER);
 		VkDescriptorSet handle() const { return set_; }
 
 	private:
@@ -1,4 +1,5 @@
 #include "core/gfx/device.hpp"
+#include "core/gfx/device_selection.hpp"
 #include <vector>
 #include <optional>
 #include <cstring>
@@ -120,17 +121,24 @@ namespace luster::gfx
 
 	void Device::init(::luster::Window& window, const InitParams& params)
 	{
-		createInstance(window, params);
-		pickDevice();
+		createInstance(&window, params);
+		pickDevice(params);
+		createDevice(params);
+	}
+
+	void Device::initHeadless(const InitParams& params)
+	{
+		createInstance(nullptr, params);
+		pickDevice(params);
 		createDevice(params);
 	}
 
 	void Device::cleanup()
 	{
 		if (!instance_) return;
-		if (device_) vkDeviceWaitIdle(device_);
+		if (device_) vk_.DeviceWaitIdle(device_);
 
-		if (device_) vkDestroyDevice(device_, nullptr);
+		if (device_) vk_.DestroyDevice(device_, nullptr);
 		if (surface_) vkDestroySurfaceKHR(instance_, surface_, nullptr);
 		destroyDebugMessenger();
 		if (instance_) vkDestroyInstance(instance_, nullptr);
@@ -139,26 +147,36 @@ namespace luster::gfx
 		surface_ = VK_NULL_HANDLE;
 		gpu_ = VK_NULL_HANDLE;
 		device_ = VK_NULL_HANDLE;
+		vk_ = {};
 		gfxQueue_ = VK_NULL_HANDLE;
 		presentQueue_ = VK_NULL_HANDLE;
+		computeQueue_ = VK_NULL_HANDLE;
+		transferQueue_ = VK_NULL_HANDLE;
 		gfxQueueFamily_ = 0;
 		presentQueueFamily_ = 0;
+		deviceName_.clear();
+		caps_ = {};
+		memoryProperties_ = {};
 	}
 
 	void Device::waitIdle() const
 	{
-		if (device_) vkDeviceWaitIdle(device_);
+		if (device_) vk_.DeviceWaitIdle(device_);
 	}
 
-	void Device::createInstance(::luster::Window& window, const InitParams& params)
+	void Device::createInstance(::luster::Window* window, const InitParams& params)
 	{
-		Uint32 extCount = 0;
-		const char* const* sdlExts = SDL_Vulkan_GetInstanceExtensions(&extCount);
-		if (!sdlExts || extCount == 0)
+		std::vector<const char*> extensions;
+		if (window)
 		{
-			throw std::runtime_error("SDL_Vulkan_GetInstanceExtensions returned empty");
+			Uint32 extCount = 0;
+			const char* const* sdlExts = SDL_Vulkan_GetInstanceExtensions(&extCount);
+			if (!sdlExts || extCount == 0)
+			{
+				throw std::runtime_error("SDL_Vulkan_GetInstanceExtensions returned empty");
+			}
+			extensions.assign(sdlExts, sdlExts + extCount);
 		}
-		std::vector<const char*> extensions(sdlExts, sdlExts + extCount);
 		// layers
 		std::vector<const char*> layers;
 		if (params.enableValidation && hasInstanceLayer("VK_LAYER_KHRONOS_validation"))
@@ -212,7 +230,9 @@ namespace luster::gfx
 			}
 		}
 
-		if (!SDL_Vulkan_CreateSurface(window.sdl(), instance_, nullptr, &surface_) || surface_ == VK_NULL_HANDLE)
+		// Headless: no surface; pickDevice/createDevice skip present + swapchain requirements
+		if (!window) return;
+		if (!SDL_Vulkan_CreateSurface(window->sdl(), instance_, nullptr, &surface_) || surface_ == VK_NULL_HANDLE)
 		{
 			throw std::runtime_error("SDL_Vulkan_CreateSurface failed");
 		}
@@ -222,6 +242,8 @@ namespace luster::gfx
 	{
 		std::optional<uint32_t> graphics;
 		std::optional<uint32_t> present;
+		std::optional<uint32_t> compute; // compute without graphics
+		std::optional<uint32_t> transfer; // transfer without graphics and compute
 	};
 
 	static QueueFamilies findQueueFamilies(VkPhysicalDevice gpu, VkSurfaceKHR surface)
@@ -233,53 +255,128 @@ namespace luster::gfx
 		vkGetPhysicalDeviceQueueFamilyProperties(gpu, &count, props.data());
 		for (uint32_t i = 0; i < count; ++i)
 		{
-			if (!out.graphics && (props[i].queueFlags & VK_QUEUE_GRAPHICS_BIT)) out.graphics = i;
-			if (!out.present)
+			const VkQueueFlags flags = props[i].queueFlags;
+			if (!out.graphics && (flags & VK_QUEUE_GRAPHICS_BIT)) out.graphics = i;
+			if (!out.compute && (flags & VK_QUEUE_COMPUTE_BIT) && !(flags & VK_QUEUE_GRAPHICS_BIT)) out.compute = i;
+			if (!out.transfer && (flags & VK_QUEUE_TRANSFER_BIT) &&
+				!(flags & (VK_QUEUE_GRAPHICS_BIT | VK_QUEUE_COMPUTE_BIT)))
+				out.transfer = i;
+			if (surface != VK_NULL_HANDLE && !out.present)
 			{
 				VkBool32 presentSupport = VK_FALSE;
 				vkGetPhysicalDeviceSurfaceSupportKHR(gpu, i, surface, &presentSupport);
 				if (presentSupport) out.present = i;
 			}
-			if (out.graphics && out.present) break;
 		}
+		// Headless: present is served by the graphics family
+		if (surface == VK_NULL_HANDLE) out.present = out.graphics;
 		return out;
 	}
 
-	void Device::pickDevice()
+	static bool hasDeviceExtension(VkPhysicalDevice gpu, const char* name)
+	{
+		uint32_t count = 0;
+		vkEnumerateDeviceExtensionProperties(gpu, nullptr, &count, nullptr);
+		std::vector<VkExtensionProperties> exts(count);
+		vkEnumerateDeviceExtensionProperties(gpu, nullptr, &count, exts.data());
+		for (const auto& e : exts)
+			if (std::strcmp(e.extensionName, name) == 0) return true;
+		return false;
+	}
+
+	static VkDeviceSize largestDeviceLocalHeap(VkPhysicalDevice gpu)
+	{
+		VkPhysicalDeviceMemoryProperties mem{};
+		vkGetPhysicalDeviceMemoryProperties(gpu, &mem);
+		VkDeviceSize largest = 0;
+		for (uint32_t i = 0; i < mem.memoryHeapCount; ++i)
+			if (mem.memoryHeaps[i].flags & VK_MEMORY_HEAP_DEVICE_LOCAL_BIT)
+				largest = std::max(largest, mem.memoryHeaps[i].size);
+		return largest;
+	}
+
+	// The subset the bindless paths need: sampled-image arrays indexed non-uniformly, partially bound,
+	// variably sized and updatable after bind
+	static bool supportsDescriptorIndexing(const VkPhysicalDeviceVulkan12Features& f)
+	{
+		return f.descriptorIndexing && f.runtimeDescriptorArray && f.descriptorBindingPartiallyBound &&
+			f.descriptorBindingVariableDescriptorCount && f.shaderSampledImageArrayNonUniformIndexing &&
+			f.descriptorBindingSampledImageUpdateAfterBind;
+	}
+
+	static DeviceCandidate describeDevice(VkPhysicalDevice gpu, VkSurfaceKHR surface)
+	{
+		DeviceCandidate c{};
+		VkPhysicalDeviceProperties props{};
+		vkGetPhysicalDeviceProperties(gpu, &props);
+		c.name = props.deviceName;
+		c.type = props.deviceType;
+		c.apiVersion = props.apiVersion;
+		c.deviceLocalBytes = largestDeviceLocalHeap(gpu);
+
+		const QueueFamilies q = findQueueFamilies(gpu, surface);
+		// Swapchain not required headless
+		const bool hasSwapchain = !surface || hasDeviceExtension(gpu, VK_KHR_SWAPCHAIN_EXTENSION_NAME);
+		c.suitable = q.graphics && q.present && hasSwapchain;
+		c.asyncCompute = q.compute.has_value();
+		c.dedicatedTransfer = q.transfer.has_value();
+
+		// Feature structs may only be chained on devices of that version
+		if (props.apiVersion < VK_API_VERSION_1_2) return c;
+		VkPhysicalDeviceVulkan12Features v12{VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES};
+		VkPhysicalDeviceVulkan13Features v13{VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_3_FEATURES};
+		VkPhysicalDeviceFeatures2 feats{VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2};
+		const bool is13 = props.apiVersion >= VK_API_VERSION_1_3;
+		v13.pNext = &v12;
+		feats.pNext = is13 ? static_cast<void*>(&v13) : static_cast<void*>(&v12);
+		vkGetPhysicalDeviceFeatures2(gpu, &feats);
+		c.timelineSemaphore = v12.timelineSemaphore;
+		c.descriptorIndexing = supportsDescriptorIndexing(v12);
+		c.drawIndirectCount = v12.drawIndirectCount;
+		c.dynamicRendering = is13 && v13.dynamicRendering && v13.synchronization2;
+		return c;
+	}
+
+	void Device::pickDevice(const InitParams& params)
 	{
 		uint32_t count = 0;
 		vkEnumeratePhysicalDevices(instance_, &count, nullptr);
 		if (!count) throw std::runtime_error("No Vulkan physical devices");
 		std::vector<VkPhysicalDevice> gpus(count);
 		vkEnumeratePhysicalDevices(instance_, &count, gpus.data());
-		for (const auto d : gpus)
+
+		std::vector<DeviceCandidate> candidates;
+		candidates.reserve(count);
+		for (uint32_t i = 0; i < count; ++i)
 		{
-			QueueFamilies q = findQueueFamilies(d, surface_);
-			uint32_t extCount = 0;
-			vkEnumerateDeviceExtensionProperties(d, nullptr, &extCount, nullptr);
-			std::vector<VkExtensionProperties> devExts(extCount);
-			vkEnumerateDeviceExtensionProperties(d, nullptr, &extCount, devExts.data());
-			bool hasSwapchain = false;
-			for (auto& e : devExts)
-				if (std::strcmp(e.extensionName, VK_KHR_SWAPCHAIN_EXTENSION_NAME) == 0)
-					hasSwapchain
-						= true;
-			if (q.graphics && q.present && hasSwapchain)
-			{
-				gpu_ = d;
-				gfxQueueFamily_ = q.graphics.value();
-				presentQueueFamily_ = q.present.value();
-				return;
-			}
+			candidates.push_back(describeDevice(gpus[i], surface_));
+			const DeviceCandidate& c = candidates.back();
+			spdlog::info("GPU {}: {} ({}, {} MiB, Vulkan {}.{}) score {}{}", i, c.name, deviceTypeName(c.type),
+			             c.deviceLocalBytes >> 20, VK_API_VERSION_MAJOR(c.apiVersion),
+			             VK_API_VERSION_MINOR(c.apiVersion), scoreDevice(c), c.suitable ? "" : " (unsuitable)");
 		}
-		throw std::runtime_error("Failed to find suitable GPU");
+
+		const int chosen = selectDevice(candidates, params.preferredDeviceName, params.preferredDeviceIndex);
+		if (chosen < 0) throw std::runtime_error("Failed to find suitable GPU");
+		gpu_ = gpus[chosen];
+		const QueueFamilies q = findQueueFamilies(gpu_, surface_);
+		gfxQueueFamily_ = q.graphics.value();
+		presentQueueFamily_ = q.present.value();
+		caps_.computeQueueFamily = q.compute.value_or(DeviceCapabilities::kNoQueueFamily);
+		caps_.transferQueueFamily = q.transfer.value_or(DeviceCapabilities::kNoQueueFamily);
+		spdlog::info("Selected GPU {}: {}", chosen, candidates[chosen].name);
 	}
 
 	void Device::createDevice(const InitParams& params)
 	{
 		float prio = 1.0f;
 		std::vector<VkDeviceQueueCreateInfo> qcis;
-		std::array<uint32_t, 2> unique = {gfxQueueFamily_, presentQueueFamily_};
+		// Dedicated families never hold graphics, so they cannot collide with the graphics family
+		const bool computeQueue = params.enableAsyncQueues && caps_.asyncCompute();
+		const bool transferQueue = params.enableAsyncQueues && caps_.dedicatedTransfer();
+		std::vector<uint32_t> unique = {gfxQueueFamily_, presentQueueFamily_};
+		if (computeQueue) unique.push_back(caps_.computeQueueFamily);
+		if (transferQueue) unique.push_back(caps_.transferQueueFamily);
 		std::ranges::sort(unique);
 		auto last = std::ranges::unique(unique).begin();
 		for (auto it = unique.begin(); it != last; ++it)
@@ -292,28 +389,167 @@ namespace luster::gfx
 			qcis.push_back(qci);
 		}
 
-		VkPhysicalDeviceFeatures feats{};
-		std::vector<const char*> extensions = {VK_KHR_SWAPCHAIN_EXTENSION_NAME};
+		std::vector<const char*> extensions;
+		if (surface_) extensions.push_back(VK_KHR_SWAPCHAIN_EXTENSION_NAME);
 		for (auto* e : params.extraDeviceExtensions) extensions.push_back(e);
 
+		// Query optional features, then enable only what was asked for and is supported
+		VkPhysicalDevicePerformanceQueryFeaturesKHR perfSupported{VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PERFORMANCE_QUERY_FEATURES_KHR};
+		VkPhysicalDeviceVulkan12Features v12Supported{VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES};
+		VkPhysicalDeviceVulkan13Features v13Supported{VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_3_FEATURES};
+		VkPhysicalDeviceFeatures2 supported{VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2};
+		const bool hasPerfExt = hasDeviceExtension(gpu_, VK_KHR_PERFORMANCE_QUERY_EXTENSION_NAME);
+		caps_.memoryBudget = hasDeviceExtension(gpu_, VK_EXT_MEMORY_BUDGET_EXTENSION_NAME);
+		if (caps_.memoryBudget) extensions.push_back(VK_EXT_MEMORY_BUDGET_EXTENSION_NAME);
+		VkPhysicalDeviceProperties gpuProps{};
+		vkGetPhysicalDeviceProperties(gpu_, &gpuProps);
+		// The 1.2/1.3 feature structs may only be chained on devices of that version
+		const bool is12 = gpuProps.apiVersion >= VK_API_VERSION_1_2;
+		const bool is13 = gpuProps.apiVersion >= VK_API_VERSION_1_3;
+		v12Supported.pNext = hasPerfExt ? &perfSupported : nullptr;
+		v13Supported.pNext = &v12Supported;
+		supported.pNext = is13 ? static_cast<void*>(&v13Supported) : is12 ? static_cast<void*>(&v12Supported) : nullptr;
+		vkGetPhysicalDeviceFeatures2(gpu_, &supported);
+
+		VkPhysicalDevicePerformanceQueryFeaturesKHR perfFeats{VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PERFORMANCE_QUERY_FEATURES_KHR};
+		VkPhysicalDeviceVulkan12Features v12Feats{VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES};
+		VkPhysicalDeviceVulkan13Features v13Feats{VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_3_FEATURES};
+		VkPhysicalDeviceFeatures2 feats{VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2};
+		feats.pNext = is12 ? &v12Feats : nullptr;
+		caps_.apiVersion = gpuProps.apiVersion;
+		caps_.type = gpuProps.deviceType;
+		caps_.deviceLocalBytes = largestDeviceLocalHeap(gpu_);
+		caps_.dynamicRendering = params.enableDynamicRendering && is13 && v13Supported.dynamicRendering &&
+			v13Supported.synchronization2;
+		if (caps_.dynamicRendering)
+		{
+			v13Feats.dynamicRendering = VK_TRUE;
+			v13Feats.synchronization2 = VK_TRUE;
+			v13Feats.pNext = &v12Feats;
+			feats.pNext = &v13Feats;
+		}
+		const bool optional = params.enableOptionalFeatures && is12;
+		caps_.timelineSemaphore = optional && v12Supported.timelineSemaphore;
+		v12Feats.timelineSemaphore = caps_.timelineSemaphore ? VK_TRUE : VK_FALSE;
+		caps_.drawIndirectCount = optional && v12Supported.drawIndirectCount;
+		v12Feats.drawIndirectCount = caps_.drawIndirectCount ? VK_TRUE : VK_FALSE;
+		caps_.descriptorIndexing = optional && supportsDescriptorIndexing(v12Supported);
+		if (caps_.descriptorIndexing)
+		{
+			v12Feats.descriptorIndexing = VK_TRUE;
+			v12Feats.runtimeDescriptorArray = VK_TRUE;
+			v12Feats.descriptorBindingPartiallyBound = VK_TRUE;
+			v12Feats.descriptorBindingVariableDescriptorCount = VK_TRUE;
+			v12Feats.shaderSampledImageArrayNonUniformIndexing = VK_TRUE;
+			v12Feats.descriptorBindingSampledImageUpdateAfterBind = VK_TRUE;
+		}
+		caps_.pipelineStatistics = params.enablePipelineStatistics && supported.features.pipelineStatisticsQuery;
+		feats.features.pipelineStatisticsQuery = caps_.pipelineStatistics ? VK_TRUE : VK_FALSE;
+		// Performance queries are reset from the host (they may not be reset in the command buffer using them)
+		caps_.performanceQuery = params.enablePerformanceQuery && is12 && hasPerfExt &&
+			perfSupported.performanceCounterQueryPools && v12Supported.hostQueryReset;
+		if (caps_.performanceQuery)
+		{
+			extensions.push_back(VK_KHR_PERFORMANCE_QUERY_EXTENSION_NAME);
+			perfFeats.performanceCounterQueryPools = VK_TRUE;
+			v12Feats.hostQueryReset = VK_TRUE;
+			v12Feats.pNext = &perfFeats;
+		}
+
 		VkDeviceCreateInfo ci{};
 		ci.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
+		ci.pNext = &feats;
 		ci.queueCreateInfoCount = static_cast<uint32_t>(qcis.size());
 		ci.pQueueCreateInfos = qcis.data();
-		ci.pEnabledFeatures = &feats;
+		ci.pEnabledFeatures = nullptr; // features come from the VkPhysicalDeviceFeatures2 chain
 		ci.enabledExtensionCount = static_cast<uint32_t>(extensions.size());
-		ci.ppEnabledExtensionNames = extensions.data();
+		ci.ppEnabledExtensionNames = extensions.empty() ? nullptr : extensions.data();
 
 		VkResult r = vkCreateDevice(gpu_, &ci, nullptr, &device_);
 		if (r != VK_SUCCESS) throw std::runtime_error(std::string("vkCreateDevice failed: ") + vk_err(r));
+		// Once per device: later calls (and extension entry points) skip the loader's lookup and trampoline
+		vk_.load(device_);
 
-		vkGetDeviceQueue(device_, gfxQueueFamily_, 0, &gfxQueue_);
-		vkGetDeviceQueue(device_, presentQueueFamily_, 0, &presentQueue_);
+		vk_.GetDeviceQueue(device_, gfxQueueFamily_, 0, &gfxQueue_);
+		vk_.GetDeviceQueue(device_, presentQueueFamily_, 0, &presentQueue_);
+		if (computeQueue) vk_.GetDeviceQueue(device_, caps_.computeQueueFamily, 0, &computeQueue_);
+		if (transferQueue) vk_.GetDeviceQueue(device_, caps_.transferQueueFamily, 0, &transferQueue_);
 
 		// Cache timestampPeriod (ns per tick)
 		VkPhysicalDeviceProperties props{};
 		vkGetPhysicalDeviceProperties(gpu_, &props);
 		timestampPeriod_ = props.limits.timestampPeriod; // in nanoseconds per tick
+		minUboAlignment_ = props.limits.minUniformBufferOffsetAlignment;
+		deviceName_ = props.deviceName;
+
+		vkGetPhysicalDeviceMemoryProperties(gpu_, &memoryProperties_);
+		memoryBudget_->reset();
+		for (uint32_t i = 0; i < memoryProperties_.memoryHeapCount; ++i)
+		{
+			const VkMemoryHeap& heap = memoryProperties_.memoryHeaps[i];
+			memoryBudget_->addHeap(heap.size, (heap.flags & VK_MEMORY_HEAP_DEVICE_LOCAL_BIT) != 0);
+		}
+		refreshMemoryBudget();
+		spdlog::info("Device capabilities: timeline={} descriptorIndexing={} dynamicRendering={} drawIndirectCount={} "
+		             "asyncCompute={} dedicatedTransfer={} memoryBudget={}", caps_.timelineSemaphore, caps_.descriptorIndexing,
+		             caps_.dynamicRendering, caps_.drawIndirectCount, computeQueue_ != VK_NULL_HANDLE,
+		             transferQueue_ != VK_NULL_HANDLE, caps_.memoryBudget);
+	}
+
+	uint32_t Device::findMemoryType(uint32_t typeBits, VkMemoryPropertyFlags properties) const
+	{
+		for (uint32_t i = 0; i < memoryProperties_.memoryTypeCount; ++i)
+		{
+			if ((typeBits & (1u << i)) && (memoryProperties_.memoryTypes[i].propertyFlags & properties) == properties)
+				return i;
+		}
+		throw std::runtime_error("No suitable memory type found");
+	}
+
+	DeviceAllocation Device::allocateMemory(const VkMemoryRequirements& requirements,
+	                                        VkMemoryPropertyFlags properties, MemoryCategory category) const
+	{
+		DeviceAllocation a{};
+		a.memoryType = findMemoryType(requirements.memoryTypeBits, properties);
+		a.heap = memoryProperties_.memoryTypes[a.memoryType].heapIndex;
+		a.size = requirements.size;
+		a.category = category;
+		// Soft budget: make room from least recently used residents, then allocate regardless
+		if (memoryBudget_->wouldExceed(a.heap, category, a.size)) memoryBudget_->evict(a.heap, a.size);
+
+		VkMemoryAllocateInfo ai{VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO};
+		ai.allocationSize = a.size;
+		ai.memoryTypeIndex = a.memoryType;
+		VkResult r = vk_.AllocateMemory(device_, &ai, nullptr, &a.memory);
+		if (r != VK_SUCCESS)
+		{
+			const MemoryStats stats = memoryBudget_->stats();
+			spdlog::error("vkAllocateMemory of {} KiB ({}) on heap {} failed: {}; device-local {} / {} MiB",
+			              a.size >> 10, toString(category), a.heap, vk_err(r), stats.deviceLocalUsage() >> 20,
+			              stats.deviceLocalBudget() >> 20);
+			throw std::runtime_error(std::string("vkAllocateMemory failed: ") + vk_err(r));
+		}
+		memoryBudget_->onAllocate(a.heap, category, a.size);
+		return a;
+	}
+
+	void Device::freeMemory(DeviceAllocation& allocation) const
+	{
+		if (!allocation.memory) return;
+		vk_.FreeMemory(device_, allocation.memory, nullptr);
+		memoryBudget_->onFree(allocation.heap, allocation.category, allocation.size);
+		allocation = {};
+	}
+
+	void Device::refreshMemoryBudget() const
+	{
+		if (!caps_.memoryBudget) return;
+		VkPhysicalDeviceMemoryBudgetPropertiesEXT budget{VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MEMORY_BUDGET_PROPERTIES_EXT};
+		VkPhysicalDeviceMemoryProperties2 props{VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MEMORY_PROPERTIES_2};
+		props.pNext = &budget;
+		vkGetPhysicalDeviceMemoryProperties2(gpu_, &props);
+		for (uint32_t i = 0; i < props.memoryProperties.memoryHeapCount; ++i)
+			memoryBudget_->setDriverBudget(i, budget.heapBudget[i], budget.heapUsage[i]);
 	}
 
 	void Device::destroyDebugMessenger()
@@ -355,30 +591,30 @@ namespace luster::gfx
 		VkCommandPoolCreateInfo pci{VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO};
 		pci.queueFamilyIndex = gfxQueueFamily_;
 		pci.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT | VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
-		if (vkCreateCommandPool(device_, &pci, nullptr, &pool) != VK_SUCCESS)
+		if (vk_.CreateCommandPool(device_, &pci, nullptr, &pool) != VK_SUCCESS)
 			throw std::runtime_error(
 				"create pool failed");
 		VkCommandBufferAllocateInfo ai{VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO};
 		ai.commandPool = pool;
 		ai.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
 		ai.commandBufferCount = 1;
-		if (vkAllocateCommandBuffers(device_, &ai, &cmd) != VK_SUCCESS) throw std::runtime_error("alloc cmd failed");
+		if (vk_.AllocateCommandBuffers(device_, &ai, &cmd) != VK_SUCCESS) throw std::runtime_error("alloc cmd failed");
 		VkFenceCreateInfo fci{VK_STRUCTURE_TYPE_FENCE_CREATE_INFO};
-		if (vkCreateFence(device_, &fci, nullptr, &fence) != VK_SUCCESS)
+		if (vk_.CreateFence(device_, &fci, nullptr, &fence) != VK_SUCCESS)
 			throw
 				std::runtime_error("create fence failed");
 		VkCommandBufferBeginInfo bi{VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO};
 		bi.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
-		vkBeginCommandBuffer(cmd, &bi);
+		vk_.BeginCommandBuffer(cmd, &bi);
 		recordCommands(cmd);
-		vkEndCommandBuffer(cmd);
+		vk_.EndCommandBuffer(cmd);
 		VkSubmitInfo si{VK_STRUCTURE_TYPE_SUBMIT_INFO};
 		si.commandBufferCount = 1;
 		si.pCommandBuffers = &cmd;
-		vkQueueSubmit(gfxQueue_, 1, &si, fence);
-		vkWaitForFences(device_, 1, &fence, VK_TRUE, UINT64_C(1'000'000'000));
-		vkDestroyFence(device_, fence, nullptr);
-		vkFreeCommandBuffers(device_, pool, 1, &cmd);
-		vkDestroyCommandPool(device_, pool, nullptr);
+		vk_.QueueSubmit(gfxQueue_, 1, &si, fence);
+		vk_.WaitForFences(device_, 1, &fence, VK_TRUE, UINT64_C(1'000'000'000));
+		vk_.DestroyFence(device_, fence, nullptr);
+		vk_.FreeCommandBuffers(device_, pool, 1, &cmd);
+		vk_.DestroyCommandPool(device_, pool, nullptr);
 	}
 }
@@ -1,13 +1,41 @@
 #pragma once
 
 #include "core/core.hpp"
+#include "core/gfx/device_dispatch.hpp"
+#include "core/gfx/memory_budget.hpp"
+#include <cstdint>
 #include <vector>
 #include <functional>
+#include <memory>
+#include <string>
 
 namespace luster { class Window; }
 
 namespace luster::gfx
 {
+	// What the created device supports and has enabled; renderer paths branch on this instead of re-querying
+	struct DeviceCapabilities
+	{
+		static constexpr uint32_t kNoQueueFamily = UINT32_MAX;
+
+		uint32_t apiVersion = 0;
+		VkPhysicalDeviceType type = VK_PHYSICAL_DEVICE_TYPE_OTHER;
+		VkDeviceSize deviceLocalBytes = 0; // largest DEVICE_LOCAL heap
+		// Enabled features (requested and supported)
+		bool timelineSemaphore = false;
+		bool descriptorIndexing = false; // + runtimeDescriptorArray, partiallyBound, variable count, update-after-bind (sampled images)
+		bool dynamicRendering = false; // + synchronization2
+		bool drawIndirectCount = false;
+		bool pipelineStatistics = false;
+		bool performanceQuery = false;
+		bool memoryBudget = false; // VK_EXT_memory_budget: driver heap budgets instead of heap-size estimates
+		// Queue families without graphics (compute) / without graphics and compute (transfer), kNoQueueFamily if absent
+		uint32_t computeQueueFamily = kNoQueueFamily;
+		uint32_t transferQueueFamily = kNoQueueFamily;
+		bool asyncCompute() const { return computeQueueFamily != kNoQueueFamily; }
+		bool dedicatedTransfer() const { return transferQueueFamily != kNoQueueFamily; }
+	};
+
 	class Device
 	{
 	public:
@@ -18,25 +46,64 @@ namespace luster::gfx
 			std::vector<const char*> extraInstanceExtensions{};
 			std::vector<const char*> extraInstanceLayers{};
 			std::vector<const char*> extraDeviceExtensions{};
+			bool enablePipelineStatistics = true; // pipelineStatisticsQuery feature, if supported
+			// VK_KHR_performance_query (+ hostQueryReset), if supported; holds the device profiling lock
+			bool enablePerformanceQuery = false;
+			// Vulkan 1.3 dynamicRendering + synchronization2, if supported (render passes without VkRenderPass/VkFramebuffer)
+			bool enableDynamicRendering = true;
+			// One queue each on the dedicated compute/transfer families, if present (else both fall back to graphics)
+			bool enableAsyncQueues = true;
+			// Vulkan 1.2 features (timeline semaphores, draw indirect count, descriptor indexing), if supported
+			bool enableOptionalFeatures = true;
+			// GPU override: index into the enumeration order, or a case-insensitive substring of the name; best score otherwise
+			int preferredDeviceIndex = -1;
+			std::string preferredDeviceName{};
 		};
 		Device();
 		~Device();
 
 		void init(::luster::Window& window, const InitParams& params = InitParams{});
+		// Headless: no surface, no present queue, no VK_KHR_swapchain (offscreen rendering only)
+		void initHeadless(const InitParams& params = InitParams{});
 		void cleanup();
 		void waitIdle() const;
 		bool isInitialized() const { return device_ != VK_NULL_HANDLE; }
+		bool isHeadless() const { return surface_ == VK_NULL_HANDLE; }
 
 		// Accessors
 		VkInstance instance() const { return instance_; }
 		VkSurfaceKHR surface() const { return surface_; }
 		VkPhysicalDevice physical() const { return gpu_; }
 		VkDevice logical() const { return device_; }
+		// Device-level entry points of logical(); all gfx code calls through this instead of the loader
+		const DeviceDispatch& vk() const { return vk_; }
 		uint32_t gfxQueueFamily() const { return gfxQueueFamily_; }
 		uint32_t presentQueueFamily() const { return presentQueueFamily_; }
 		VkQueue gfxQueue() const { return gfxQueue_; }
 		VkQueue presentQueue() const { return presentQueue_; }
+		// Dedicated compute / transfer queues; without one these return the graphics family and queue
+		uint32_t computeQueueFamily() const { return computeQueue_ ? caps_.computeQueueFamily : gfxQueueFamily_; }
+		uint32_t transferQueueFamily() const { return transferQueue_ ? caps_.transferQueueFamily : gfxQueueFamily_; }
+		VkQueue computeQueue() const { return computeQueue_ ? computeQueue_ : gfxQueue_; }
+		VkQueue transferQueue() const { return transferQueue_ ? transferQueue_ : gfxQueue_; }
+		bool hasAsyncCompute() const { return computeQueue_ != VK_NULL_HANDLE; }
 		float timestampPeriod() const { return timestampPeriod_; }
+		VkDeviceSize minUniformBufferOffsetAlignment() const { return minUboAlignment_; }
+		const std::string& name() const { return deviceName_; }
+		const DeviceCapabilities& capabilities() const { return caps_; }
+		bool pipelineStatisticsEnabled() const { return caps_.pipelineStatistics; }
+		bool performanceQueryEnabled() const { return caps_.performanceQuery; }
+		bool dynamicRenderingEnabled() const { return caps_.dynamicRendering; }
+
+		// Device memory: every vkAllocateMemory goes through here so MemoryBudget sees it. When the allocation would
+		// exceed the heap or category budget, evictable residents of that heap are evicted first.
+		uint32_t findMemoryType(uint32_t typeBits, VkMemoryPropertyFlags properties) const;
+		DeviceAllocation allocateMemory(const VkMemoryRequirements& requirements, VkMemoryPropertyFlags properties,
+		                                MemoryCategory category) const;
+		void freeMemory(DeviceAllocation& allocation) const;
+		MemoryBudget& memoryBudget() const { return *memoryBudget_; }
+		// Re-reads VK_EXT_memory_budget heap budgets/usage (no-op without it); once per frame
+		void refreshMemoryBudget() const;
 
 		// Helpers
 		VkFormat findSupportedFormat(const std::vector<VkFormat>& candidates, VkImageTiling tiling, VkFormatFeatureFlags features) const;
@@ -44,8 +111,8 @@ namespace luster::gfx
         void submitImmediate(const std::function<void(VkCommandBuffer)>& recordCommands) const;
 
 	private:
-		void createInstance(::luster::Window& window, const InitParams& params);
-		void pickDevice();
+		void createInstance(::luster::Window* window, const InitParams& params);
+		void pickDevice(const InitParams& params);
 		void createDevice(const InitParams& params);
 		void destroyDebugMessenger();
 
@@ -54,13 +121,21 @@ namespace luster::gfx
 		VkSurfaceKHR surface_ = VK_NULL_HANDLE;
 		VkPhysicalDevice gpu_ = VK_NULL_HANDLE;
 		VkDevice device_ = VK_NULL_HANDLE;
+		DeviceDispatch vk_{};
 
 		uint32_t gfxQueueFamily_ = 0;
 		uint32_t presentQueueFamily_ = 0;
 		VkQueue gfxQueue_ = VK_NULL_HANDLE;
 		VkQueue presentQueue_ = VK_NULL_HANDLE;
+		VkQueue computeQueue_ = VK_NULL_HANDLE;
+		VkQueue transferQueue_ = VK_NULL_HANDLE;
 
 		VkDebugUtilsMessengerEXT debugMessenger_ = VK_NULL_HANDLE;
 		float timestampPeriod_ = 0.0f;
+		VkDeviceSize minUboAlignment_ = 256;
+		std::string deviceName_{};
+		VkPhysicalDeviceMemoryProperties memoryProperties_{};
+		std::unique_ptr<MemoryBudget> memoryBudget_ = std::make_unique<MemoryBudget>();
+		DeviceCapabilities caps_{};
 	};
 }
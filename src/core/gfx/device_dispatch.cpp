@@ -0,0 +1,19 @@
+#include "core/gfx/device_dispatch.hpp"
+#include <stdexcept>
+#include <string>
+
+namespace luster::gfx
+{
+	void DeviceDispatch::load(VkDevice device)
+	{
+		*this = DeviceDispatch{};
+#define LUSTER_LOAD_PFN(name) name = reinterpret_cast<PFN_vk##name>(vkGetDeviceProcAddr(device, "vk" #name));
+#define LUSTER_LOAD_REQUIRED_PFN(name) \
+		LUSTER_LOAD_PFN(name) \
+		if (!name) throw std::runtime_error("vkGetDeviceProcAddr failed: vk" #name);
+		LUSTER_DEVICE_FUNCTIONS_1_0(LUSTER_LOAD_REQUIRED_PFN)
+		LUSTER_DEVICE_FUNCTIONS_OPTIONAL(LUSTER_LOAD_PFN)
+#undef LUSTER_LOAD_REQUIRED_PFN
+#undef LUSTER_LOAD_PFN
+	}
+}
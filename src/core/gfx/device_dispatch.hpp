@@ -0,0 +1,116 @@
+#pragma once
+
+#include "core/core.hpp"
+
+// Device-level entry points, loaded once per VkDevice through vkGetDeviceProcAddr. Calling through the table
+// skips the loader's dispatch trampoline (and the per-call symbol lookups the label helpers used to do).
+// Members drop the "vk" prefix: device.vk().CmdDraw(...) calls vkCmdDraw.
+
+// Vulkan 1.0 core: always present
+#define LUSTER_DEVICE_FUNCTIONS_1_0(X) \
+	X(DestroyDevice) \
+	X(GetDeviceQueue) \
+	X(DeviceWaitIdle) \
+	X(QueueSubmit) \
+	X(QueueWaitIdle) \
+	X(AllocateMemory) \
+	X(FreeMemory) \
+	X(MapMemory) \
+	X(UnmapMemory) \
+	X(BindBufferMemory) \
+	X(BindImageMemory) \
+	X(GetBufferMemoryRequirements) \
+	X(GetImageMemoryRequirements) \
+	X(CreateBuffer) \
+	X(DestroyBuffer) \
+	X(CreateImage) \
+	X(DestroyImage) \
+	X(CreateImageView) \
+	X(DestroyImageView) \
+	X(CreateSampler) \
+	X(DestroySampler) \
+	X(CreateShaderModule) \
+	X(DestroyShaderModule) \
+	X(CreatePipelineLayout) \
+	X(DestroyPipelineLayout) \
+	X(CreateGraphicsPipelines) \
+	X(CreateComputePipelines) \
+	X(DestroyPipeline) \
+	X(CreateDescriptorSetLayout) \
+	X(DestroyDescriptorSetLayout) \
+	X(CreateDescriptorPool) \
+	X(DestroyDescriptorPool) \
+	X(AllocateDescriptorSets) \
+	X(UpdateDescriptorSets) \
+	X(CreateRenderPass) \
+	X(DestroyRenderPass) \
+	X(CreateFramebuffer) \
+	X(DestroyFramebuffer) \
+	X(CreateCommandPool) \
+	X(DestroyCommandPool) \
+	X(AllocateCommandBuffers) \
+	X(FreeCommandBuffers) \
+	X(BeginCommandBuffer) \
+	X(EndCommandBuffer) \
+	X(ResetCommandBuffer) \
+	X(CreateFence) \
+	X(DestroyFence) \
+	X(ResetFences) \
+	X(WaitForFences) \
+	X(CreateSemaphore) \
+	X(DestroySemaphore) \
+	X(CreateQueryPool) \
+	X(DestroyQueryPool) \
+	X(GetQueryPoolResults) \
+	X(CmdBeginRenderPass) \
+	X(CmdEndRenderPass) \
+	X(CmdBindPipeline) \
+	X(CmdBindVertexBuffers) \
+	X(CmdBindIndexBuffer) \
+	X(CmdBindDescriptorSets) \
+	X(CmdPushConstants) \
+	X(CmdSetViewport) \
+	X(CmdSetScissor) \
+	X(CmdDraw) \
+	X(CmdDrawIndexed) \
+	X(CmdDispatch) \
+	X(CmdPipelineBarrier) \
+	X(CmdCopyBuffer) \
+	X(CmdFillBuffer) \
+	X(CmdCopyImage) \
+	X(CmdCopyImageToBuffer) \
+	X(CmdBlitImage) \
+	X(CmdResetQueryPool) \
+	X(CmdBeginQuery) \
+	X(CmdEndQuery) \
+	X(CmdWriteTimestamp)
+
+// Core in newer versions or provided by optional extensions: null when the device did not enable them
+#define LUSTER_DEVICE_FUNCTIONS_OPTIONAL(X) \
+	X(ResetQueryPool) /* 1.2 / hostQueryReset */ \
+	X(CmdBeginRendering) /* 1.3 */ \
+	X(CmdEndRendering) /* 1.3 */ \
+	X(CmdPipelineBarrier2) /* 1.3 */ \
+	X(CreateSwapchainKHR) \
+	X(DestroySwapchainKHR) \
+	X(GetSwapchainImagesKHR) \
+	X(AcquireNextImageKHR) \
+	X(QueuePresentKHR) \
+	X(AcquireProfilingLockKHR) \
+	X(ReleaseProfilingLockKHR) \
+	X(CmdBeginDebugUtilsLabelEXT) \
+	X(CmdEndDebugUtilsLabelEXT)
+
+namespace luster::gfx
+{
+	struct DeviceDispatch
+	{
+#define LUSTER_DECLARE_PFN(name) PFN_vk##name name = nullptr;
+		LUSTER_DEVICE_FUNCTIONS_1_0(LUSTER_DECLARE_PFN)
+		LUSTER_DEVICE_FUNCTIONS_OPTIONAL(LUSTER_DECLARE_PFN)
+#undef LUSTER_DECLARE_PFN
+
+		// Resolves every entry for `device`; throws if a 1.0 core function is missing
+		void load(VkDevice device);
+	};
+}
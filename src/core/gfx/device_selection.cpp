@@ -0,0 +1,88 @@
+#include "core/gfx/device_selection.hpp"
+#include <algorithm>
+#include <cctype>
+
+namespace luster::gfx
+{
+	static int64_t typeScore(VkPhysicalDeviceType type)
+	{
+		switch (type)
+		{
+		case VK_PHYSICAL_DEVICE_TYPE_DISCRETE_GPU: return 10000;
+		case VK_PHYSICAL_DEVICE_TYPE_INTEGRATED_GPU: return 4000;
+		case VK_PHYSICAL_DEVICE_TYPE_VIRTUAL_GPU: return 2000;
+		case VK_PHYSICAL_DEVICE_TYPE_CPU: return 100; // lavapipe / SwiftShader: last resort
+		default: return 500;
+		}
+	}
+
+	int64_t scoreDevice(const DeviceCandidate& c)
+	{
+		if (!c.suitable) return -1;
+		int64_t score = typeScore(c.type);
+		// 100 per GiB of VRAM, capped so a big integrated carve-out never outweighs the type
+		constexpr VkDeviceSize kGiB = 1024ull * 1024ull * 1024ull;
+		score += static_cast<int64_t>(std::min<VkDeviceSize>(c.deviceLocalBytes / kGiB, 32)) * 100;
+		if (c.apiVersion >= VK_API_VERSION_1_3) score += 600;
+		else if (c.apiVersion >= VK_API_VERSION_1_2) score += 300;
+		const bool features[] = {c.timelineSemaphore, c.descriptorIndexing, c.dynamicRendering, c.drawIndirectCount,
+		                         c.asyncCompute, c.dedicatedTransfer};
+		for (bool f : features) score += f ? 100 : 0;
+		return score;
+	}
+
+	static bool containsNoCase(const std::string& haystack, const std::string& needle)
+	{
+		const auto it = std::search(haystack.begin(), haystack.end(), needle.begin(), needle.end(),
+		                            [](char a, char b)
+		                            {
+			                            return std::tolower(static_cast<unsigned char>(a)) ==
+				                            std::tolower(static_cast<unsigned char>(b));
+		                            });
+		return it != haystack.end();
+	}
+
+	int selectDevice(const std::vector<DeviceCandidate>& candidates, const std::string& preferredName,
+	                 int preferredIndex)
+	{
+		const int count = static_cast<int>(candidates.size());
+		if (preferredIndex >= 0)
+		{
+			if (preferredIndex < count && candidates[preferredIndex].suitable) return preferredIndex;
+			spdlog::warn("Requested GPU index {} is not available or not suitable, falling back to scoring",
+			             preferredIndex);
+		}
+		else if (!preferredName.empty())
+		{
+			for (int i = 0; i < count; ++i)
+				if (candidates[i].suitable && containsNoCase(candidates[i].name, preferredName)) return i;
+			spdlog::warn("No suitable GPU matches '{}', falling back to scoring", preferredName);
+		}
+
+		int best = -1;
+		int64_t bestScore = -1;
+		for (int i = 0; i < count; ++i)
+		{
+			const int64_t s = scoreDevice(candidates[i]);
+			// Strictly greater: ties keep the enumeration order
+			if (s > bestScore)
+			{
+				best = i;
+				bestScore = s;
+			}
+		}
+		return best;
+	}
+
+	const char* deviceTypeName(VkPhysicalDeviceType type)
+	{
+		switch (type)
+		{
+		case VK_PHYSICAL_DEVICE_TYPE_DISCRETE_GPU: return "discrete";
+		case VK_PHYSICAL_DEVICE_TYPE_INTEGRATED_GPU: return "integrated";
+		case VK_PHYSICAL_DEVICE_TYPE_VIRTUAL_GPU: return "virtual";
+		case VK_PHYSICAL_DEVICE_TYPE_CPU: return "cpu";
+		default: return "other";
+		}
+	}
+}
@@ -0,0 +1,37 @@
+#pragma once
+
+#include "core/core.hpp"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace luster::gfx
+{
+	// What pickDevice learned about one physical device (filled from Vulkan queries, scored without them)
+	struct DeviceCandidate
+	{
+		std::string name{};
+		VkPhysicalDeviceType type = VK_PHYSICAL_DEVICE_TYPE_OTHER;
+		uint32_t apiVersion = 0;
+		VkDeviceSize deviceLocalBytes = 0; // largest DEVICE_LOCAL heap
+		bool suitable = false; // graphics + present + swapchain (present/swapchain not required headless)
+		bool timelineSemaphore = false;
+		bool descriptorIndexing = false;
+		bool dynamicRendering = false; // dynamicRendering + synchronization2
+		bool drawIndirectCount = false;
+		bool asyncCompute = false; // compute family without graphics
+		bool dedicatedTransfer = false; // transfer family without graphics/compute
+	};
+
+	// Higher is better; negative when the device cannot run the renderer.
+	// Device type dominates (discrete > integrated > virtual > CPU), then VRAM, API version and optional features.
+	int64_t scoreDevice(const DeviceCandidate& candidate);
+
+	// Index of the device to use, or -1 when none is suitable.
+	// preferredIndex (>= 0) or a case-insensitive substring of the name wins over the score when that device
+	// is suitable; otherwise the override is ignored (with a warning) and the best score is taken.
+	int selectDevice(const std::vector<DeviceCandidate>& candidates, const std::string& preferredName = {},
+	                 int preferredIndex = -1);
+
+	const char* deviceTypeName(VkPhysicalDeviceType type);
+}
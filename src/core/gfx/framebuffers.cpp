@@ -5,7 +5,6 @@
 #include "core/gfx/swapchain.hpp"
 #include "core/utils/profiler.hpp"
 #include <stdexcept>
-#include <functional>
 #include "core/window.hpp"
 
 namespace luster::gfx
@@ -28,54 +27,56 @@ namespace luster::gfx
 			fci.width = extent.width;
 			fci.height = extent.height;
 			fci.layers = 1;
-			VkResult r = vkCreateFramebuffer(device.logical(), &fci, nullptr, &framebuffers_[i]);
+			VkResult r = device.vk().CreateFramebuffer(device.logical(), &fci, nullptr, &framebuffers_[i]);
 			if (r != VK_SUCCESS) throw std::runtime_error("vkCreateFramebuffer failed");
 		}
 	}
 
 	void Framebuffers::cleanup(const Device& device)
 	{
-		for (auto fb : framebuffers_) if (fb) vkDestroyFramebuffer(device.logical(), fb, nullptr);
+		for (auto fb : framebuffers_) if (fb) device.vk().DestroyFramebuffer(device.logical(), fb, nullptr);
 		framebuffers_.clear();
 	}
 
 	Framebuffers::FrameResult Framebuffers::drawFrame(::luster::Window& window,
 	                                                  const Device& device,
-	                                                  const RenderPass& rp,
 	                                                  CommandContext& ctx,
 	                                                  Swapchain& swapchain,
-	                                                  const std::function<void(VkCommandBuffer, uint32_t)>&
-	                                                  recordCallback)
+	                                                  FunctionRef<void(VkCommandBuffer, uint32_t)> recordCallback,
+	                                                  FunctionRef<void()> preSubmit)
 	{
 		(void)window;
-		(void)rp; // 当前实现不直接使用，保留签名以便未来扩展
 		PROFILE_SCOPE("frame");
 		ctx.waitFence(device, UINT64_C(1'000'000'000));
-		ctx.resetFence(device);
 
 		uint32_t imageIndex = 0;
-		VkResult r = vkAcquireNextImageKHR(device.logical(), swapchain.handle(), UINT64_MAX,
-		                                   ctx.imageAvailable(), VK_NULL_HANDLE, &imageIndex);
+		VkResult r = device.vk().AcquireNextImageKHR(device.logical(), swapchain.handle(), UINT64_MAX,
+		                                             ctx.imageAvailable(), VK_NULL_HANDLE, &imageIndex);
 		if (r == VK_ERROR_OUT_OF_DATE_KHR)
 			return FrameResult::NeedRecreate; // signal caller to recreate swapchain
 		if (r != VK_SUCCESS && r != VK_SUBOPTIMAL_KHR)
 			return FrameResult::Error;
+		// Reset only once a submit is certain: an early return must leave the fence signaled,
+		// otherwise the next frame's wait runs into its timeout
+		ctx.resetFence(device);
 
 		VkCommandBuffer cb = ctx.begin();
 		recordCallback(cb, imageIndex);
 		ctx.end();
+		if (preSubmit) preSubmit();
 
-		ctx.submit(device.gfxQueue(), ctx.imageAvailable(), ctx.renderFinished(), ctx.inFlight());
+		VkSemaphore rf = ctx.renderFinished();
+		ctx.submit(device.gfxQueue(), ctx.imageAvailable(), rf, ctx.inFlight());
+		ctx.advanceFrame();
 
 		VkPresentInfoKHR pi{VK_STRUCTURE_TYPE_PRESENT_INFO_KHR};
 		pi.waitSemaphoreCount = 1;
-		VkSemaphore rf = ctx.renderFinished();
 		pi.pWaitSemaphores = &rf;
 		pi.swapchainCount = 1;
 		VkSwapchainKHR sc = swapchain.handle();
 		pi.pSwapchains = &sc;
 		pi.pImageIndices = &imageIndex;
-		r = vkQueuePresentKHR(device.presentQueue(), &pi);
+		r = device.vk().QueuePresentKHR(device.presentQueue(), &pi);
 		if (r == VK_ERROR_OUT_OF_DATE_KHR || r == VK_SUBOPTIMAL_KHR)
 			return FrameResult::NeedRecreate;
 		if (r != VK_SUCCESS)
@@ -83,4 +84,23 @@ namespace luster::gfx
 
 		return FrameResult::Ok;
 	}
+
+	Framebuffers::FrameResult Framebuffers::drawOffscreen(const Device& device,
+	                                                      CommandContext& ctx,
+	                                                      FunctionRef<void(VkCommandBuffer, uint32_t)> recordCallback,
+	                                                      FunctionRef<void()> preSubmit)
+	{
+		PROFILE_SCOPE("frame_offscreen");
+		ctx.waitFence(device, UINT64_C(1'000'000'000));
+		ctx.resetFence(device);
+
+		VkCommandBuffer cb = ctx.begin();
+		recordCallback(cb, 0);
+		ctx.end();
+		if (preSubmit) preSubmit();
+
+		ctx.submit(device.gfxQueue(), VK_NULL_HANDLE, VK_NULL_HANDLE, ctx.inFlight());
+		ctx.advanceFrame();
+		return FrameResult::Ok;
+	}
 }
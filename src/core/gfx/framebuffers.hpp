@@ -1,8 +1,9 @@
 #pragma once
 
 #include "core/core.hpp"
+#include "core/utils/function_ref.hpp"
 #include <vector>
-#include <functional>
+#include <utility>
 
 namespace luster { class Window; }
 
@@ -26,14 +27,26 @@ namespace luster::gfx
 		            VkImageView depthImageView);
 
 
+		// Callbacks are invoked before the call returns (FunctionRef: no per-frame allocation).
+		// preSubmit (optional) runs after recording, immediately before vkQueueSubmit: the last point where
+		// host-visible data read by this frame can still change (late latching).
+		// The frame loops do not touch the framebuffer objects: with dynamic rendering there are none.
 		FrameResult drawFrame(::luster::Window& window,
 		                      const Device& device,
-		                      const RenderPass& rp,
 		                      class CommandContext& ctx,
 		                      class Swapchain& swapchain,
-		                      const std::function<void(VkCommandBuffer, uint32_t)>& recordCallback);
+		                      FunctionRef<void(VkCommandBuffer, uint32_t)> recordCallback,
+		                      FunctionRef<void()> preSubmit = {});
+
+		// Headless variant: no acquire/present, records with image index 0 and submits with the in-flight fence
+		FrameResult drawOffscreen(const Device& device,
+		                          class CommandContext& ctx,
+		                          FunctionRef<void(VkCommandBuffer, uint32_t)> recordCallback,
+		                          FunctionRef<void()> preSubmit = {});
 
 		void cleanup(const Device& device);
+		// Hands the handles to the caller (deferred destruction); the object is left empty
+		std::vector<VkFramebuffer> release() { return std::exchange(framebuffers_, {}); }
 
 		const std::vector<VkFramebuffer>& handles() const { return framebuffers_; }
 
@@ -0,0 +1,515 @@
+#include "core/gfx/gpu_allocator.hpp"
+#include "core/gfx/device.hpp"
+#include "core/memory/scratch.hpp"
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+namespace luster::gfx
+{
+	void GpuAllocator::create(const Device& device, VkDeviceSize blockSize)
+	{
+		cleanup(device);
+		device_ = &device;
+		blockSize_ = blockSize;
+	}
+
+	void GpuAllocator::cleanup(const Device& device)
+	{
+		if (!device_) return;
+		collect(UINT64_MAX);
+		// Planned but never recorded: only the new objects exist, their ranges go with the blocks
+		for (const Move& m : pending_)
+		{
+			if (m.view) device.vk().DestroyImageView(device.logical(), m.view, nullptr);
+			if (m.image) device.vk().DestroyImage(device.logical(), m.image, nullptr);
+			if (m.buffer) device.vk().DestroyBuffer(device.logical(), m.buffer, nullptr);
+		}
+		pending_.clear();
+		for (Slot& s : slots_.objects())
+		{
+			if (s.view) device.vk().DestroyImageView(device.logical(), s.view, nullptr);
+			if (s.image) device.vk().DestroyImage(device.logical(), s.image, nullptr);
+			if (s.buffer) device.vk().DestroyBuffer(device.logical(), s.buffer, nullptr);
+		}
+		for (uint32_t i = 0; i < blocks_.size(); ++i)
+			if (blocks_[i].allocation.memory) releaseBlock(i);
+		blocks_.clear();
+		freeBlocks_.clear();
+		pools_.clear();
+		slots_.clear();
+		retired_.clear();
+		moveListener_ = {};
+		device_ = nullptr;
+	}
+
+	VkBuffer GpuAllocator::makeBuffer(const BufferCreateInfo& info) const
+	{
+		VkBufferCreateInfo bi{VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO};
+		bi.size = info.size;
+		bi.usage = info.usage;
+		bi.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+		VkBuffer buffer = VK_NULL_HANDLE;
+		if (device_->vk().CreateBuffer(device_->logical(), &bi, nullptr, &buffer) != VK_SUCCESS)
+			throw std::runtime_error("vkCreateBuffer failed");
+		return buffer;
+	}
+
+	VkImage GpuAllocator::makeImage(const ImageCreateInfo& info) const
+	{
+		VkImageCreateInfo ici{VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO};
+		ici.imageType = VK_IMAGE_TYPE_2D;
+		ici.extent = {info.width, info.height, 1};
+		ici.mipLevels = 1;
+		ici.arrayLayers = 1;
+		ici.format = info.format;
+		ici.tiling = info.tiling;
+		ici.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+		ici.usage = info.usage;
+		ici.samples = VK_SAMPLE_COUNT_1_BIT;
+		ici.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+		VkImage image = VK_NULL_HANDLE;
+		if (device_->vk().CreateImage(device_->logical(), &ici, nullptr, &image) != VK_SUCCESS)
+			throw std::runtime_error("vkCreateImage failed");
+		return image;
+	}
+
+	VkImageView GpuAllocator::makeView(VkImage image, const ImageCreateInfo& info) const
+	{
+		VkImageViewCreateInfo vi{VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO};
+		vi.image = image;
+		vi.viewType = VK_IMAGE_VIEW_TYPE_2D;
+		vi.format = info.format;
+		vi.subresourceRange.aspectMask = info.aspect;
+		vi.subresourceRange.levelCount = 1;
+		vi.subresourceRange.layerCount = 1;
+		VkImageView view = VK_NULL_HANDLE;
+		if (device_->vk().CreateImageView(device_->logical(), &vi, nullptr, &view) != VK_SUCCESS)
+			throw std::runtime_error("vkCreateImageView failed");
+		return view;
+	}
+
+	uint32_t GpuAllocator::poolFor(const VkMemoryRequirements& req, VkMemoryPropertyFlags properties,
+	                               MemoryCategory category, bool optimal)
+	{
+		const uint32_t type = device_->findMemoryType(req.memoryTypeBits, properties);
+		for (uint32_t i = 0; i < pools_.size(); ++i)
+		{
+			const Pool& p = pools_[i];
+			if (p.memoryType == type && p.category == category && p.optimal == optimal) return i;
+		}
+		Pool p{};
+		p.memoryType = type;
+		p.category = category;
+		p.optimal = optimal;
+		p.properties = properties;
+		pools_.push_back(std::move(p));
+		return static_cast<uint32_t>(pools_.size() - 1);
+	}
+
+	bool GpuAllocator::tryPlace(uint32_t pool, const VkMemoryRequirements& req, uint32_t exclude, Placement& out)
+	{
+		std::vector<uint32_t>& list = pools_[pool].blocks;
+		std::ranges::sort(list, [&](uint32_t a, uint32_t b)
+		{
+			return blocks_[a].ranges.used() > blocks_[b].ranges.used();
+		});
+		for (uint32_t b : list)
+		{
+			if (b == exclude) continue;
+			if (auto offset = blocks_[b].ranges.allocate(req.size, req.alignment))
+			{
+				out = {b, *offset};
+				return true;
+			}
+		}
+		return false;
+	}
+
+	GpuAllocator::Placement GpuAllocator::place(uint32_t pool, const VkMemoryRequirements& req)
+	{
+		Placement out{};
+		if (tryPlace(pool, req, UINT32_MAX, out)) return out;
+
+		// New block; oversized resources get one of their own
+		Pool& p = pools_[pool];
+		VkMemoryRequirements blockReq{};
+		blockReq.size = std::max(blockSize_, req.size);
+		blockReq.alignment = req.alignment;
+		blockReq.memoryTypeBits = 1u << p.memoryType;
+		Block block{};
+		block.allocation = device_->allocateMemory(blockReq, p.properties, p.category);
+		block.ranges.reset(blockReq.size);
+		block.pool = pool;
+		if (p.properties & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT)
+		{
+			if (device_->vk().MapMemory(device_->logical(), block.allocation.memory, 0, VK_WHOLE_SIZE, 0,
+			                            &block.mapped) != VK_SUCCESS)
+			{
+				device_->freeMemory(block.allocation);
+				throw std::runtime_error("vkMapMemory failed");
+			}
+		}
+
+		uint32_t index;
+		if (!freeBlocks_.empty())
+		{
+			index = freeBlocks_.back();
+			freeBlocks_.pop_back();
+			blocks_[index] = std::move(block);
+		}
+		else
+		{
+			index = static_cast<uint32_t>(blocks_.size());
+			blocks_.push_back(std::move(block));
+		}
+		p.blocks.push_back(index);
+		out = {index, *blocks_[index].ranges.allocate(req.size, req.alignment)};
+		return out;
+	}
+
+	void GpuAllocator::releaseBlock(uint32_t index)
+	{
+		Block& b = blocks_[index];
+		if (b.mapped) device_->vk().UnmapMemory(device_->logical(), b.allocation.memory);
+		releasedBlockBytes_ += b.allocation.size;
+		device_->freeMemory(b.allocation);
+		std::erase(pools_[b.pool].blocks, index);
+		b = {};
+		freeBlocks_.push_back(index);
+	}
+
+	GpuResource GpuAllocator::createBuffer(const BufferCreateInfo& info)
+	{
+		Slot s{};
+		s.bufferInfo = info;
+		s.movable = info.movable && !(info.properties & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT);
+		if (s.movable) s.bufferInfo.usage |= VK_BUFFER_USAGE_TRANSFER_SRC_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT;
+		s.buffer = makeBuffer(s.bufferInfo);
+
+		VkMemoryRequirements req{};
+		device_->vk().GetBufferMemoryRequirements(device_->logical(), s.buffer, &req);
+		Placement at{};
+		try
+		{
+			at = place(poolFor(req, info.properties, info.category, false), req);
+		}
+		catch (...)
+		{
+			device_->vk().DestroyBuffer(device_->logical(), s.buffer, nullptr);
+			throw;
+		}
+		device_->vk().BindBufferMemory(device_->logical(), s.buffer, blocks_[at.block].allocation.memory, at.offset);
+		s.block = at.block;
+		s.offset = at.offset;
+		s.size = req.size;
+		return slots_.insert(s);
+	}
+
+	GpuResource GpuAllocator::createImage(const ImageCreateInfo& info)
+	{
+		Slot s{};
+		s.isImage = true;
+		s.imageInfo = info;
+		s.movable = info.restingLayout != VK_IMAGE_LAYOUT_UNDEFINED && info.tiling == VK_IMAGE_TILING_OPTIMAL &&
+			!(info.properties & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT);
+		if (s.movable) s.imageInfo.usage |= VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT;
+		s.image = makeImage(s.imageInfo);
+
+		VkMemoryRequirements req{};
+		device_->vk().GetImageMemoryRequirements(device_->logical(), s.image, &req);
+		Placement at{};
+		try
+		{
+			const bool optimal = info.tiling == VK_IMAGE_TILING_OPTIMAL;
+			at = place(poolFor(req, info.properties, info.category, optimal), req);
+			device_->vk().BindImageMemory(device_->logical(), s.image, blocks_[at.block].allocation.memory, at.offset);
+			s.block = at.block;
+			s.offset = at.offset;
+			s.size = req.size;
+			s.view = makeView(s.image, s.imageInfo);
+		}
+		catch (...)
+		{
+			if (s.size) blocks_[at.block].ranges.free(at.offset, s.size);
+			device_->vk().DestroyImage(device_->logical(), s.image, nullptr);
+			throw;
+		}
+		return slots_.insert(s);
+	}
+
+	void GpuAllocator::destroy(GpuResource resource, uint64_t frame)
+	{
+		if (!slots_.contains(resource)) return;
+		const Slot s = slots_.remove(resource); // stale handles stop resolving
+		retired_.push_back({frame, s.buffer, s.image, s.view, s.block, s.offset, s.size});
+	}
+
+	void GpuAllocator::upload(GpuResource resource, const void* data, VkDeviceSize size)
+	{
+		const Slot* s = resolve(resource);
+		if (!s || s->isImage || !data || size == 0) return;
+		size = std::min(size, s->bufferInfo.size);
+		if (void* dst = mapped(resource))
+		{
+			std::memcpy(dst, data, size);
+			return;
+		}
+
+		Buffer staging;
+		BufferCreateInfo ci{};
+		ci.size = size;
+		ci.usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
+		ci.properties = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+		ci.category = MemoryCategory::Staging;
+		staging.create(*device_, ci);
+		std::memcpy(staging.map(*device_), data, size);
+		staging.unmap(*device_);
+		const VkBuffer dst = s->buffer;
+		device_->submitImmediate([&](VkCommandBuffer cmd)
+		{
+			VkBufferCopy region{};
+			region.size = size;
+			device_->vk().CmdCopyBuffer(cmd, staging.handle(), dst, 1, &region);
+		});
+		staging.cleanup(*device_);
+	}
+
+	bool GpuAllocator::alive(GpuResource resource) const { return resolve(resource) != nullptr; }
+
+	VkBuffer GpuAllocator::buffer(GpuResource resource) const
+	{
+		const Slot* s = resolve(resource);
+		return s ? s->buffer : VK_NULL_HANDLE;
+	}
+
+	VkImage GpuAllocator::image(GpuResource resource) const
+	{
+		const Slot* s = resolve(resource);
+		return s ? s->image : VK_NULL_HANDLE;
+	}
+
+	VkImageView GpuAllocator::view(GpuResource resource) const
+	{
+		const Slot* s = resolve(resource);
+		return s ? s->view : VK_NULL_HANDLE;
+	}
+
+	void* GpuAllocator::mapped(GpuResource resource) const
+	{
+		const Slot* s = resolve(resource);
+		if (!s || !blocks_[s->block].mapped) return nullptr;
+		return static_cast<char*>(blocks_[s->block].mapped) + s->offset;
+	}
+
+	VkDeviceSize GpuAllocator::planDefragment(VkDeviceSize byteBudget)
+	{
+		if (!device_ || byteBudget == 0) return 0;
+
+		std::vector<Move>& moves = pending_;
+		VkDeviceSize planned = 0;
+		// A plan that was never recorded still holds its ranges: record that one first
+		for (const Move& m : moves) planned += slots_.at(m.resource).size;
+		if (planned > 0) return planned;
+		for (uint32_t p = 0; p < pools_.size() && planned < byteBudget; ++p)
+		{
+			const std::vector<uint32_t>& list = pools_[p].blocks;
+			if (list.size() < 2) continue;
+			// Sparsest non-empty block; empty ones are released by collect()
+			uint32_t source = UINT32_MAX;
+			double sourceFill = kSparseBlockUsage;
+			for (uint32_t b : list)
+			{
+				const BlockAllocator& r = blocks_[b].ranges;
+				const double fill = static_cast<double>(r.used()) / static_cast<double>(r.capacity());
+				if (r.used() > 0 && fill < sourceFill)
+				{
+					source = b;
+					sourceFill = fill;
+				}
+			}
+			if (source == UINT32_MAX) continue;
+
+			for (size_t i = 0; i < slots_.size(); ++i)
+			{
+				const Slot& s = slots_.objects()[i];
+				if (!s.movable || s.block != source) continue;
+				// Always allow one move, so a resource larger than the budget still gets moved eventually
+				if (planned > 0 && planned + s.size > byteBudget) break;
+				Move m{slots_.handleAt(i), VK_NULL_HANDLE, VK_NULL_HANDLE, VK_NULL_HANDLE, {}};
+				VkMemoryRequirements req{};
+				if (s.isImage)
+				{
+					m.image = makeImage(s.imageInfo);
+					device_->vk().GetImageMemoryRequirements(device_->logical(), m.image, &req);
+				}
+				else
+				{
+					m.buffer = makeBuffer(s.bufferInfo);
+					device_->vk().GetBufferMemoryRequirements(device_->logical(), m.buffer, &req);
+				}
+				if (!tryPlace(p, req, source, m.to))
+				{
+					// Denser blocks are full: nothing more to gain from this pool for now
+					if (m.image) device_->vk().DestroyImage(device_->logical(), m.image, nullptr);
+					if (m.buffer) device_->vk().DestroyBuffer(device_->logical(), m.buffer, nullptr);
+					break;
+				}
+				const VkDeviceMemory memory = blocks_[m.to.block].allocation.memory;
+				if (s.isImage)
+				{
+					device_->vk().BindImageMemory(device_->logical(), m.image, memory, m.to.offset);
+					m.view = makeView(m.image, s.imageInfo);
+				}
+				else
+				{
+					device_->vk().BindBufferMemory(device_->logical(), m.buffer, memory, m.to.offset);
+				}
+				moves.push_back(m);
+				planned += s.size;
+			}
+		}
+		return planned;
+	}
+
+	VkDeviceSize GpuAllocator::recordDefragment(VkCommandBuffer cmd, uint64_t frame)
+	{
+		if (!device_ || pending_.empty()) return 0;
+
+		const std::vector<Move>& moves = pending_;
+		ScratchScope scratch;
+		// Previous frames' writes (uploads, render target output) before the reads; images to transfer layouts
+		const DeviceDispatch& vk = device_->vk();
+		std::pmr::vector<VkImageMemoryBarrier> imageBarriers(scratch.resource());
+		imageBarriers.reserve(moves.size() * 2);
+		const auto imageBarrier = [](VkImage image, VkImageAspectFlags aspect, VkImageLayout oldLayout,
+		                             VkImageLayout newLayout, VkAccessFlags src, VkAccessFlags dst)
+		{
+			VkImageMemoryBarrier b{VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER};
+			b.srcAccessMask = src;
+			b.dstAccessMask = dst;
+			b.oldLayout = oldLayout;
+			b.newLayout = newLayout;
+			b.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+			b.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+			b.image = image;
+			b.subresourceRange = {aspect, 0, 1, 0, 1};
+			return b;
+		};
+		for (const Move& m : moves)
+		{
+			const Slot& s = slots_.at(m.resource);
+			if (!s.isImage) continue;
+			imageBarriers.push_back(imageBarrier(s.image, s.imageInfo.aspect, s.imageInfo.restingLayout,
+			                                     VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, VK_ACCESS_MEMORY_WRITE_BIT,
+			                                     VK_ACCESS_TRANSFER_READ_BIT));
+			imageBarriers.push_back(imageBarrier(m.image, s.imageInfo.aspect, VK_IMAGE_LAYOUT_UNDEFINED,
+			                                     VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 0,
+			                                     VK_ACCESS_TRANSFER_WRITE_BIT));
+		}
+		VkMemoryBarrier before{VK_STRUCTURE_TYPE_MEMORY_BARRIER};
+		before.srcAccessMask = VK_ACCESS_MEMORY_WRITE_BIT;
+		before.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+		vk.CmdPipelineBarrier(cmd, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0,
+		                      1, &before, 0, nullptr, static_cast<uint32_t>(imageBarriers.size()),
+		                      imageBarriers.data());
+
+		for (const Move& m : moves)
+		{
+			const Slot& s = slots_.at(m.resource);
+			if (s.isImage)
+			{
+				VkImageCopy region{};
+				region.srcSubresource = {s.imageInfo.aspect, 0, 0, 1};
+				region.dstSubresource = {s.imageInfo.aspect, 0, 0, 1};
+				region.extent = {s.imageInfo.width, s.imageInfo.height, 1};
+				vk.CmdCopyImage(cmd, s.image, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, m.image,
+				                VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &region);
+			}
+			else
+			{
+				VkBufferCopy region{};
+				region.size = s.bufferInfo.size;
+				vk.CmdCopyBuffer(cmd, s.buffer, m.buffer, 1, &region);
+			}
+		}
+
+		// Copies visible to everything recorded after; new images back to their resting layout
+		imageBarriers.clear();
+		for (const Move& m : moves)
+		{
+			const Slot& s = slots_.at(m.resource);
+			if (!s.isImage) continue;
+			imageBarriers.push_back(imageBarrier(m.image, s.imageInfo.aspect, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+			                                     s.imageInfo.restingLayout, VK_ACCESS_TRANSFER_WRITE_BIT,
+			                                     VK_ACCESS_MEMORY_READ_BIT | VK_ACCESS_MEMORY_WRITE_BIT));
+		}
+		VkMemoryBarrier after{VK_STRUCTURE_TYPE_MEMORY_BARRIER};
+		after.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+		after.dstAccessMask = VK_ACCESS_MEMORY_READ_BIT | VK_ACCESS_MEMORY_WRITE_BIT;
+		vk.CmdPipelineBarrier(cmd, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, 0,
+		                      1, &after, 0, nullptr, static_cast<uint32_t>(imageBarriers.size()),
+		                      imageBarriers.data());
+
+		// Switch the handles; the old objects are read by this frame's copy and used by earlier frames
+		VkDeviceSize moved = 0;
+		for (const Move& m : moves)
+		{
+			Slot& s = slots_.at(m.resource);
+			moved += s.size;
+			retired_.push_back({frame, s.buffer, s.image, s.view, s.block, s.offset, s.size});
+			s.buffer = m.buffer;
+			s.image = m.image;
+			s.view = m.view;
+			s.block = m.to.block;
+			s.offset = m.to.offset;
+			++moves_;
+			movedBytes_ += s.size;
+			if (moveListener_) moveListener_(m.resource);
+		}
+		pending_.clear(); // keeps the capacity: no allocation once the budget's worth of moves was seen
+		return moved;
+	}
+
+	void GpuAllocator::collect(uint64_t completedFrame)
+	{
+		if (!device_) return;
+		const VkDevice dev = device_->logical();
+		std::erase_if(retired_, [&](const Retired& r)
+		{
+			if (r.frame > completedFrame) return false;
+			if (r.view) device_->vk().DestroyImageView(dev, r.view, nullptr);
+			if (r.image) device_->vk().DestroyImage(dev, r.image, nullptr);
+			if (r.buffer) device_->vk().DestroyBuffer(dev, r.buffer, nullptr);
+			blocks_[r.block].ranges.free(r.offset, r.size);
+			return true;
+		});
+		// Empty blocks go back to the driver; keep one per pool so steady churn does not reallocate
+		for (Pool& p : pools_)
+		{
+			for (size_t i = 0; i < p.blocks.size() && p.blocks.size() > 1;)
+			{
+				const uint32_t b = p.blocks[i];
+				if (blocks_[b].ranges.empty()) releaseBlock(b);
+				else ++i;
+			}
+		}
+	}
+
+	GpuAllocatorStats GpuAllocator::stats() const
+	{
+		GpuAllocatorStats s{};
+		for (const Block& b : blocks_)
+		{
+			if (!b.allocation.memory) continue;
+			++s.blocks;
+			s.blockBytes += b.ranges.capacity();
+			s.usedBytes += b.ranges.used();
+		}
+		s.resources = static_cast<uint32_t>(slots_.size());
+		s.moves = moves_;
+		s.movedBytes = movedBytes_;
+		s.releasedBlockBytes = releasedBlockBytes_;
+		return s;
+	}
+}
@@ -0,0 +1,162 @@
+#pragma once
+
+#include "core/core.hpp"
+#include "core/gfx/block_allocator.hpp"
+#include "core/gfx/buffer.hpp"
+#include "core/gfx/image.hpp"
+#include "core/utils/handle_pool.hpp"
+#include <functional>
+#include <vector>
+
+namespace luster::gfx
+{
+	class Device;
+
+	// One GpuAllocator resource: where it lives and how to recreate it for a move
+	struct GpuAllocation
+	{
+		bool isImage = false;
+		bool movable = false;
+		VkBuffer buffer = VK_NULL_HANDLE;
+		VkImage image = VK_NULL_HANDLE;
+		VkImageView view = VK_NULL_HANDLE;
+		uint32_t block = 0;
+		VkDeviceSize offset = 0;
+		VkDeviceSize size = 0; // memory requirement
+		BufferCreateInfo bufferInfo{};
+		ImageCreateInfo imageInfo{};
+	};
+
+	// Stable reference to a GpuAllocator resource: stays the same while the defragmenter moves the resource,
+	// so callers resolve the VkBuffer/VkImage when recording instead of caching it
+	using GpuResource = Handle<GpuAllocation>;
+
+	struct GpuAllocatorStats
+	{
+		uint32_t blocks = 0;
+		uint32_t resources = 0;
+		VkDeviceSize blockBytes = 0; // device memory held
+		VkDeviceSize usedBytes = 0; // suballocated, including ranges waiting for their frame to complete
+		uint64_t moves = 0; // totals since create()
+		VkDeviceSize movedBytes = 0;
+		VkDeviceSize releasedBlockBytes = 0; // blocks given back after they emptied
+	};
+
+	// Suballocates buffers and images from large device memory blocks (one vkAllocateMemory per block instead of
+	// per resource) and compacts them incrementally. planDefragment() picks the sparsest block of a pool, creates
+	// copies of its resources in free ranges of denser blocks, records the GPU copies at the start of the frame and
+	// switches the handles before anything else is recorded; old copies and their ranges are released by
+	// collect() once that frame completed, and a block that empties is freed. A byte budget per call spreads the
+	// work over several frames.
+	//
+	// Movable: DEVICE_LOCAL buffers created with `movable`, and optimal-tiling images created with a
+	// `restingLayout` (the layout they are in between frames; the copy transitions around it). Contents must be
+	// written only before the move (uploads, immutable data). Host-visible resources stay put: their mapped
+	// pointer never changes. The move listener runs right after a handle switched, to patch descriptor sets
+	// referencing the old object.
+	// Not thread-safe: render thread only.
+	class GpuAllocator
+	{
+	public:
+		static constexpr VkDeviceSize kDefaultBlockSize = 64ull << 20;
+		static constexpr double kSparseBlockUsage = 0.5; // blocks filled below this are compaction sources
+		using MoveListener = std::function<void(GpuResource)>;
+
+		GpuAllocator() = default;
+		~GpuAllocator() = default;
+
+		void create(const Device& device, VkDeviceSize blockSize = kDefaultBlockSize);
+		void cleanup(const Device& device);
+
+		GpuResource createBuffer(const BufferCreateInfo& info);
+		GpuResource createImage(const ImageCreateInfo& info);
+		// Released once `frame` completed (0: the GPU no longer uses it)
+		void destroy(GpuResource resource, uint64_t frame = 0);
+		// Host-visible: memcpy; device-local: staging buffer + immediate submit (load time only)
+		void upload(GpuResource buffer, const void* data, VkDeviceSize size);
+
+		bool alive(GpuResource resource) const;
+		VkBuffer buffer(GpuResource resource) const;
+		VkImage image(GpuResource resource) const;
+		VkImageView view(GpuResource resource) const;
+		void* mapped(GpuResource resource) const; // host-visible only, else nullptr
+
+		void setMoveListener(MoveListener listener) { moveListener_ = std::move(listener); }
+		// Picks up to `byteBudget` bytes of moves and creates their new copies; returns the bytes planned (0: no
+		// work this frame, nothing to record). Must be followed by recordDefragment() in the same frame.
+		VkDeviceSize planDefragment(VkDeviceSize byteBudget);
+		// Records the planned moves into `cmd`, which must be the graphics command buffer of `frame` before any
+		// use of these resources, and switches the handles; returns the bytes moved
+		VkDeviceSize recordDefragment(VkCommandBuffer cmd, uint64_t frame);
+		// Releases objects and ranges retired in frames <= completedFrame, and blocks left empty
+		void collect(uint64_t completedFrame);
+
+		GpuAllocatorStats stats() const;
+
+	private:
+		struct Block
+		{
+			DeviceAllocation allocation{};
+			BlockAllocator ranges{};
+			void* mapped = nullptr; // whole block, host-visible types
+			uint32_t pool = 0;
+		};
+		// One per memory type, category and linear/optimal (never mixed: bufferImageGranularity)
+		struct Pool
+		{
+			uint32_t memoryType = 0;
+			MemoryCategory category = MemoryCategory::Other;
+			bool optimal = false;
+			VkMemoryPropertyFlags properties = 0;
+			std::vector<uint32_t> blocks{};
+		};
+		using Slot = GpuAllocation;
+		struct Placement
+		{
+			uint32_t block = 0;
+			VkDeviceSize offset = 0;
+		};
+		struct Move
+		{
+			GpuResource resource{};
+			VkBuffer buffer = VK_NULL_HANDLE;
+			VkImage image = VK_NULL_HANDLE;
+			VkImageView view = VK_NULL_HANDLE;
+			Placement to{};
+		};
+		struct Retired
+		{
+			uint64_t frame = 0;
+			VkBuffer buffer = VK_NULL_HANDLE;
+			VkImage image = VK_NULL_HANDLE;
+			VkImageView view = VK_NULL_HANDLE;
+			uint32_t block = 0;
+			VkDeviceSize offset = 0;
+			VkDeviceSize size = 0;
+		};
+
+		const Slot* resolve(GpuResource resource) const { return slots_.get(resource); }
+		VkBuffer makeBuffer(const BufferCreateInfo& info) const;
+		VkImage makeImage(const ImageCreateInfo& info) const;
+		VkImageView makeView(VkImage image, const ImageCreateInfo& info) const;
+		uint32_t poolFor(const VkMemoryRequirements& req, VkMemoryPropertyFlags properties, MemoryCategory category,
+		                 bool optimal);
+		// Densest block of the pool with room first, so sparse blocks drain; `exclude` is skipped
+		bool tryPlace(uint32_t pool, const VkMemoryRequirements& req, uint32_t exclude, Placement& out);
+		Placement place(uint32_t pool, const VkMemoryRequirements& req);
+		void releaseBlock(uint32_t block);
+
+		const Device* device_ = nullptr;
+		VkDeviceSize blockSize_ = kDefaultBlockSize;
+		std::vector<Block> blocks_{};
+		std::vector<uint32_t> freeBlocks_{};
+		std::vector<Pool> pools_{};
+		HandlePool<GpuAllocation> slots_{};
+		std::vector<Retired> retired_{};
+		std::vector<Move> pending_{}; // planDefragment() -> recordDefragment()
+		MoveListener moveListener_{};
+		uint64_t moves_ = 0;
+		VkDeviceSize movedBytes_ = 0;
+		VkDeviceSize releasedBlockBytes_ = 0;
+	};
+}
@@ -1,72 +1,362 @@
 #include "core/gfx/gpu_profiler.hpp"
 #include "core/gfx/device.hpp"
 #include "core/gfx/command_context.hpp"
+#include "core/utils/log.hpp"
+#include "core/utils/profiler.hpp"
+#include <algorithm>
 
 namespace luster::gfx
 {
+	namespace
+	{
+		// Result order follows bit order, matching the PipelineStatistics field order
+		constexpr VkQueryPipelineStatisticFlags kStatFlags =
+			VK_QUERY_PIPELINE_STATISTIC_INPUT_ASSEMBLY_VERTICES_BIT |
+			VK_QUERY_PIPELINE_STATISTIC_INPUT_ASSEMBLY_PRIMITIVES_BIT |
+			VK_QUERY_PIPELINE_STATISTIC_VERTEX_SHADER_INVOCATIONS_BIT |
+			VK_QUERY_PIPELINE_STATISTIC_CLIPPING_INVOCATIONS_BIT |
+			VK_QUERY_PIPELINE_STATISTIC_CLIPPING_PRIMITIVES_BIT |
+			VK_QUERY_PIPELINE_STATISTIC_FRAGMENT_SHADER_INVOCATIONS_BIT |
+			VK_QUERY_PIPELINE_STATISTIC_COMPUTE_SHADER_INVOCATIONS_BIT;
+
+		double counterValue(const VkPerformanceCounterResultKHR& r, VkPerformanceCounterStorageKHR storage)
+		{
+			switch (storage)
+			{
+			case VK_PERFORMANCE_COUNTER_STORAGE_INT32_KHR: return static_cast<double>(r.int32);
+			case VK_PERFORMANCE_COUNTER_STORAGE_INT64_KHR: return static_cast<double>(r.int64);
+			case VK_PERFORMANCE_COUNTER_STORAGE_UINT32_KHR: return static_cast<double>(r.uint32);
+			case VK_PERFORMANCE_COUNTER_STORAGE_UINT64_KHR: return static_cast<double>(r.uint64);
+			case VK_PERFORMANCE_COUNTER_STORAGE_FLOAT32_KHR: return static_cast<double>(r.float32);
+			case VK_PERFORMANCE_COUNTER_STORAGE_FLOAT64_KHR: return r.float64;
+			default: return 0.0;
+			}
+		}
+	}
+
 	void GpuProfiler::init(const Device& device)
 	{
 		if (queryPool_) return;
 		VkQueryPoolCreateInfo qpci{VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO};
 		qpci.queryType = VK_QUERY_TYPE_TIMESTAMP;
-		qpci.queryCount = 2;
-		vkCreateQueryPool(device.logical(), &qpci, nullptr, &queryPool_);
+		qpci.queryCount = kQueriesPerFrame * kFrameLatency;
+		if (device.vk().CreateQueryPool(device.logical(), &qpci, nullptr, &queryPool_) != VK_SUCCESS)
+			queryPool_ = VK_NULL_HANDLE;
+
+		if (queryPool_ && device.pipelineStatisticsEnabled())
+		{
+			VkQueryPoolCreateInfo sci{VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO};
+			sci.queryType = VK_QUERY_TYPE_PIPELINE_STATISTICS;
+			sci.queryCount = kMaxStatScopesPerFrame * kFrameLatency;
+			sci.pipelineStatistics = kStatFlags;
+			if (device.vk().CreateQueryPool(device.logical(), &sci, nullptr, &statsPool_) != VK_SUCCESS)
+				statsPool_ = VK_NULL_HANDLE;
+			statsReadback_.resize(static_cast<size_t>(kMaxStatScopesPerFrame) * (kStatCount + 1));
+		}
+		if (queryPool_ && device.performanceQueryEnabled()) initPerformanceQuery(device);
+
+		for (auto& slot : slots_) slot.scopes.reserve(kMaxScopesPerFrame);
+		openScopes_.reserve(16);
+		readback_.resize(static_cast<size_t>(kQueriesPerFrame) * 2);
+		latest_.scopes.reserve(kMaxScopesPerFrame);
+		if (track_ == ~0u) track_ = Profiler::createTrack("GPU");
+		Profiler::ticksPerNanosecond(); // start the calibration interval
+	}
+
+	void GpuProfiler::initPerformanceQuery(const Device& device)
+	{
+		auto enumerateCounters = reinterpret_cast<PFN_vkEnumeratePhysicalDeviceQueueFamilyPerformanceQueryCountersKHR>(
+			vkGetInstanceProcAddr(device.instance(), "vkEnumeratePhysicalDeviceQueueFamilyPerformanceQueryCountersKHR"));
+		auto getPasses = reinterpret_cast<PFN_vkGetPhysicalDeviceQueueFamilyPerformanceQueryPassesKHR>(
+			vkGetInstanceProcAddr(device.instance(), "vkGetPhysicalDeviceQueueFamilyPerformanceQueryPassesKHR"));
+		const auto acquireLock = device.vk().AcquireProfilingLockKHR;
+		if (!enumerateCounters || !getPasses || !acquireLock) return;
+
+		const uint32_t family = device.gfxQueueFamily();
+		uint32_t count = 0;
+		enumerateCounters(device.physical(), family, &count, nullptr, nullptr);
+		std::vector<VkPerformanceCounterKHR> counters(count, {VK_STRUCTURE_TYPE_PERFORMANCE_COUNTER_KHR});
+		std::vector<VkPerformanceCounterDescriptionKHR> descs(count, {VK_STRUCTURE_TYPE_PERFORMANCE_COUNTER_DESCRIPTION_KHR});
+		enumerateCounters(device.physical(), family, &count, counters.data(), descs.data());
+
+		// Greedily keep counters while the set still fits in a single submission pass. Only COMMAND-scope counters:
+		// render-pass-scoped ones cannot wrap render passes, and command-buffer-scoped ones require the query to be
+		// the very first command, which the frame does not guarantee (upload barriers, defrag copies, queue
+		// ownership acquires may come first)
+		std::vector<uint32_t> selected;
+		uint32_t skippedScope = 0;
+		for (uint32_t i = 0; i < count && selected.size() < kMaxCounters; ++i)
+		{
+			if (counters[i].scope != VK_PERFORMANCE_COUNTER_SCOPE_COMMAND_KHR)
+			{
+				++skippedScope;
+				continue;
+			}
+			selected.push_back(i);
+			VkQueryPoolPerformanceCreateInfoKHR pci{VK_STRUCTURE_TYPE_QUERY_POOL_PERFORMANCE_CREATE_INFO_KHR};
+			pci.queueFamilyIndex = family;
+			pci.counterIndexCount = static_cast<uint32_t>(selected.size());
+			pci.pCounterIndices = selected.data();
+			uint32_t passes = 0;
+			getPasses(device.physical(), &pci, &passes);
+			if (passes != 1) selected.pop_back();
+		}
+		if (skippedScope)
+			spdlog::info("GpuProfiler: skipped {} render-pass/command-buffer scoped performance counters", skippedScope);
+		if (selected.empty()) return;
+
+		VkQueryPoolPerformanceCreateInfoKHR pci{VK_STRUCTURE_TYPE_QUERY_POOL_PERFORMANCE_CREATE_INFO_KHR};
+		pci.queueFamilyIndex = family;
+		pci.counterIndexCount = static_cast<uint32_t>(selected.size());
+		pci.pCounterIndices = selected.data();
+		VkQueryPoolCreateInfo qpci{VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO};
+		qpci.pNext = &pci;
+		qpci.queryType = VK_QUERY_TYPE_PERFORMANCE_QUERY_KHR;
+		qpci.queryCount = kFrameLatency;
+		if (device.vk().CreateQueryPool(device.logical(), &qpci, nullptr, &perfPool_) != VK_SUCCESS)
+		{
+			perfPool_ = VK_NULL_HANDLE;
+			return;
+		}
+
+		// Held for the profiler's lifetime: it must cover recording and submission of every frame
+		VkAcquireProfilingLockInfoKHR lock{VK_STRUCTURE_TYPE_ACQUIRE_PROFILING_LOCK_INFO_KHR};
+		lock.timeout = 0;
+		if (acquireLock(device.logical(), &lock) != VK_SUCCESS)
+		{
+			spdlog::warn("GpuProfiler: profiling lock unavailable, performance counters disabled");
+			device.vk().DestroyQueryPool(device.logical(), perfPool_, nullptr);
+			perfPool_ = VK_NULL_HANDLE;
+			return;
+		}
+		profilingLockHeld_ = true;
+
+		for (uint32_t i : selected)
+		{
+			counterNames_.emplace_back(descs[i].name);
+			counterStorage_.push_back(counters[i].storage);
+		}
+		perfReadback_.resize(selected.size());
+		latest_.counters.reserve(selected.size());
+		for (uint32_t q = 0; q < kFrameLatency; ++q) device.vk().ResetQueryPool(device.logical(), perfPool_, q, 1);
+		spdlog::info("GpuProfiler: sampling {} performance counters", counterNames_.size());
 	}
 
 	void GpuProfiler::cleanup(const Device& device)
 	{
-		if (queryPool_)
+		for (VkQueryPool* pool : {&queryPool_, &statsPool_, &perfPool_})
 		{
-			vkDestroyQueryPool(device.logical(), queryPool_, nullptr);
-			queryPool_ = VK_NULL_HANDLE;
+			if (*pool) device.vk().DestroyQueryPool(device.logical(), *pool, nullptr);
+			*pool = VK_NULL_HANDLE;
+		}
+		if (profilingLockHeld_)
+		{
+			if (device.vk().ReleaseProfilingLockKHR) device.vk().ReleaseProfilingLockKHR(device.logical());
+			profilingLockHeld_ = false;
 		}
+		counterNames_.clear();
+		counterStorage_.clear();
+		perfReadback_.clear();
+		slots_ = {};
+		openScopes_.clear();
+		inFrame_ = false;
 	}
 
 	void GpuProfiler::beginFrame(CommandContext& ctx)
 	{
 		if (!queryPool_) return;
-		vkCmdResetQueryPool(ctx.cmdBuf_, queryPool_, 0, 2);
-		vkCmdWriteTimestamp(ctx.cmdBuf_, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, queryPool_, 0);
+		current_ = static_cast<uint32_t>(frameCounter_ % kFrameLatency);
+		FrameSlot& slot = slots_[current_];
+		// An unread slot here means its frame was never submitted or never resolved: drop it
+		if (perfPool_ && slot.frameIndex != 0) ctx.vk_->ResetQueryPool(ctx.device_, perfPool_, current_, 1);
+		slot.scopes.clear();
+		slot.queryCount = 2;
+		slot.statsCount = 0;
+		slot.frameIndex = ++frameCounter_;
+		slot.submitted = false;
+
+		if (perfPool_) ctx.vk_->CmdBeginQuery(ctx.cmdBuf_, perfPool_, current_, 0);
+		const uint32_t base = current_ * kQueriesPerFrame;
+		ctx.vk_->CmdResetQueryPool(ctx.cmdBuf_, queryPool_, base, kQueriesPerFrame);
+		if (statsPool_)
+			ctx.vk_->CmdResetQueryPool(ctx.cmdBuf_, statsPool_, current_ * kMaxStatScopesPerFrame, kMaxStatScopesPerFrame);
+		ctx.vk_->CmdWriteTimestamp(ctx.cmdBuf_, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, queryPool_, base);
+		openScopes_.clear();
+		inFrame_ = true;
 	}
 
 	void GpuProfiler::endFrame(CommandContext& ctx)
+	{
+		if (!inFrame_) return;
+		while (!openScopes_.empty()) endScope(ctx);
+		ctx.vk_->CmdWriteTimestamp(ctx.cmdBuf_, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, queryPool_,
+		                    current_ * kQueriesPerFrame + 1);
+		if (perfPool_) ctx.vk_->CmdEndQuery(ctx.cmdBuf_, perfPool_, current_);
+		inFrame_ = false;
+	}
+
+	void GpuProfiler::beginScope(CommandContext& ctx, const char* name, const ColorRGBA& color)
+	{
+		beginLabel(ctx, name, color);
+		FrameSlot& slot = slots_[current_];
+		if (!inFrame_ || slot.queryCount + 2 > kQueriesPerFrame)
+		{
+			openScopes_.push_back({kNoQuery, kNoQuery});
+			return;
+		}
+		const uint32_t depth = static_cast<uint32_t>(openScopes_.size());
+		const uint32_t query = slot.queryCount;
+		slot.queryCount += 2;
+		// Statistics queries of one pool cannot nest, so only top-level scopes get one
+		uint32_t statsQuery = kNoQuery;
+		if (statsPool_ && depth == 0 && slot.statsCount < kMaxStatScopesPerFrame)
+		{
+			statsQuery = slot.statsCount++;
+			ctx.vk_->CmdBeginQuery(ctx.cmdBuf_, statsPool_, current_ * kMaxStatScopesPerFrame + statsQuery, 0);
+		}
+		slot.scopes.push_back({name, depth, query, statsQuery});
+		openScopes_.push_back({query, statsQuery});
+		ctx.vk_->CmdWriteTimestamp(ctx.cmdBuf_, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, queryPool_,
+		                    current_ * kQueriesPerFrame + query);
+	}
+
+	void GpuProfiler::endScope(CommandContext& ctx)
+	{
+		if (openScopes_.empty()) return;
+		const OpenScope scope = openScopes_.back();
+		openScopes_.pop_back();
+		if (scope.query != kNoQuery)
+			ctx.vk_->CmdWriteTimestamp(ctx.cmdBuf_, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, queryPool_,
+			                    current_ * kQueriesPerFrame + scope.query + 1);
+		if (scope.statsQuery != kNoQuery)
+			ctx.vk_->CmdEndQuery(ctx.cmdBuf_, statsPool_, current_ * kMaxStatScopesPerFrame + scope.statsQuery);
+		endLabel(ctx);
+	}
+
+	void GpuProfiler::onSubmitted()
 	{
 		if (!queryPool_) return;
-		vkCmdWriteTimestamp(ctx.cmdBuf_, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, queryPool_, 1);
+		FrameSlot& slot = slots_[current_];
+		slot.submitted = true;
+		slot.submitTicks = Profiler::nowTicks();
+	}
+
+	bool GpuProfiler::readSlot(const Device& device, uint32_t slotIndex)
+	{
+		const FrameSlot& slot = slots_[slotIndex];
+		// No WAIT_BIT anywhere: unfinished frames report unavailable and are retried on the next collect
+		VkResult qr = device.vk().GetQueryPoolResults(
+			device.logical(), queryPool_, slotIndex * kQueriesPerFrame, slot.queryCount,
+			slot.queryCount * 2 * sizeof(uint64_t), readback_.data(), 2 * sizeof(uint64_t),
+			VK_QUERY_RESULT_64_BIT | VK_QUERY_RESULT_WITH_AVAILABILITY_BIT);
+		if (qr != VK_SUCCESS && qr != VK_NOT_READY) return false;
+		for (uint32_t q = 0; q < slot.queryCount; ++q)
+			if (readback_[q * 2 + 1] == 0) return false;
+
+		if (slot.statsCount > 0)
+		{
+			constexpr uint32_t stride = (kStatCount + 1) * sizeof(uint64_t);
+			qr = device.vk().GetQueryPoolResults(device.logical(), statsPool_, slotIndex * kMaxStatScopesPerFrame,
+			                           slot.statsCount, slot.statsCount * stride, statsReadback_.data(), stride,
+			                           VK_QUERY_RESULT_64_BIT | VK_QUERY_RESULT_WITH_AVAILABILITY_BIT);
+			if (qr != VK_SUCCESS && qr != VK_NOT_READY) return false;
+			for (uint32_t q = 0; q < slot.statsCount; ++q)
+				if (statsReadback_[q * (kStatCount + 1) + kStatCount] == 0) return false;
+		}
+
+		if (perfPool_)
+		{
+			// Performance queries don't support WITH_AVAILABILITY; NOT_READY means "try again later"
+			const size_t size = perfReadback_.size() * sizeof(VkPerformanceCounterResultKHR);
+			qr = device.vk().GetQueryPoolResults(device.logical(), perfPool_, slotIndex, 1, size, perfReadback_.data(), size, 0);
+			if (qr == VK_NOT_READY) return false;
+			if (qr != VK_SUCCESS) std::fill(perfReadback_.begin(), perfReadback_.end(), VkPerformanceCounterResultKHR{});
+		}
+		return true;
 	}
 
-	bool GpuProfiler::getLastTimingMs(const Device& device, double& outMs) const
+	bool GpuProfiler::collect(const Device& device)
 	{
 		if (!queryPool_) return false;
-		uint64_t data[2] = {0, 0};
-		VkResult qr = vkGetQueryPoolResults(device.logical(), queryPool_, 0, 2, sizeof(data), data, sizeof(uint64_t),
-		                                    VK_QUERY_RESULT_64_BIT | VK_QUERY_RESULT_WAIT_BIT);
-		if (qr != VK_SUCCESS || data[1] <= data[0]) return false;
-		const double ticks = static_cast<double>(data[1] - data[0]);
-		const double ns = ticks * static_cast<double>(device.timestampPeriod());
-		outMs = ns / 1.0e6;
+		const uint64_t before = latest_.frameIndex;
+		const double nsPerTick = static_cast<double>(device.timestampPeriod());
+		for (uint32_t i = 0; i < kFrameLatency; ++i)
+		{
+			FrameSlot& slot = slots_[i];
+			if (!slot.submitted || !readSlot(device, i)) continue;
+			slot.submitted = false;
+			if (slot.frameIndex > latest_.frameIndex) resolve(slot, nsPerTick);
+		}
+		return latest_.frameIndex != before;
+	}
+
+	void GpuProfiler::resolve(FrameSlot& slot, double nsPerTick)
+	{
+		const uint64_t frameBegin = readback_[0];
+		auto toMs = [&](uint64_t a, uint64_t b) { return b > a ? static_cast<double>(b - a) * nsPerTick / 1.0e6 : 0.0; };
+
+		latest_.frameIndex = slot.frameIndex;
+		latest_.totalMs = toMs(frameBegin, readback_[2]);
+		latest_.scopes.clear();
+		for (const auto& s : slot.scopes)
+		{
+			const uint64_t b = readback_[s.beginQuery * 2];
+			const uint64_t e = readback_[(s.beginQuery + 1) * 2];
+			GpuScopeTiming t{s.name, s.depth, toMs(frameBegin, b), toMs(b, e)};
+			if (s.statsQuery != kNoQuery)
+			{
+				const uint64_t* v = statsReadback_.data() + s.statsQuery * (kStatCount + 1);
+				t.hasStats = true;
+				t.stats = {v[0], v[1], v[2], v[3], v[4], v[5], v[6]};
+			}
+			latest_.scopes.push_back(t);
+		}
+		latest_.counters.clear();
+		for (size_t i = 0; i < perfReadback_.size(); ++i)
+			latest_.counters.push_back(counterValue(perfReadback_[i], counterStorage_[i]));
+
+		if (!Profiler::isCapturing()) return;
+		// No calibrated timestamps: the GPU frame is placed at its CPU submit time, which is close
+		// enough to read pass proportions and overlap against CPU zones
+		const double ticksPerMs = Profiler::ticksPerNanosecond() * 1.0e6;
+		auto toTicks = [&](double ms) { return slot.submitTicks + static_cast<uint64_t>(ms * ticksPerMs); };
+		Profiler::recordOnTrack(track_, "GPU frame", Profiler::EventType::Begin, slot.submitTicks);
+		uint32_t open = 0;
+		std::array<double, kMaxScopesPerFrame> openEnds{};
+		for (const auto& t : latest_.scopes)
+		{
+			for (; open > t.depth; --open)
+				Profiler::recordOnTrack(track_, nullptr, Profiler::EventType::End, toTicks(openEnds[open - 1]));
+			Profiler::recordOnTrack(track_, t.name, Profiler::EventType::Begin, toTicks(t.startMs));
+			openEnds[open++] = t.startMs + t.durationMs;
+		}
+		for (; open > 0; --open)
+			Profiler::recordOnTrack(track_, nullptr, Profiler::EventType::End, toTicks(openEnds[open - 1]));
+		Profiler::recordOnTrack(track_, nullptr, Profiler::EventType::End, toTicks(latest_.totalMs));
+	}
+
+	bool GpuProfiler::getLastTimingMs(double& outMs) const
+	{
+		if (latest_.frameIndex == 0) return false;
+		outMs = latest_.totalMs;
 		return true;
 	}
 
 	void GpuProfiler::beginLabel(CommandContext& ctx, const char* name, const ColorRGBA& color)
 	{
-		auto pfn = reinterpret_cast<PFN_vkCmdBeginDebugUtilsLabelEXT>(vkGetDeviceProcAddr(
-			ctx.device_, "vkCmdBeginDebugUtilsLabelEXT"));
-		if (!pfn) return;
+		if (!ctx.vk_ || !ctx.vk_->CmdBeginDebugUtilsLabelEXT) return;
 		VkDebugUtilsLabelEXT label{VK_STRUCTURE_TYPE_DEBUG_UTILS_LABEL_EXT};
 		label.pLabelName = name;
 		label.color[0] = color.r;
 		label.color[1] = color.g;
 		label.color[2] = color.b;
 		label.color[3] = color.a;
-		pfn(ctx.cmdBuf_, &label);
+		ctx.vk_->CmdBeginDebugUtilsLabelEXT(ctx.cmdBuf_, &label);
 	}
 
 	void GpuProfiler::endLabel(CommandContext& ctx)
 	{
-		auto pfn = reinterpret_cast<PFN_vkCmdEndDebugUtilsLabelEXT>(vkGetDeviceProcAddr(
-			ctx.device_, "vkCmdEndDebugUtilsLabelEXT"));
-		if (!pfn) return;
-		pfn(ctx.cmdBuf_);
+		if (!ctx.vk_ || !ctx.vk_->CmdEndDebugUtilsLabelEXT) return;
+		ctx.vk_->CmdEndDebugUtilsLabelEXT(ctx.cmdBuf_);
 	}
 }
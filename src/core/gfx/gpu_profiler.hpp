@@ -1,35 +1,127 @@
 #pragma once
 
 #include "core/core.hpp"
+#include "core/frame_stats.hpp"
 #include "core/types.hpp"
+#include <array>
+#include <string>
+#include <vector>
 
 namespace luster::gfx
 {
 	class Device;
 	class CommandContext;
 
+	struct GpuScopeTiming
+	{
+		const char* name = ""; // static string literal
+		uint32_t depth = 0; // 0 = top-level pass
+		double startMs = 0.0; // relative to the frame's first timestamp
+		double durationMs = 0.0;
+		bool hasStats = false;
+		PipelineStatistics stats{};
+	};
+
+	struct GpuFrameTimings
+	{
+		uint64_t frameIndex = 0; // 0 = nothing resolved yet
+		double totalMs = 0.0;
+		std::vector<GpuScopeTiming> scopes{}; // in begin order
+		std::vector<double> counters{}; // parallel to GpuProfiler::counterNames()
+	};
+
+	// Timestamp profiler with nested named scopes (each scope is also a debug-utils label).
+	// Query ranges are ring-buffered over kFrameLatency frames and read back without waiting, so results
+	// trail the CPU by one or two frames. Resolved scopes are mirrored onto a "GPU" CPU-profiler track.
+	// Top-level scopes also collect pipeline statistics, and whole frames collect VK_KHR_performance_query
+	// counters, when the device enabled them.
 	class GpuProfiler
 	{
 	public:
+		static constexpr uint32_t kFrameLatency = 3;
+		static constexpr uint32_t kMaxScopesPerFrame = 63; // + 1 pair for the frame itself
+		static constexpr uint32_t kMaxStatScopesPerFrame = 16;
+		static constexpr uint32_t kMaxCounters = 32;
+
 		GpuProfiler() = default;
 		~GpuProfiler() = default;
 
 		void init(const Device& device);
 		void cleanup(const Device& device);
 
+		// Must be the first command of the frame's command buffer, outside a render pass.
+		// The frame that last used this ring slot must have completed (the renderer waits its fence first).
 		void beginFrame(CommandContext& ctx);
 		void endFrame(CommandContext& ctx);
 
-		// Returns true if timing is available and writes milliseconds into outMs
-		bool getLastTimingMs(const Device& device, double& outMs) const;
+		// Scopes nest; `name` must outlive the readback (string literal). Excess scopes keep only their label.
+		// A top-level scope must begin and end on the same side of a render pass boundary.
+		void beginScope(CommandContext& ctx, const char* name, const ColorRGBA& color = {0.2f, 0.6f, 0.9f, 1.0f});
+		void endScope(CommandContext& ctx);
+
+		// Call after the frame recorded since beginFrame() was submitted
+		void onSubmitted();
+		// Resolves every finished frame without blocking; true if a newer frame became available
+		bool collect(const Device& device);
+		const GpuFrameTimings& latest() const { return latest_; }
+		// Performance counters being sampled (empty without VK_KHR_performance_query)
+		const std::vector<std::string>& counterNames() const { return counterNames_; }
+
+		// Total GPU time of the latest resolved frame
+		bool getLastTimingMs(double& outMs) const;
 
 		// Debug label helpers (no-op if extension not present)
 		void beginLabel(CommandContext& ctx, const char* name, const ColorRGBA& color = {0.2f, 0.6f, 0.9f, 1.0f});
 		void endLabel(CommandContext& ctx);
 
 	private:
+		static constexpr uint32_t kQueriesPerFrame = (kMaxScopesPerFrame + 1) * 2;
+		static constexpr uint32_t kStatCount = 7; // fields of PipelineStatistics
+		static constexpr uint32_t kNoQuery = ~0u;
+
+		struct ScopeRecord
+		{
+			const char* name;
+			uint32_t depth;
+			uint32_t beginQuery; // end query is beginQuery + 1
+			uint32_t statsQuery; // kNoQuery when not collected
+		};
+
+		struct OpenScope
+		{
+			uint32_t query;
+			uint32_t statsQuery;
+		};
+
+		struct FrameSlot
+		{
+			std::vector<ScopeRecord> scopes{};
+			uint32_t queryCount = 0;
+			uint32_t statsCount = 0;
+			uint64_t frameIndex = 0;
+			uint64_t submitTicks = 0; // CPU profiler ticks at submit, anchors the GPU track
+			bool submitted = false;
+		};
+
+		void initPerformanceQuery(const Device& device);
+		bool readSlot(const Device& device, uint32_t slotIndex);
+		void resolve(FrameSlot& slot, double nsPerTick);
+
 		VkQueryPool queryPool_ = VK_NULL_HANDLE;
-		mutable uint64_t lastBegin_ = 0;
-		mutable uint64_t lastEnd_ = 0;
+		VkQueryPool statsPool_ = VK_NULL_HANDLE;
+		VkQueryPool perfPool_ = VK_NULL_HANDLE; // one query per ring slot
+		bool profilingLockHeld_ = false;
+		std::array<FrameSlot, kFrameLatency> slots_{};
+		uint32_t current_ = 0;
+		uint64_t frameCounter_ = 0;
+		bool inFrame_ = false;
+		std::vector<OpenScope> openScopes_{};
+		std::vector<uint64_t> readback_{}; // timestamps: {value, availability} pairs
+		std::vector<uint64_t> statsReadback_{}; // kStatCount values + availability per query
+		std::vector<VkPerformanceCounterResultKHR> perfReadback_{};
+		std::vector<VkPerformanceCounterStorageKHR> counterStorage_{};
+		std::vector<std::string> counterNames_{};
+		GpuFrameTimings latest_{};
+		uint32_t track_ = ~0u;
 	};
 }
@@ -1,21 +1,10 @@
 #include "core/gfx/image.hpp"
 #include "core/gfx/device.hpp"
+#include "core/gfx/gpu_allocator.hpp"
 #include <stdexcept>
 
 namespace luster::gfx
 {
-	static uint32_t findMemoryType(VkPhysicalDevice gpu, uint32_t typeFilter, VkMemoryPropertyFlags properties)
-	{
-		VkPhysicalDeviceMemoryProperties memProps{};
-		vkGetPhysicalDeviceMemoryProperties(gpu, &memProps);
-		for (uint32_t i = 0; i < memProps.memoryTypeCount; ++i)
-		{
-			if ((typeFilter & (1u << i)) && (memProps.memoryTypes[i].propertyFlags & properties) == properties)
-				return i;
-		}
-		throw std::runtime_error("Failed to find suitable memory type");
-	}
-
 	void Image::create(const Device& device, const ImageCreateInfo& info)
 	{
 		cleanup(device);
@@ -34,18 +23,14 @@ namespace luster::gfx
 		ici.usage = info.usage;
 		ici.samples = VK_SAMPLE_COUNT_1_BIT;
 		ici.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
-		VkResult r = vkCreateImage(device.logical(), &ici, nullptr, &image_);
+		VkResult r = device.vk().CreateImage(device.logical(), &ici, nullptr, &image_);
 		if (r != VK_SUCCESS) throw std::runtime_error("vkCreateImage failed");
 
 		VkMemoryRequirements req{};
-		vkGetImageMemoryRequirements(device.logical(), image_, &req);
+		device.vk().GetImageMemoryRequirements(device.logical(), image_, &req);
 
-		VkMemoryAllocateInfo ai{VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO};
-		ai.allocationSize = req.size;
-		ai.memoryTypeIndex = findMemoryType(device.physical(), req.memoryTypeBits, info.properties);
-		r = vkAllocateMemory(device.logical(), &ai, nullptr, &memory_);
-		if (r != VK_SUCCESS) throw std::runtime_error("vkAllocateMemory failed");
-		vkBindImageMemory(device.logical(), image_, memory_, 0);
+		allocation_ = device.allocateMemory(req, info.properties, info.category);
+		device.vk().BindImageMemory(device.logical(), image_, allocation_.memory, 0);
 
 		VkImageViewCreateInfo vi{VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO};
 		vi.image = image_;
@@ -56,17 +41,43 @@ namespace luster::gfx
 		vi.subresourceRange.levelCount = 1;
 		vi.subresourceRange.baseArrayLayer = 0;
 		vi.subresourceRange.layerCount = 1;
-		r = vkCreateImageView(device.logical(), &vi, nullptr, &view_);
+		r = device.vk().CreateImageView(device.logical(), &vi, nullptr, &view_);
 		if (r != VK_SUCCESS) throw std::runtime_error("vkCreateImageView failed");
 	}
 
+	void Image::create(GpuAllocator& allocator, const ImageCreateInfo& info)
+	{
+		if (allocator_) allocator_->destroy(resource_);
+		resource_ = allocator.createImage(info);
+		allocator_ = &allocator;
+		width_ = info.width;
+		height_ = info.height;
+		format_ = info.format;
+	}
+
+	VkImage Image::image() const
+	{
+		return allocator_ ? allocator_->image(resource_) : image_;
+	}
+
+	VkImageView Image::view() const
+	{
+		return allocator_ ? allocator_->view(resource_) : view_;
+	}
+
 	void Image::cleanup(const Device& device)
 	{
-		if (view_) vkDestroyImageView(device.logical(), view_, nullptr);
-		if (memory_) vkFreeMemory(device.logical(), memory_, nullptr);
-		if (image_) vkDestroyImage(device.logical(), image_, nullptr);
+		if (allocator_)
+		{
+			// Released at the allocator's next collect(): callers destroy only once the GPU is done with it
+			allocator_->destroy(resource_);
+			allocator_ = nullptr;
+			resource_ = {};
+		}
+		if (view_) device.vk().DestroyImageView(device.logical(), view_, nullptr);
+		device.freeMemory(allocation_);
+		if (image_) device.vk().DestroyImage(device.logical(), image_, nullptr);
 		image_ = VK_NULL_HANDLE;
-		memory_ = VK_NULL_HANDLE;
 		view_ = VK_NULL_HANDLE;
 		width_ = height_ = 0;
 		format_ = VK_FORMAT_UNDEFINED;
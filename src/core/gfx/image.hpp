@@ -1,10 +1,14 @@
 #pragma once
 
 #include "core/core.hpp"
+#include "core/gfx/memory_budget.hpp"
+#include "core/utils/handle_pool.hpp"
 
 namespace luster::gfx
 {
 	class Device;
+	class GpuAllocator;
+	struct GpuAllocation;
 
 	struct ImageCreateInfo
 	{
@@ -15,6 +19,9 @@ namespace luster::gfx
 		VkMemoryPropertyFlags properties = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
 		VkImageTiling tiling = VK_IMAGE_TILING_OPTIMAL;
 		VkImageAspectFlags aspect = VK_IMAGE_ASPECT_COLOR_BIT;
+		MemoryCategory category = MemoryCategory::Texture; // MemoryBudget accounting
+		// GpuAllocator only: the layout the image is in between frames; set it to let the defragmenter move it
+		VkImageLayout restingLayout = VK_IMAGE_LAYOUT_UNDEFINED;
 	};
 
 	class Image
@@ -24,17 +31,22 @@ namespace luster::gfx
 		~Image() = default;
 
 		void create(const Device& device, const ImageCreateInfo& info);
+		// Suballocated from `allocator`, which must outlive the image
+		void create(GpuAllocator& allocator, const ImageCreateInfo& info);
 		void cleanup(const Device& device);
 
-		VkImage image() const { return image_; }
-		VkImageView view() const { return view_; }
+		// Allocator-backed images with a resting layout may be moved: resolve when recording, do not cache
+		VkImage image() const;
+		VkImageView view() const;
 		VkFormat format() const { return format_; }
 		uint32_t width() const { return width_; }
 		uint32_t height() const { return height_; }
 
 	private:
+		GpuAllocator* allocator_ = nullptr;
+		Handle<GpuAllocation> resource_{};
 		VkImage image_ = VK_NULL_HANDLE;
-		VkDeviceMemory memory_ = VK_NULL_HANDLE;
+		DeviceAllocation allocation_{};
 		VkImageView view_ = VK_NULL_HANDLE;
 		VkFormat format_ = VK_FORMAT_UNDEFINED;
 		uint32_t width_ = 0;
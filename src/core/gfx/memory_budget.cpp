@@ -0,0 +1,280 @@
+#include "core/gfx/memory_budget.hpp"
+#include <algorithm>
+
+namespace luster::gfx
+{
+	const char* toString(MemoryCategory category)
+	{
+		switch (category)
+		{
+		case MemoryCategory::Texture: return "texture";
+		case MemoryCategory::Mesh: return "mesh";
+		case MemoryCategory::RenderTarget: return "render_target";
+		case MemoryCategory::Staging: return "staging";
+		case MemoryCategory::Uniform: return "uniform";
+		case MemoryCategory::Other: return "other";
+		}
+		return "other";
+	}
+
+	VkDeviceSize MemoryStats::deviceLocalUsage() const
+	{
+		VkDeviceSize sum = 0;
+		for (const auto& h : heaps) sum += h.deviceLocal ? h.usage : 0;
+		return sum;
+	}
+
+	VkDeviceSize MemoryStats::deviceLocalBudget() const
+	{
+		VkDeviceSize sum = 0;
+		for (const auto& h : heaps) sum += h.deviceLocal ? h.budget : 0;
+		return sum;
+	}
+
+	static size_t index(MemoryCategory c) { return static_cast<size_t>(c); }
+
+	static VkDeviceSize subtractClamped(VkDeviceSize a, VkDeviceSize b) { return a > b ? a - b : 0; }
+
+	void MemoryBudget::reset()
+	{
+		std::lock_guard lock(mutex_);
+		heaps_.clear();
+		categoryBytes_ = {};
+		categoryPending_ = {};
+		categoryAllocations_ = {};
+		categoryWarned_ = {};
+		residents_.clear();
+		freeResidents_.clear();
+		completedFrame_ = 0;
+		evictions_ = 0;
+		evictedBytes_ = 0;
+	}
+
+	void MemoryBudget::addHeap(VkDeviceSize size, bool deviceLocal)
+	{
+		std::lock_guard lock(mutex_);
+		Heap h{};
+		h.usage.size = size;
+		h.usage.budget = static_cast<VkDeviceSize>(static_cast<double>(size) * kFallbackBudgetFraction);
+		h.usage.deviceLocal = deviceLocal;
+		heaps_.push_back(h);
+	}
+
+	void MemoryBudget::setDriverBudget(uint32_t heap, VkDeviceSize budget, VkDeviceSize usage)
+	{
+		std::lock_guard lock(mutex_);
+		if (heap >= heaps_.size()) return;
+		Heap& h = heaps_[heap];
+		h.driver = true;
+		h.usage.budget = budget;
+		h.usage.usage = usage;
+	}
+
+	void MemoryBudget::setSoftBudget(MemoryCategory category, VkDeviceSize bytes)
+	{
+		std::lock_guard lock(mutex_);
+		softBudget_[index(category)] = bytes;
+		categoryWarned_[index(category)] = false;
+	}
+
+	void MemoryBudget::setCompletedFrame(uint64_t frame)
+	{
+		std::lock_guard lock(mutex_);
+		completedFrame_ = frame;
+	}
+
+	VkDeviceSize MemoryBudget::heapUsageLocked(const Heap& h) const
+	{
+		return subtractClamped(h.driver ? h.usage.usage : h.usage.tracked, h.pendingFree);
+	}
+
+	void MemoryBudget::onAllocate(uint32_t heap, MemoryCategory category, VkDeviceSize bytes)
+	{
+		std::lock_guard lock(mutex_);
+		const size_t c = index(category);
+		categoryBytes_[c] += bytes;
+		++categoryAllocations_[c];
+		if (softBudget_[c] && subtractClamped(categoryBytes_[c], categoryPending_[c]) > softBudget_[c] &&
+			!categoryWarned_[c])
+		{
+			spdlog::warn("GPU memory: {} over its soft budget ({} / {} MiB)", toString(category),
+			             categoryBytes_[c] >> 20, softBudget_[c] >> 20);
+			categoryWarned_[c] = true;
+		}
+		if (heap >= heaps_.size()) return;
+		Heap& h = heaps_[heap];
+		h.usage.tracked += bytes;
+		if (heapUsageLocked(h) > h.usage.budget && !h.warned)
+		{
+			spdlog::warn("GPU memory: heap {} over budget ({} / {} MiB)", heap, heapUsageLocked(h) >> 20,
+			             h.usage.budget >> 20);
+			h.warned = true;
+		}
+	}
+
+	void MemoryBudget::onFree(uint32_t heap, MemoryCategory category, VkDeviceSize bytes)
+	{
+		std::lock_guard lock(mutex_);
+		const size_t c = index(category);
+		categoryBytes_[c] = subtractClamped(categoryBytes_[c], bytes);
+		categoryPending_[c] = subtractClamped(categoryPending_[c], bytes);
+		if (categoryAllocations_[c]) --categoryAllocations_[c];
+		if (softBudget_[c] && categoryBytes_[c] <= softBudget_[c]) categoryWarned_[c] = false;
+		if (heap >= heaps_.size()) return;
+		Heap& h = heaps_[heap];
+		h.usage.tracked = subtractClamped(h.usage.tracked, bytes);
+		h.pendingFree = subtractClamped(h.pendingFree, bytes);
+		if (heapUsageLocked(h) <= h.usage.budget) h.warned = false;
+	}
+
+	bool MemoryBudget::wouldExceed(uint32_t heap, MemoryCategory category, VkDeviceSize bytes) const
+	{
+		std::lock_guard lock(mutex_);
+		const size_t c = index(category);
+		if (softBudget_[c] && subtractClamped(categoryBytes_[c], categoryPending_[c]) + bytes > softBudget_[c])
+			return true;
+		return heap < heaps_.size() && heapUsageLocked(heaps_[heap]) + bytes > heaps_[heap].usage.budget;
+	}
+
+	MemoryBudget::ResidentId MemoryBudget::addResident(uint32_t heap, MemoryCategory category, VkDeviceSize bytes,
+	                                                   EvictFn evict)
+	{
+		std::lock_guard lock(mutex_);
+		ResidentId id;
+		if (!freeResidents_.empty())
+		{
+			id = freeResidents_.back();
+			freeResidents_.pop_back();
+		}
+		else
+		{
+			id = static_cast<ResidentId>(residents_.size());
+			residents_.emplace_back();
+		}
+		Resident& r = residents_[id];
+		r.evict = std::move(evict);
+		r.bytes = bytes;
+		r.lastUsed = completedFrame_ + 1; // the frame being recorded may already use it
+		r.heap = heap;
+		r.category = category;
+		r.alive = true;
+		r.occupied = true;
+		return id;
+	}
+
+	void MemoryBudget::removeResident(ResidentId id)
+	{
+		std::lock_guard lock(mutex_);
+		if (id >= residents_.size() || !residents_[id].occupied) return;
+		// Evicted residents keep their slot until removed, so a stale id never hits a reused one
+		residents_[id] = {};
+		freeResidents_.push_back(id);
+	}
+
+	void MemoryBudget::touch(ResidentId id, uint64_t frame)
+	{
+		std::lock_guard lock(mutex_);
+		if (id < residents_.size()) residents_[id].lastUsed = std::max(residents_[id].lastUsed, frame);
+	}
+
+	template <typename Filter>
+	VkDeviceSize MemoryBudget::collectVictimsLocked(VkDeviceSize bytes, Filter filter, std::vector<EvictFn>& out)
+	{
+		std::vector<ResidentId> candidates;
+		for (ResidentId i = 0; i < residents_.size(); ++i)
+		{
+			const Resident& r = residents_[i];
+			if (r.alive && r.lastUsed <= completedFrame_ && filter(r)) candidates.push_back(i);
+		}
+		std::ranges::sort(candidates, [&](ResidentId a, ResidentId b)
+		{
+			return residents_[a].lastUsed < residents_[b].lastUsed;
+		});
+		VkDeviceSize freed = 0;
+		for (ResidentId id : candidates)
+		{
+			if (freed >= bytes) break;
+			Resident& r = residents_[id];
+			r.alive = false;
+			freed += r.bytes;
+			categoryPending_[index(r.category)] += r.bytes;
+			if (r.heap < heaps_.size()) heaps_[r.heap].pendingFree += r.bytes;
+			++evictions_;
+			evictedBytes_ += r.bytes;
+			out.push_back(std::move(r.evict));
+			r.evict = {};
+		}
+		return freed;
+	}
+
+	VkDeviceSize MemoryBudget::evict(uint32_t heap, VkDeviceSize bytes)
+	{
+		std::vector<EvictFn> victims;
+		VkDeviceSize freed = 0;
+		{
+			std::lock_guard lock(mutex_);
+			freed = collectVictimsLocked(bytes, [heap](const Resident& r) { return r.heap == heap; }, victims);
+		}
+		for (auto& fn : victims) if (fn) fn();
+		return freed;
+	}
+
+	VkDeviceSize MemoryBudget::enforce()
+	{
+		std::vector<EvictFn> victims;
+		VkDeviceSize freed = 0;
+		{
+			std::lock_guard lock(mutex_);
+			for (uint32_t i = 0; i < heaps_.size(); ++i)
+			{
+				const VkDeviceSize over = subtractClamped(heapUsageLocked(heaps_[i]), heaps_[i].usage.budget);
+				if (over) freed += collectVictimsLocked(over, [i](const Resident& r) { return r.heap == i; }, victims);
+			}
+			for (size_t c = 0; c < kMemoryCategoryCount; ++c)
+			{
+				if (!softBudget_[c]) continue;
+				const VkDeviceSize over = subtractClamped(subtractClamped(categoryBytes_[c], categoryPending_[c]),
+				                                          softBudget_[c]);
+				const auto category = static_cast<MemoryCategory>(c);
+				if (over)
+					freed += collectVictimsLocked(over, [category](const Resident& r) { return r.category == category; },
+					                              victims);
+			}
+		}
+		for (auto& fn : victims) if (fn) fn();
+		return freed;
+	}
+
+	MemoryStats MemoryBudget::stats() const
+	{
+		std::lock_guard lock(mutex_);
+		MemoryStats s{};
+		s.heaps.reserve(heaps_.size());
+		for (const Heap& h : heaps_)
+		{
+			s.driverBudget = s.driverBudget || h.driver;
+			MemoryHeapUsage u = h.usage;
+			if (!h.driver) u.usage = h.usage.tracked;
+			s.heaps.push_back(u);
+		}
+		s.categoryBytes = categoryBytes_;
+		s.categorySoftBudget = softBudget_;
+		s.categoryAllocations = categoryAllocations_;
+		s.evictions = evictions_;
+		s.evictedBytes = evictedBytes_;
+		return s;
+	}
+
+	void MemoryBudget::deviceLocalTotals(VkDeviceSize& usage, VkDeviceSize& budget) const
+	{
+		std::lock_guard lock(mutex_);
+		usage = 0;
+		budget = 0;
+		for (const Heap& h : heaps_)
+		{
+			if (!h.usage.deviceLocal) continue;
+			usage += h.driver ? h.usage.usage : h.usage.tracked;
+			budget += h.usage.budget;
+		}
+	}
+}
@@ -0,0 +1,135 @@
+#pragma once
+
+#include "core/core.hpp"
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <vector>
+
+namespace luster::gfx
+{
+	enum class MemoryCategory : uint8_t
+	{
+		Texture,
+		Mesh,
+		RenderTarget,
+		Staging,
+		Uniform,
+		Other,
+	};
+	inline constexpr size_t kMemoryCategoryCount = 6;
+	const char* toString(MemoryCategory category);
+
+	// One vkAllocateMemory made through Device::allocateMemory; handed back to Device::freeMemory
+	struct DeviceAllocation
+	{
+		VkDeviceMemory memory = VK_NULL_HANDLE;
+		VkDeviceSize size = 0;
+		uint32_t memoryType = 0;
+		uint32_t heap = 0;
+		MemoryCategory category = MemoryCategory::Other;
+	};
+
+	struct MemoryHeapUsage
+	{
+		VkDeviceSize size = 0;
+		VkDeviceSize budget = 0; // VK_EXT_memory_budget, else kFallbackBudgetFraction of size
+		VkDeviceSize usage = 0; // driver-reported process usage, else tracked
+		VkDeviceSize tracked = 0; // bytes allocated through Device::allocateMemory
+		bool deviceLocal = false;
+	};
+
+	struct MemoryStats
+	{
+		bool driverBudget = false; // heap budgets come from VK_EXT_memory_budget
+		std::vector<MemoryHeapUsage> heaps{};
+		std::array<VkDeviceSize, kMemoryCategoryCount> categoryBytes{};
+		std::array<VkDeviceSize, kMemoryCategoryCount> categorySoftBudget{}; // 0 = none
+		std::array<uint32_t, kMemoryCategoryCount> categoryAllocations{};
+		uint64_t evictions = 0; // total since creation
+		VkDeviceSize evictedBytes = 0;
+
+		VkDeviceSize deviceLocalUsage() const;
+		VkDeviceSize deviceLocalBudget() const;
+	};
+
+	// VRAM accounting and soft budgets. Device reports every allocation (heap + category) and feeds driver budgets;
+	// streaming systems register evictable resources ("residents") and touch them when used. When a heap or a
+	// category goes over budget, residents are evicted least recently used first, but never one touched after the
+	// last completed frame (the GPU may still read it). Budgets are soft: allocations over budget still happen.
+	// Thread-safe; eviction callbacks run without the lock held, so they may free memory directly.
+	class MemoryBudget
+	{
+	public:
+		using ResidentId = uint32_t;
+		static constexpr ResidentId kInvalidResident = UINT32_MAX;
+		// Must release (or retire) the resource; its bytes count as pending until the matching onFree()
+		using EvictFn = std::function<void()>;
+		static constexpr double kFallbackBudgetFraction = 0.8; // leave room for other processes and the driver
+
+		void reset();
+		void addHeap(VkDeviceSize size, bool deviceLocal);
+		// Driver numbers for one heap (VK_EXT_memory_budget); without them usage is the tracked bytes
+		void setDriverBudget(uint32_t heap, VkDeviceSize budget, VkDeviceSize usage);
+		void setSoftBudget(MemoryCategory category, VkDeviceSize bytes);
+		// Residents touched in frames <= completed are no longer in use by the GPU
+		void setCompletedFrame(uint64_t frame);
+
+		void onAllocate(uint32_t heap, MemoryCategory category, VkDeviceSize bytes);
+		void onFree(uint32_t heap, MemoryCategory category, VkDeviceSize bytes);
+		// Would `bytes` more push the heap or the category over its budget (pending evictions discounted)?
+		bool wouldExceed(uint32_t heap, MemoryCategory category, VkDeviceSize bytes) const;
+
+		// Call removeResident() when the resource goes away, evicted or not
+		ResidentId addResident(uint32_t heap, MemoryCategory category, VkDeviceSize bytes, EvictFn evict);
+		void removeResident(ResidentId id);
+		void touch(ResidentId id, uint64_t frame);
+
+		// Evicts LRU residents of `heap` until `bytes` are freed or none is evictable; returns the evicted bytes
+		VkDeviceSize evict(uint32_t heap, VkDeviceSize bytes);
+		// Brings every heap and category back under budget as far as residents allow; once per frame
+		VkDeviceSize enforce();
+
+		MemoryStats stats() const;
+		// Sums over DEVICE_LOCAL heaps without copying the heap list (per-frame stats)
+		void deviceLocalTotals(VkDeviceSize& usage, VkDeviceSize& budget) const;
+
+	private:
+		struct Heap
+		{
+			MemoryHeapUsage usage{};
+			bool driver = false;
+			VkDeviceSize pendingFree = 0; // evicted, not yet freed
+			bool warned = false;
+		};
+		struct Resident
+		{
+			EvictFn evict{};
+			VkDeviceSize bytes = 0;
+			uint64_t lastUsed = 0;
+			uint32_t heap = 0;
+			MemoryCategory category = MemoryCategory::Other;
+			bool alive = false; // registered and not evicted
+			bool occupied = false; // slot in use until removeResident()
+		};
+
+		VkDeviceSize heapUsageLocked(const Heap& h) const;
+		// Picks LRU victims matching the filter until `bytes` are covered; removes them and returns their callbacks
+		template <typename Filter>
+		VkDeviceSize collectVictimsLocked(VkDeviceSize bytes, Filter filter, std::vector<EvictFn>& out);
+
+		mutable std::mutex mutex_;
+		std::vector<Heap> heaps_{};
+		std::array<VkDeviceSize, kMemoryCategoryCount> categoryBytes_{};
+		std::array<VkDeviceSize, kMemoryCategoryCount> categoryPending_{};
+		std::array<VkDeviceSize, kMemoryCategoryCount> softBudget_{};
+		std::array<uint32_t, kMemoryCategoryCount> categoryAllocations_{};
+		std::array<bool, kMemoryCategoryCount> categoryWarned_{};
+		std::vector<Resident> residents_{};
+		std::vector<ResidentId> freeResidents_{};
+		uint64_t completedFrame_ = 0;
+		uint64_t evictions_ = 0;
+		VkDeviceSize evictedBytes_ = 0;
+	};
+}
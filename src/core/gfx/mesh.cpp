@@ -1,12 +1,10 @@
 #include "core/gfx/mesh.hpp"
-#include "core/gfx/buffer.hpp"
-#include "core/gfx/device.hpp"
 #include "core/gfx/command_context.hpp"
 #include <cstring>
 
 namespace luster::gfx
 {
-	void Mesh::createCube(Device& device)
+	void Mesh::createCube(GpuAllocator& allocator)
 	{
 		struct V
 		{
@@ -29,44 +27,47 @@ namespace luster::gfx
 		vertexLayout_.addAttribute(0, 0, VK_FORMAT_R32G32B32_SFLOAT, 0);
 		vertexLayout_.addAttribute(1, 0, VK_FORMAT_R32G32B32_SFLOAT, sizeof(float) * 3);
 
-		vertexBuffer_ = std::make_unique<Buffer>();
+		allocator_ = &allocator;
 		BufferCreateInfo vbi{};
 		vbi.size = sizeof(verts);
 		vbi.usage = VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT;
 		vbi.properties = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
-		vertexBuffer_->create(device, vbi);
-		vertexBuffer_->upload(device, verts, sizeof(verts));
+		vbi.category = MemoryCategory::Mesh;
+		vbi.movable = true;
+		vertexBuffer_ = allocator.createBuffer(vbi);
+		allocator.upload(vertexBuffer_, verts, sizeof(verts));
 
-		indexBuffer_ = std::make_unique<Buffer>();
 		BufferCreateInfo ibi{};
 		ibi.size = sizeof(indices);
 		ibi.usage = VK_BUFFER_USAGE_INDEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT;
 		ibi.properties = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
-		indexBuffer_->create(device, ibi);
-		indexBuffer_->upload(device, indices, sizeof(indices));
+		ibi.category = MemoryCategory::Mesh;
+		ibi.movable = true;
+		indexBuffer_ = allocator.createBuffer(ibi);
+		allocator.upload(indexBuffer_, indices, sizeof(indices));
 	}
 
-	void Mesh::cleanup(Device& device)
+	void Mesh::cleanup(Device&)
 	{
-		if (indexBuffer_)
+		// Only called while the GPU is idle (init, shutdown): released at the allocator's next collect()
+		if (allocator_)
 		{
-			indexBuffer_->cleanup(device);
-			indexBuffer_.reset();
-		}
-		if (vertexBuffer_)
-		{
-			vertexBuffer_->cleanup(device);
-			vertexBuffer_.reset();
+			allocator_->destroy(indexBuffer_);
+			allocator_->destroy(vertexBuffer_);
 		}
+		indexBuffer_ = {};
+		vertexBuffer_ = {};
 		indexCount_ = 0;
 		vertexLayout_ = VertexLayout{};
 	}
 
 	void Mesh::bind(CommandContext& ctx) const
 	{
-		const VkBuffer vb = vertexBuffer_ ? vertexBuffer_->handle() : VK_NULL_HANDLE;
+		if (!allocator_) return;
+		const VkBuffer vb = allocator_->buffer(vertexBuffer_);
+		const VkBuffer ib = allocator_->buffer(indexBuffer_);
 		constexpr VkDeviceSize ofs = 0;
 		if (vb) ctx.bindVertexBuffers(0, &vb, &ofs, 1);
-		if (indexBuffer_) ctx.bindIndexBuffer(indexBuffer_->handle(), 0, VK_INDEX_TYPE_UINT16);
+		if (ib) ctx.bindIndexBuffer(ib, 0, VK_INDEX_TYPE_UINT16);
 	}
 }
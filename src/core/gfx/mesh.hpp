@@ -1,13 +1,12 @@
 #pragma once
 
 #include "core/core.hpp"
+#include "core/gfx/gpu_allocator.hpp"
 #include "core/gfx/vertex_layout.hpp"
-#include <memory>
 
 namespace luster::gfx
 {
 	class Device;
-	class Buffer;
 	class CommandContext;
 
 	class Mesh
@@ -16,7 +15,8 @@ namespace luster::gfx
 		Mesh() = default;
 		~Mesh() = default;
 
-		void createCube(Device& device);
+		// Buffers live in `allocator` and may be moved by its defragmenter: resolved at bind time
+		void createCube(GpuAllocator& allocator);
 		void cleanup(Device& device);
 
 		void bind(CommandContext& ctx) const;
@@ -24,8 +24,9 @@ namespace luster::gfx
 		const VertexLayout* vertexLayout() const { return &vertexLayout_; }
 
 	private:
-		std::unique_ptr<Buffer> vertexBuffer_;
-		std::unique_ptr<Buffer> indexBuffer_;
+		GpuAllocator* allocator_ = nullptr;
+		GpuResource vertexBuffer_{};
+		GpuResource indexBuffer_{};
 		VertexLayout vertexLayout_{};
 		uint32_t indexCount_ = 0;
 	};
@@ -8,11 +8,23 @@
 namespace luster::gfx
 {
 	void Pipeline::create(const Device& device, const RenderPass& rp, const PipelineCreateInfo& info)
+	{
+		build(device, rp.handle(), info);
+	}
+
+	void Pipeline::create(const Device& device, const PipelineCreateInfo& info)
+	{
+		if (info.colorFormat == VK_FORMAT_UNDEFINED)
+			throw std::runtime_error("Pipeline::create: dynamic rendering needs colorFormat");
+		build(device, VK_NULL_HANDLE, info);
+	}
+
+	void Pipeline::build(const Device& device, VkRenderPass renderPass, const PipelineCreateInfo& info)
 	{
 		auto vsCode = Shader::readFileBinary(info.vsSpvPath);
 		auto fsCode = Shader::readFileBinary(info.fsSpvPath);
-		VkShaderModule vs = Shader::createModule(device.logical(), vsCode);
-		VkShaderModule fs = Shader::createModule(device.logical(), fsCode);
+		VkShaderModule vs = Shader::createModule(device, vsCode);
+		VkShaderModule fs = Shader::createModule(device, fsCode);
 
 		VkPipelineShaderStageCreateInfo vsStage{VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO};
 		vsStage.stage = VK_SHADER_STAGE_VERTEX_BIT;
@@ -72,6 +84,10 @@ namespace luster::gfx
 		vpState.pViewports = &vp;
 		vpState.scissorCount = 1;
 		vpState.pScissors = &sc;
+		const VkDynamicState dynamicStates[] = {VK_DYNAMIC_STATE_VIEWPORT, VK_DYNAMIC_STATE_SCISSOR};
+		VkPipelineDynamicStateCreateInfo dyn{VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO};
+		dyn.dynamicStateCount = 2;
+		dyn.pDynamicStates = dynamicStates;
 
 		VkPipelineRasterizationStateCreateInfo rs{VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO};
 		rs.polygonMode = VK_POLYGON_MODE_FILL;
@@ -99,7 +115,9 @@ namespace luster::gfx
 		VkPipelineLayoutCreateInfo pl{VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO};
 		pl.setLayoutCount = info.setLayoutCount;
 		pl.pSetLayouts = info.setLayouts;
-		VkResult r = vkCreatePipelineLayout(device.logical(), &pl, nullptr, &pipelineLayout_);
+		pl.pushConstantRangeCount = info.pushConstantRangeCount;
+		pl.pPushConstantRanges = info.pushConstantRanges;
+		VkResult r = device.vk().CreatePipelineLayout(device.logical(), &pl, nullptr, &pipelineLayout_);
 		if (r != VK_SUCCESS) throw std::runtime_error("vkCreatePipelineLayout failed");
 
 		VkGraphicsPipelineCreateInfo pci{VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO};
@@ -112,23 +130,32 @@ namespace luster::gfx
 		pci.pMultisampleState = &ms;
 		pci.pDepthStencilState = &ds;
 		pci.pColorBlendState = &cb;
-		pci.pDynamicState = nullptr;
+		pci.pDynamicState = info.dynamicViewport ? &dyn : nullptr;
+		dynamicViewport_ = info.dynamicViewport;
 		pci.layout = pipelineLayout_;
-		pci.renderPass = rp.handle();
+		pci.renderPass = renderPass;
 		pci.subpass = 0;
+		VkPipelineRenderingCreateInfo rci{VK_STRUCTURE_TYPE_PIPELINE_RENDERING_CREATE_INFO};
+		if (!renderPass)
+		{
+			rci.colorAttachmentCount = 1;
+			rci.pColorAttachmentFormats = &info.colorFormat;
+			rci.depthAttachmentFormat = info.depthFormat;
+			pci.pNext = &rci;
+		}
 
-		r = vkCreateGraphicsPipelines(device.logical(), VK_NULL_HANDLE, 1, &pci, nullptr, &pipeline_);
+		r = device.vk().CreateGraphicsPipelines(device.logical(), VK_NULL_HANDLE, 1, &pci, nullptr, &pipeline_);
 		if (r != VK_SUCCESS) throw std::runtime_error("vkCreateGraphicsPipelines failed");
 
-		vkDestroyShaderModule(device.logical(), fs, nullptr);
-		vkDestroyShaderModule(device.logical(), vs, nullptr);
+		device.vk().DestroyShaderModule(device.logical(), fs, nullptr);
+		device.vk().DestroyShaderModule(device.logical(), vs, nullptr);
 	}
 
 	void Pipeline::cleanup(const Device& device)
 	{
-		if (pipeline_) vkDestroyPipeline(device.logical(), pipeline_, nullptr);
+		if (pipeline_) device.vk().DestroyPipeline(device.logical(), pipeline_, nullptr);
 		pipeline_ = VK_NULL_HANDLE;
-		if (pipelineLayout_) vkDestroyPipelineLayout(device.logical(), pipelineLayout_, nullptr);
+		if (pipelineLayout_) device.vk().DestroyPipelineLayout(device.logical(), pipelineLayout_, nullptr);
 		pipelineLayout_ = VK_NULL_HANDLE;
 	}
 }
@@ -13,7 +13,9 @@ namespace luster::gfx
     {
         std::string vsSpvPath;
         std::string fsSpvPath;
-        VkExtent2D viewportExtent{};
+        VkExtent2D viewportExtent{}; // baked viewport/scissor; ignored when dynamicViewport
+        // Viewport/scissor set per command buffer: the pipeline survives swapchain resizes
+        bool dynamicViewport = true;
         VkBool32 enableDepthTest = VK_TRUE;
         VkBool32 enableDepthWrite = VK_TRUE;
         // 顶点输入：支持最多 1 个 binding（当前需求）
@@ -26,6 +28,12 @@ namespace luster::gfx
         // 可选：描述符布局（如 UBO）
         const VkDescriptorSetLayout* setLayouts = nullptr;
         uint32_t setLayoutCount = 0;
+        // 可选：push constant 范围（总大小建议 <= 128 字节，所有设备都保证支持）
+        const VkPushConstantRange* pushConstantRanges = nullptr;
+        uint32_t pushConstantRangeCount = 0;
+        // Dynamic rendering: attachment formats replace the render pass (depthFormat UNDEFINED = no depth)
+        VkFormat colorFormat = VK_FORMAT_UNDEFINED;
+        VkFormat depthFormat = VK_FORMAT_UNDEFINED;
     };
 
     class Pipeline
@@ -35,14 +43,21 @@ namespace luster::gfx
         ~Pipeline() = default;
 
         void create(const Device& device, const RenderPass& rp, const PipelineCreateInfo& info);
+        // For vkCmdBeginRendering: compatible with any rendering using info.colorFormat/depthFormat
+        void create(const Device& device, const PipelineCreateInfo& info);
         void cleanup(const Device& device);
 
         VkPipelineLayout layout() const { return pipelineLayout_; }
         VkPipeline handle() const { return pipeline_; }
+        // false: binding it overwrites the command buffer's viewport/scissor with the baked ones
+        bool dynamicViewport() const { return dynamicViewport_; }
 
     private:
+        void build(const Device& device, VkRenderPass renderPass, const PipelineCreateInfo& info);
+
         VkPipelineLayout pipelineLayout_ = VK_NULL_HANDLE;
         VkPipeline pipeline_ = VK_NULL_HANDLE;
+        bool dynamicViewport_ = true;
     };
 }
 
@@ -4,7 +4,8 @@
 
 namespace luster::gfx
 {
-	void RenderPass::create(const Device& device, VkFormat colorFormat, VkFormat depthFormat)
+	void RenderPass::create(const Device& device, VkFormat colorFormat, VkFormat depthFormat,
+	                        VkImageLayout colorFinalLayout)
 	{
 		VkAttachmentDescription color{};
 		color.format = colorFormat;
@@ -14,7 +15,7 @@ namespace luster::gfx
 		color.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
 		color.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
 		color.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
-		color.finalLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
+		color.finalLayout = colorFinalLayout;
 
 		VkAttachmentReference colorRef{};
 		colorRef.attachment = 0;
@@ -57,13 +58,13 @@ namespace luster::gfx
 		rpci.dependencyCount = 1;
 		rpci.pDependencies = &dep;
 
-		VkResult r = vkCreateRenderPass(device.logical(), &rpci, nullptr, &renderPass_);
+		VkResult r = device.vk().CreateRenderPass(device.logical(), &rpci, nullptr, &renderPass_);
 		if (r != VK_SUCCESS) throw std::runtime_error("vkCreateRenderPass failed");
 	}
 
 	void RenderPass::cleanup(const Device& device)
 	{
-		if (renderPass_) vkDestroyRenderPass(device.logical(), renderPass_, nullptr);
+		if (renderPass_) device.vk().DestroyRenderPass(device.logical(), renderPass_, nullptr);
 		renderPass_ = VK_NULL_HANDLE;
 	}
 }
@@ -12,7 +12,9 @@ namespace luster::gfx
         RenderPass() = default;
         ~RenderPass() = default;
 
-        void create(const Device& device, VkFormat colorFormat, VkFormat depthFormat);
+        // colorFinalLayout: PRESENT_SRC for swapchain targets, TRANSFER_SRC/SHADER_READ for offscreen targets
+        void create(const Device& device, VkFormat colorFormat, VkFormat depthFormat,
+                    VkImageLayout colorFinalLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR);
         void cleanup(const Device& device);
 
         VkRenderPass handle() const { return renderPass_; }
@@ -0,0 +1,55 @@
+#include "core/gfx/resource_registry.hpp"
+#include "core/gfx/device.hpp"
+#include "core/gfx/gpu_allocator.hpp"
+
+namespace luster::gfx
+{
+	// Created in place, so a throwing create() leaves no handle behind
+	template <typename T, typename Owner, typename... Args>
+	static Handle<T> createIn(HandlePool<T>& pool, Owner& owner, const Args&... args)
+	{
+		T object;
+		object.create(owner, args...);
+		return pool.insert(std::move(object));
+	}
+
+	BufferHandle ResourceRegistry::createBuffer(const Device& device, const BufferCreateInfo& info)
+	{
+		if (allocator_) return createIn(pool<Buffer>(), *allocator_, info);
+		return createIn(pool<Buffer>(), device, info);
+	}
+
+	ImageHandle ResourceRegistry::createImage(const Device& device, const ImageCreateInfo& info)
+	{
+		if (allocator_) return createIn(pool<Image>(), *allocator_, info);
+		return createIn(pool<Image>(), device, info);
+	}
+
+	PipelineHandle ResourceRegistry::createPipeline(const Device& device, const RenderPass& rp,
+	                                                const PipelineCreateInfo& info)
+	{
+		return createIn(pool<Pipeline>(), device, rp, info);
+	}
+
+	PipelineHandle ResourceRegistry::createPipeline(const Device& device, const PipelineCreateInfo& info)
+	{
+		return createIn(pool<Pipeline>(), device, info);
+	}
+
+	SamplerHandle ResourceRegistry::createSampler(const Device& device, const SamplerCreateInfo& info)
+	{
+		return createIn(pool<Sampler>(), device, info);
+	}
+
+	void ResourceRegistry::cleanup(const Device& device)
+	{
+		std::apply([&](auto&... pools)
+		{
+			(([&]
+			{
+				for (auto& object : pools.objects()) object.cleanup(device);
+				pools.clear();
+			}()), ...);
+		}, pools_);
+	}
+}
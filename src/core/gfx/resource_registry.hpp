@@ -0,0 +1,67 @@
+#pragma once
+
+#include "core/gfx/buffer.hpp"
+#include "core/gfx/image.hpp"
+#include "core/gfx/pipeline.hpp"
+#include "core/gfx/sampler.hpp"
+#include "core/utils/handle_pool.hpp"
+#include <tuple>
+
+namespace luster::gfx
+{
+	class Device;
+	class GpuAllocator;
+	class RenderPass;
+
+	using BufferHandle = Handle<Buffer>;
+	using ImageHandle = Handle<Image>;
+	using PipelineHandle = Handle<Pipeline>;
+	using SamplerHandle = Handle<Sampler>;
+
+	// Owner of the renderer's GPU objects: one dense HandlePool per type instead of a heap allocation each,
+	// addressed by 32-bit generational handles that are safe to hold across jobs and frames (a destroyed resource
+	// stops resolving; get() on it throws in debug builds). Deferred destruction: capture the handle in a
+	// DeletionQueue entry and destroy() it there. References from get() are invalidated by create/destroy of the
+	// same type. With an allocator set, buffers and images are suballocated from it (and the movable ones
+	// defragmented with everything else in it); it must outlive them. Render thread only.
+	class ResourceRegistry
+	{
+	public:
+		void setAllocator(GpuAllocator* allocator) { allocator_ = allocator; }
+
+		BufferHandle createBuffer(const Device& device, const BufferCreateInfo& info);
+		ImageHandle createImage(const Device& device, const ImageCreateInfo& info);
+		PipelineHandle createPipeline(const Device& device, const RenderPass& rp, const PipelineCreateInfo& info);
+		PipelineHandle createPipeline(const Device& device, const PipelineCreateInfo& info); // dynamic rendering
+		SamplerHandle createSampler(const Device& device, const SamplerCreateInfo& info);
+
+		template <typename T>
+		T& get(Handle<T> h) { return pool<T>().at(h); }
+		template <typename T>
+		const T& get(Handle<T> h) const { return pool<T>().at(h); }
+		template <typename T>
+		bool alive(Handle<T> h) const { return pool<T>().contains(h); }
+		template <typename T>
+		size_t count() const { return pool<T>().size(); }
+
+		// Releases the GPU objects and nulls `h`; null and stale handles are ignored
+		template <typename T>
+		void destroy(const Device& device, Handle<T>& h)
+		{
+			if (pool<T>().contains(h)) pool<T>().remove(h).cleanup(device);
+			h = {};
+		}
+
+		// Everything, after vkDeviceWaitIdle
+		void cleanup(const Device& device);
+
+	private:
+		template <typename T>
+		HandlePool<T>& pool() { return std::get<HandlePool<T>>(pools_); }
+		template <typename T>
+		const HandlePool<T>& pool() const { return std::get<HandlePool<T>>(pools_); }
+
+		std::tuple<HandlePool<Buffer>, HandlePool<Image>, HandlePool<Pipeline>, HandlePool<Sampler>> pools_{};
+		GpuAllocator* allocator_ = nullptr;
+	};
+}
@@ -0,0 +1,28 @@
+#include "core/gfx/sampler.hpp"
+#include "core/gfx/device.hpp"
+#include <stdexcept>
+
+namespace luster::gfx
+{
+	void Sampler::create(const Device& device, const SamplerCreateInfo& info)
+	{
+		cleanup(device);
+		VkSamplerCreateInfo si{VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO};
+		si.magFilter = info.filter;
+		si.minFilter = info.filter;
+		si.mipmapMode = info.mipmapMode;
+		si.addressModeU = info.addressMode;
+		si.addressModeV = info.addressMode;
+		si.addressModeW = info.addressMode;
+		si.maxLod = info.maxLod;
+		si.borderColor = VK_BORDER_COLOR_FLOAT_TRANSPARENT_BLACK;
+		if (device.vk().CreateSampler(device.logical(), &si, nullptr, &sampler_) != VK_SUCCESS)
+			throw std::runtime_error("vkCreateSampler failed");
+	}
+
+	void Sampler::cleanup(const Device& device)
+	{
+		if (sampler_) device.vk().DestroySampler(device.logical(), sampler_, nullptr);
+		sampler_ = VK_NULL_HANDLE;
+	}
+}
@@ -0,0 +1,31 @@
+#pragma once
+
+#include "core/core.hpp"
+
+namespace luster::gfx
+{
+	class Device;
+
+	struct SamplerCreateInfo
+	{
+		VkFilter filter = VK_FILTER_LINEAR; // mag and min
+		VkSamplerMipmapMode mipmapMode = VK_SAMPLER_MIPMAP_MODE_LINEAR;
+		VkSamplerAddressMode addressMode = VK_SAMPLER_ADDRESS_MODE_REPEAT; // u, v and w
+		float maxLod = VK_LOD_CLAMP_NONE;
+	};
+
+	class Sampler
+	{
+	public:
+		Sampler() = default;
+		~Sampler() = default;
+
+		void create(const Device& device, const SamplerCreateInfo& info);
+		void cleanup(const Device& device);
+
+		VkSampler handle() const { return sampler_; }
+
+	private:
+		VkSampler sampler_ = VK_NULL_HANDLE;
+	};
+}
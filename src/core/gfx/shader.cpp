@@ -1,4 +1,5 @@
 #include "core/gfx/shader.hpp"
+#include "core/gfx/device.hpp"
 #include <fstream>
 #include <stdexcept>
 
@@ -27,13 +28,13 @@ namespace luster::gfx
 		}
 	}
 
-	VkShaderModule Shader::createModule(VkDevice device, const std::vector<char>& code)
+	VkShaderModule Shader::createModule(const Device& device, const std::vector<char>& code)
 	{
 		VkShaderModuleCreateInfo ci{VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO};
 		ci.codeSize = code.size();
 		ci.pCode = reinterpret_cast<const uint32_t*>(code.data());
 		VkShaderModule mod = VK_NULL_HANDLE;
-		VkResult r = vkCreateShaderModule(device, &ci, nullptr, &mod);
+		VkResult r = device.vk().CreateShaderModule(device.logical(), &ci, nullptr, &mod);
 		if (r != VK_SUCCESS) throw std::runtime_error(std::string("vkCreateShaderModule failed: ") + vk_err(r));
 		return mod;
 	}
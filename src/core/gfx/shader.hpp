@@ -6,11 +6,13 @@
 
 namespace luster::gfx
 {
+    class Device;
+
     class Shader
     {
     public:
         static std::vector<char> readFileBinary(const std::string& path);
-        static VkShaderModule createModule(VkDevice device, const std::vector<char>& code);
+        static VkShaderModule createModule(const Device& device, const std::vector<char>& code);
     };
 }
 
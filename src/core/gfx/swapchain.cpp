@@ -5,19 +5,35 @@
 #include <limits>
 #include <stdexcept>
 #include "core/window.hpp"
+#include "core/utils/deletion_queue.hpp"
+#include "core/memory/scratch.hpp"
 
 namespace luster::gfx
 {
+	const char* toString(VkPresentModeKHR mode)
+	{
+		switch (mode)
+		{
+		case VK_PRESENT_MODE_IMMEDIATE_KHR: return "IMMEDIATE";
+		case VK_PRESENT_MODE_MAILBOX_KHR: return "MAILBOX";
+		case VK_PRESENT_MODE_FIFO_KHR: return "FIFO";
+		case VK_PRESENT_MODE_FIFO_RELAXED_KHR: return "FIFO_RELAXED";
+		default: return "OTHER";
+		}
+	}
+
 	struct SwapchainSupport
 	{
 		VkSurfaceCapabilitiesKHR caps{};
-		std::vector<VkSurfaceFormatKHR> formats;
-		std::vector<VkPresentModeKHR> presentModes;
+		std::pmr::vector<VkSurfaceFormatKHR> formats;
+		std::pmr::vector<VkPresentModeKHR> presentModes;
 	};
 
-	static SwapchainSupport querySwapchainSupport(VkPhysicalDevice gpu, VkSurfaceKHR surface)
+	// Lists live in `scratch`: a resize only queries, nothing escapes build()
+	static SwapchainSupport querySwapchainSupport(VkPhysicalDevice gpu, VkSurfaceKHR surface, ScratchScope& scratch)
 	{
-		SwapchainSupport sup{};
+		SwapchainSupport sup{{}, std::pmr::vector<VkSurfaceFormatKHR>(scratch.resource()),
+		                     std::pmr::vector<VkPresentModeKHR>(scratch.resource())};
 		vkGetPhysicalDeviceSurfaceCapabilitiesKHR(gpu, surface, &sup.caps);
 		uint32_t count = 0;
 		vkGetPhysicalDeviceSurfaceFormatsKHR(gpu, surface, &count, nullptr);
@@ -30,7 +46,7 @@ namespace luster::gfx
 		return sup;
 	}
 
-	VkSurfaceFormatKHR Swapchain::chooseSurfaceFormat(const std::vector<VkSurfaceFormatKHR>& formats,
+	VkSurfaceFormatKHR Swapchain::chooseSurfaceFormat(std::span<const VkSurfaceFormatKHR> formats,
 	                                                  VkFormat preferredFormat,
 	                                                  VkColorSpaceKHR preferredColorSpace)
 	{
@@ -43,10 +59,14 @@ namespace luster::gfx
 		return formats[0];
 	}
 
-	VkPresentModeKHR Swapchain::choosePresentMode(const std::vector<VkPresentModeKHR>& modes)
+	VkPresentModeKHR Swapchain::choosePresentMode(std::span<const VkPresentModeKHR> modes,
+	                                              const SwapchainCreateInfo& info)
 	{
-		for (auto m : modes) if (m == VK_PRESENT_MODE_MAILBOX_KHR) return m;
-		return VK_PRESENT_MODE_FIFO_KHR;
+		const auto supported = [&](VkPresentModeKHR m) { return std::find(modes.begin(), modes.end(), m) != modes.end(); };
+		if (supported(info.preferredPresentMode)) return info.preferredPresentMode;
+		for (auto m : info.fallbacks())
+			if (supported(m)) return m;
+		return VK_PRESENT_MODE_FIFO_KHR; // required by the spec
 	}
 
 	VkExtent2D Swapchain::chooseExtent(const VkSurfaceCapabilitiesKHR& caps, ::luster::Window& window)
@@ -62,23 +82,22 @@ namespace luster::gfx
 
 	void Swapchain::create(const Device& device, ::luster::Window& window, const SwapchainCreateInfo& info)
 	{
-		auto sup = querySwapchainSupport(device.physical(), device.surface());
+		build(device, window, info, VK_NULL_HANDLE);
+	}
+
+	void Swapchain::build(const Device& device, ::luster::Window& window, const SwapchainCreateInfo& info,
+	                      VkSwapchainKHR oldSwapchain)
+	{
+		ScratchScope scratch;
+		const auto sup = querySwapchainSupport(device.physical(), device.surface(), scratch);
 		const VkSurfaceFormatKHR fmt = chooseSurfaceFormat(sup.formats, info.preferredFormat, info.preferredColorSpace);
-		VkPresentModeKHR present = info.preferredPresentMode;
-		bool supported = false;
-		for (auto m : sup.presentModes) if (m == present)
-		{
-			supported = true;
-			break;
-		}
-		if (!supported)
-		{
-			// fallback：MAILBOX 优先，否则 FIFO
-			present = choosePresentMode(sup.presentModes);
-		}
+		const VkPresentModeKHR present = choosePresentMode(sup.presentModes, info);
+		if (present != info.preferredPresentMode && !oldSwapchain) // once, not on every resize
+			spdlog::warn("Present mode {} unsupported, using {}", toString(info.preferredPresentMode),
+			             toString(present));
 		const VkExtent2D extent = chooseExtent(sup.caps, window);
 
-		uint32_t imageCount = sup.caps.minImageCount + 1;
+		uint32_t imageCount = sup.caps.minImageCount + info.extraImages;
 		if (sup.caps.maxImageCount > 0 && imageCount > sup.caps.maxImageCount) imageCount = sup.caps.maxImageCount;
 
 		VkSwapchainCreateInfoKHR sci{VK_STRUCTURE_TYPE_SWAPCHAIN_CREATE_INFO_KHR};
@@ -88,7 +107,7 @@ namespace luster::gfx
 		sci.imageColorSpace = fmt.colorSpace;
 		sci.imageExtent = extent;
 		sci.imageArrayLayers = 1;
-		sci.imageUsage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT;
+		sci.imageUsage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | (info.imageUsage & sup.caps.supportedUsageFlags);
 
 		uint32_t indices[] = {device.gfxQueueFamily(), device.presentQueueFamily()};
 		if (device.gfxQueueFamily() != device.presentQueueFamily())
@@ -106,17 +125,21 @@ namespace luster::gfx
 		sci.compositeAlpha = VK_COMPOSITE_ALPHA_OPAQUE_BIT_KHR;
 		sci.presentMode = present;
 		sci.clipped = VK_TRUE;
+		// Lets the driver hand over resources and keeps already-acquired old images presentable
+		sci.oldSwapchain = oldSwapchain;
 
-		VkResult r = vkCreateSwapchainKHR(device.logical(), &sci, nullptr, &swapchain_);
+		VkResult r = device.vk().CreateSwapchainKHR(device.logical(), &sci, nullptr, &swapchain_);
 		if (r != VK_SUCCESS) throw std::runtime_error("vkCreateSwapchainKHR failed");
 
 		swapFormat_ = fmt.format;
 		swapColorSpace_ = fmt.colorSpace;
 		swapExtent_ = extent;
+		presentMode_ = present;
+		imageUsage_ = sci.imageUsage;
 
-		vkGetSwapchainImagesKHR(device.logical(), swapchain_, &imageCount, nullptr);
+		device.vk().GetSwapchainImagesKHR(device.logical(), swapchain_, &imageCount, nullptr);
 		swapImages_.resize(imageCount);
-		vkGetSwapchainImagesKHR(device.logical(), swapchain_, &imageCount, swapImages_.data());
+		device.vk().GetSwapchainImagesKHR(device.logical(), swapchain_, &imageCount, swapImages_.data());
 
 		swapImageViews_.resize(swapImages_.size());
 		for (size_t i = 0; i < swapImages_.size(); ++i)
@@ -132,23 +155,47 @@ namespace luster::gfx
 			ci.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
 			ci.subresourceRange.levelCount = 1;
 			ci.subresourceRange.layerCount = 1;
-			VkResult rv = vkCreateImageView(device.logical(), &ci, nullptr, &swapImageViews_[i]);
+			VkResult rv = device.vk().CreateImageView(device.logical(), &ci, nullptr, &swapImageViews_[i]);
 			if (rv != VK_SUCCESS) throw std::runtime_error("vkCreateImageView failed");
 		}
 	}
 
-	void Swapchain::recreate(const Device& device, ::luster::Window& window, const SwapchainCreateInfo& info)
+	void Swapchain::recreate(const Device& device, ::luster::Window& window, const SwapchainCreateInfo& info,
+	                         DeletionQueue& retired, uint64_t retireFrame)
 	{
-		cleanup(device);
-		create(device, window, info);
+		const VkSwapchainKHR old = swapchain_;
+		std::vector<VkImageView> oldViews = std::move(swapImageViews_);
+		swapImageViews_.clear();
+		swapImages_.clear();
+		swapchain_ = VK_NULL_HANDLE;
+		try
+		{
+			build(device, window, info, old);
+		}
+		catch (...)
+		{
+			// Old swapchain is retired by vkCreateSwapchainKHR even on failure
+			cleanup(device);
+			for (auto iv : oldViews) device.vk().DestroyImageView(device.logical(), iv, nullptr);
+			if (old) device.vk().DestroySwapchainKHR(device.logical(), old, nullptr);
+			throw;
+		}
+		if (!old) return;
+		const VkDevice dev = device.logical();
+		const DeviceDispatch* vk = &device.vk(); // the Device outlives its deletion queues
+		retired.push(retireFrame, [dev, vk, old, views = std::move(oldViews)]
+		{
+			for (auto iv : views) vk->DestroyImageView(dev, iv, nullptr);
+			vk->DestroySwapchainKHR(dev, old, nullptr);
+		});
 	}
 
 	void Swapchain::cleanup(const Device& device)
 	{
-		for (auto iv : swapImageViews_) if (iv) vkDestroyImageView(device.logical(), iv, nullptr);
+		for (auto iv : swapImageViews_) if (iv) device.vk().DestroyImageView(device.logical(), iv, nullptr);
 		swapImageViews_.clear();
 		swapImages_.clear();
-		if (swapchain_) vkDestroySwapchainKHR(device.logical(), swapchain_, nullptr);
+		if (swapchain_) device.vk().DestroySwapchainKHR(device.logical(), swapchain_, nullptr);
 		swapchain_ = VK_NULL_HANDLE;
 	}
 }
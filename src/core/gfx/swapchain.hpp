@@ -1,19 +1,40 @@
 #pragma once
 
 #include "core/core.hpp"
+#include <array>
+#include <span>
+#include <vector>
 
-namespace luster { class Window; }
+namespace luster
+{
+	class Window;
+	class DeletionQueue;
+}
 
 namespace luster::gfx
 {
 	class Device;
 
+	const char* toString(VkPresentModeKHR mode);
+
 	struct SwapchainCreateInfo
 	{
 		VkFormat preferredFormat = VK_FORMAT_B8G8R8A8_UNORM;
 		VkColorSpaceKHR preferredColorSpace = VK_COLOR_SPACE_SRGB_NONLINEAR_KHR;
 		// FIFO 可锁帧到显示器刷新率；MAILBOX 可低延迟（若可用）
 		VkPresentModeKHR preferredPresentMode = VK_PRESENT_MODE_FIFO_KHR;
+		// 不支持时按顺序尝试前 fallbackPresentModeCount 个；都不支持时用 FIFO（总是可用）
+		std::array<VkPresentModeKHR, 3> fallbackPresentModes{};
+		uint32_t fallbackPresentModeCount = 0;
+
+		std::span<const VkPresentModeKHR> fallbacks() const
+		{
+			return std::span(fallbackPresentModes).first(fallbackPresentModeCount);
+		}
+		// minImageCount = surface minimum + extraImages（受 maxImageCount 限制）
+		uint32_t extraImages = 1;
+		// COLOR_ATTACHMENT is always set; extra bits (e.g. TRANSFER_DST for blits) only if the surface supports them
+		VkImageUsageFlags imageUsage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT;
 	};
 
 	class Swapchain
@@ -23,26 +44,39 @@ namespace luster::gfx
 		~Swapchain() = default;
 
 		void create(const Device& device, ::luster::Window& window, const SwapchainCreateInfo& info = {});
-		void recreate(const Device& device, ::luster::Window& window, const SwapchainCreateInfo& info = {});
+		// Chains the current swapchain as oldSwapchain; the old swapchain and its views are destroyed through
+		// `retired` once `retireFrame` completed
+		void recreate(const Device& device, ::luster::Window& window, const SwapchainCreateInfo& info,
+		              DeletionQueue& retired, uint64_t retireFrame);
 		void cleanup(const Device& device);
 
 		// Accessors
 		VkSwapchainKHR handle() const { return swapchain_; }
 		VkFormat imageFormat() const { return swapFormat_; }
 		VkExtent2D extent() const { return swapExtent_; }
+		const std::vector<VkImage>& images() const { return swapImages_; }
 		const std::vector<VkImageView>& imageViews() const { return swapImageViews_; }
+		VkImageUsageFlags imageUsage() const { return imageUsage_; }
+		// What the surface actually granted (may differ from the request)
+		VkPresentModeKHR presentMode() const { return presentMode_; }
+		uint32_t imageCount() const { return static_cast<uint32_t>(swapImages_.size()); }
 
 	private:
-		static VkSurfaceFormatKHR chooseSurfaceFormat(const std::vector<VkSurfaceFormatKHR>& formats,
+		static VkSurfaceFormatKHR chooseSurfaceFormat(std::span<const VkSurfaceFormatKHR> formats,
 		                                              VkFormat preferredFormat,
 		                                              VkColorSpaceKHR preferredColorSpace);
-		static VkPresentModeKHR choosePresentMode(const std::vector<VkPresentModeKHR>& modes);
+		static VkPresentModeKHR choosePresentMode(std::span<const VkPresentModeKHR> modes,
+		                                          const SwapchainCreateInfo& info);
 		static VkExtent2D chooseExtent(const VkSurfaceCapabilitiesKHR& caps, ::luster::Window& window);
+		void build(const Device& device, ::luster::Window& window, const SwapchainCreateInfo& info,
+		           VkSwapchainKHR oldSwapchain);
 
 		VkSwapchainKHR swapchain_ = VK_NULL_HANDLE;
 		VkFormat swapFormat_ = VK_FORMAT_B8G8R8A8_UNORM;
 		VkColorSpaceKHR swapColorSpace_ = VK_COLOR_SPACE_SRGB_NONLINEAR_KHR;
 		VkExtent2D swapExtent_{};
+		VkPresentModeKHR presentMode_ = VK_PRESENT_MODE_FIFO_KHR;
+		VkImageUsageFlags imageUsage_ = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT;
 		std::vector<VkImage> swapImages_;
 		std::vector<VkImageView> swapImageViews_;
 	};
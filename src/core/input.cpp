@@ -11,7 +11,7 @@ namespace luster
 		x = mx; y = my;
 	}
 
-	InputSnapshot Input::captureSnapshot()
+	static InputSnapshot sample(bool consume)
 	{
 		InputSnapshot snap{};
 		SDL_PumpEvents();
@@ -28,6 +28,8 @@ namespace luster
 		snap.keyEsc = ks[SDL_SCANCODE_ESCAPE];
 		snap.keyP = ks[SDL_SCANCODE_P];
 		snap.keyF1 = ks[SDL_SCANCODE_F1];
+		snap.keyF2 = ks[SDL_SCANCODE_F2];
+		snap.keyF3 = ks[SDL_SCANCODE_F3];
 
 		float mx = 0.0f, my = 0.0f;
 		uint32_t buttons = 0;
@@ -36,18 +38,29 @@ namespace luster
 		static float lastx = mx, lasty = my;
 		snap.mouseDx = mx - lastx;
 		snap.mouseDy = my - lasty;
-		lastx = mx; lasty = my;
+		if (consume) { lastx = mx; lasty = my; }
 
 		// Edge detection for keys (simple static previous state)
-		static bool prevP = false, prevF1 = false;
+		static bool prevP = false, prevF1 = false, prevF2 = false, prevF3 = false;
 		snap.pressedP = (ks[SDL_SCANCODE_P] && !prevP);
 		snap.releasedP = (!ks[SDL_SCANCODE_P] && prevP);
 		snap.pressedF1 = (ks[SDL_SCANCODE_F1] && !prevF1);
 		snap.releasedF1 = (!ks[SDL_SCANCODE_F1] && prevF1);
-		prevP = ks[SDL_SCANCODE_P];
-		prevF1 = ks[SDL_SCANCODE_F1];
+		snap.pressedF2 = (ks[SDL_SCANCODE_F2] && !prevF2);
+		snap.pressedF3 = (ks[SDL_SCANCODE_F3] && !prevF3);
+		if (consume)
+		{
+			prevP = ks[SDL_SCANCODE_P];
+			prevF1 = ks[SDL_SCANCODE_F1];
+			prevF2 = ks[SDL_SCANCODE_F2];
+			prevF3 = ks[SDL_SCANCODE_F3];
+		}
 		return snap;
 	}
+
+	InputSnapshot Input::captureSnapshot() { return sample(true); }
+
+	InputSnapshot Input::peekSnapshot() { return sample(false); }
 }
 
 
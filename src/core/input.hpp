@@ -18,6 +18,8 @@ namespace luster
         bool keyEsc = false;
         bool keyP = false;
         bool keyF1 = false;
+        bool keyF2 = false;
+        bool keyF3 = false;
 
         // Mouse (absolute delta per frame)
         float mouseDx = 0.0f;
@@ -29,12 +31,17 @@ namespace luster
         bool releasedP = false;
         bool pressedF1 = false;
         bool releasedF1 = false;
+        bool pressedF2 = false;
+        bool pressedF3 = false;
     };
 
     class Input
     {
     public:
         static InputSnapshot captureSnapshot();
+        // Same sample without consuming it: mouse deltas and key edges stay relative to the last
+        // captureSnapshot(), so the next capture still sees them (used for late-latching the camera)
+        static InputSnapshot peekSnapshot();
     };
 }
 
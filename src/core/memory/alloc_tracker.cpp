@@ -0,0 +1,259 @@
+#include "core/memory/alloc_tracker.hpp"
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <iterator>
+#include <vector>
+#include <spdlog/fmt/fmt.h>
+
+namespace luster
+{
+	namespace
+	{
+		constexpr size_t kTagCount = static_cast<size_t>(AllocTag::Count);
+		constexpr size_t kSizeClasses = 33; // bit width of the size, 0..32+ (4 GiB and above share the last)
+		constexpr size_t kSiteProbes = 16;
+
+		struct Header
+		{
+			uint64_t size;
+			uint32_t offset; // header start to user block; user - offset is the base pointer
+			AllocTag tag;
+		};
+		static_assert(sizeof(Header) <= AllocTracker::kHeaderSize);
+		static_assert(__STDCPP_DEFAULT_NEW_ALIGNMENT__ <= AllocTracker::kHeaderSize,
+		              "tracked blocks would lose operator new's default alignment");
+
+		struct TagCounters
+		{
+			std::atomic<uint64_t> liveBytes{0};
+			std::atomic<uint64_t> liveCount{0};
+			std::atomic<uint64_t> peakBytes{0};
+			std::atomic<uint64_t> totalAllocations{0};
+			std::atomic<uint64_t> totalBytes{0};
+			std::atomic<int64_t> customBytes{0};
+			std::atomic<int64_t> customPeakBytes{0};
+		};
+
+		struct Site
+		{
+			std::atomic<uintptr_t> address{0};
+			std::atomic<uint64_t> count{0};
+			std::atomic<uint64_t> bytes{0};
+		};
+
+		// Constant-initialized: usable by the first operator new, before any dynamic initializer ran
+		TagCounters gTags[kTagCount];
+		Site gSites[AllocTracker::kMaxSites];
+		std::atomic<uint64_t> gOtherSiteCount{0};
+		std::atomic<uint64_t> gSizeClasses[kSizeClasses];
+		std::atomic<uint64_t> gAllocations{0};
+		std::atomic<uint64_t> gBytes{0};
+		thread_local AllocTag tlsTag = AllocTag::Untagged;
+
+		// endFrame() state (single caller)
+		struct FrameState
+		{
+			uint64_t lastAllocations = 0;
+			uint64_t lastBytes = 0;
+			double averageAllocations = 0.0;
+			uint32_t frames = 0;
+			bool baseline = false; // counters recorded once: frames are measured from there
+		} gFrame;
+
+		template <typename T>
+		void raiseTo(std::atomic<T>& peak, T value)
+		{
+			T current = peak.load(std::memory_order_relaxed);
+			while (value > current && !peak.compare_exchange_weak(current, value, std::memory_order_relaxed)) {}
+		}
+
+		void recordSite(uintptr_t address, uint64_t size)
+		{
+			// Fibonacci hashing; linear probing claims an empty slot with a CAS, never evicts
+			size_t index = static_cast<size_t>((address * 0x9E3779B97F4A7C15ull) >> 52) % AllocTracker::kMaxSites;
+			for (size_t probe = 0; probe < kSiteProbes; ++probe, index = (index + 1) % AllocTracker::kMaxSites)
+			{
+				Site& site = gSites[index];
+				uintptr_t key = site.address.load(std::memory_order_relaxed);
+				if (key == 0 && site.address.compare_exchange_strong(key, address, std::memory_order_relaxed))
+					key = address;
+				if (key != address) continue;
+				site.count.fetch_add(1, std::memory_order_relaxed);
+				site.bytes.fetch_add(size, std::memory_order_relaxed);
+				return;
+			}
+			gOtherSiteCount.fetch_add(1, std::memory_order_relaxed);
+		}
+
+		void formatBytes(std::back_insert_iterator<std::string> it, uint64_t bytes)
+		{
+			if (bytes >= (1ull << 20))
+				fmt::format_to(it, "{:.2f} MiB", static_cast<double>(bytes) / (1 << 20));
+			else if (bytes >= (1ull << 10))
+				fmt::format_to(it, "{:.1f} KiB", static_cast<double>(bytes) / (1 << 10));
+			else
+				fmt::format_to(it, "{} B", bytes);
+		}
+	}
+
+	const char* toString(AllocTag tag)
+	{
+		switch (tag)
+		{
+		case AllocTag::Untagged: return "untagged";
+		case AllocTag::Renderer: return "renderer";
+		case AllocTag::Assets: return "assets";
+		case AllocTag::Logging: return "logging";
+		case AllocTag::Platform: return "platform";
+		case AllocTag::Simulation: return "simulation";
+		default: return "unknown";
+		}
+	}
+
+	AllocTag AllocTracker::currentTag() noexcept { return tlsTag; }
+
+	AllocTag AllocTracker::exchangeTag(AllocTag tag) noexcept
+	{
+		const AllocTag previous = tlsTag;
+		tlsTag = tag;
+		return previous;
+	}
+
+	AllocTagStats AllocTracker::stats(AllocTag tag) noexcept
+	{
+		const TagCounters& t = gTags[static_cast<size_t>(tag) % kTagCount];
+		AllocTagStats s;
+		s.liveBytes = t.liveBytes.load(std::memory_order_relaxed);
+		s.liveCount = t.liveCount.load(std::memory_order_relaxed);
+		s.peakBytes = t.peakBytes.load(std::memory_order_relaxed);
+		s.totalAllocations = t.totalAllocations.load(std::memory_order_relaxed);
+		s.totalBytes = t.totalBytes.load(std::memory_order_relaxed);
+		s.customBytes = static_cast<uint64_t>(std::max<int64_t>(t.customBytes.load(std::memory_order_relaxed), 0));
+		s.customPeakBytes = static_cast<uint64_t>(t.customPeakBytes.load(std::memory_order_relaxed));
+		return s;
+	}
+
+	void AllocTracker::noteCustom(AllocTag tag, int64_t bytes) noexcept
+	{
+		TagCounters& t = gTags[static_cast<size_t>(tag) % kTagCount];
+		const int64_t live = t.customBytes.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+		raiseTo(t.customPeakBytes, live);
+	}
+
+	void* AllocTracker::onAllocate(void* base, size_t size, size_t headerSize, void* site) noexcept
+	{
+		if (!base) return nullptr;
+		auto* user = static_cast<std::byte*>(base) + headerSize;
+		auto* header = reinterpret_cast<Header*>(user - kHeaderSize);
+		header->size = size;
+		header->offset = static_cast<uint32_t>(headerSize);
+		header->tag = tlsTag;
+
+		TagCounters& t = gTags[static_cast<size_t>(header->tag)];
+		raiseTo(t.peakBytes, t.liveBytes.fetch_add(size, std::memory_order_relaxed) + size);
+		t.liveCount.fetch_add(1, std::memory_order_relaxed);
+		t.totalAllocations.fetch_add(1, std::memory_order_relaxed);
+		t.totalBytes.fetch_add(size, std::memory_order_relaxed);
+		gAllocations.fetch_add(1, std::memory_order_relaxed);
+		gBytes.fetch_add(size, std::memory_order_relaxed);
+		gSizeClasses[std::min<size_t>(std::bit_width(size), kSizeClasses - 1)].fetch_add(1, std::memory_order_relaxed);
+		recordSite(reinterpret_cast<uintptr_t>(site), size);
+		return user;
+	}
+
+	void* AllocTracker::onFree(void* p) noexcept
+	{
+		auto* user = static_cast<std::byte*>(p);
+		const auto* header = reinterpret_cast<const Header*>(user - kHeaderSize);
+		// Charged to the tag it was allocated under, whichever thread frees it
+		TagCounters& t = gTags[static_cast<size_t>(header->tag)];
+		t.liveBytes.fetch_sub(header->size, std::memory_order_relaxed);
+		t.liveCount.fetch_sub(1, std::memory_order_relaxed);
+		return user - header->offset;
+	}
+
+	AllocFrameReport AllocTracker::endFrame() noexcept
+	{
+		const uint64_t allocations = gAllocations.load(std::memory_order_relaxed);
+		const uint64_t bytes = gBytes.load(std::memory_order_relaxed);
+		AllocFrameReport report;
+		// First call: everything since startup (init, asset loading) is no frame, only the baseline
+		if (!gFrame.baseline)
+		{
+			gFrame.lastAllocations = allocations;
+			gFrame.lastBytes = bytes;
+			gFrame.baseline = true;
+			return report;
+		}
+		report.allocations = allocations - gFrame.lastAllocations;
+		report.bytes = bytes - gFrame.lastBytes;
+		gFrame.lastAllocations = allocations;
+		gFrame.lastBytes = bytes;
+
+		const double count = static_cast<double>(report.allocations);
+		report.spike = gFrame.frames >= kSpikeWarmupFrames && report.allocations >= kSpikeMinAllocations &&
+			count > kSpikeFactor * gFrame.averageAllocations;
+		// Spikes stay out of the average, so a burst of them keeps being reported
+		if (!report.spike)
+			gFrame.averageAllocations = gFrame.frames == 0 ? count : gFrame.averageAllocations * 0.95 + count * 0.05;
+		++gFrame.frames;
+		return report;
+	}
+
+	std::string AllocTracker::summary(size_t topSites)
+	{
+		if (!kEnabled) return "Allocation tracking is compiled out (configure with -DLUSTER_TRACK_ALLOCATIONS=ON)";
+
+		std::string out;
+		auto it = std::back_inserter(out);
+		fmt::format_to(it, "Heap by subsystem ({} allocations, ", gAllocations.load(std::memory_order_relaxed));
+		formatBytes(it, gBytes.load(std::memory_order_relaxed));
+		fmt::format_to(it, " total)\n  {:<11} {:>12} {:>9} {:>12} {:>12} {:>12}\n", "tag", "live", "blocks", "peak",
+		               "custom", "custom peak");
+		for (size_t i = 0; i < kTagCount; ++i)
+		{
+			const AllocTagStats s = stats(static_cast<AllocTag>(i));
+			if (s.totalAllocations == 0 && s.customPeakBytes == 0) continue;
+			std::string cells[4];
+			const uint64_t values[4] = {s.liveBytes, s.peakBytes, s.customBytes, s.customPeakBytes};
+			for (size_t c = 0; c < 4; ++c) formatBytes(std::back_inserter(cells[c]), values[c]);
+			fmt::format_to(it, "  {:<11} {:>12} {:>9} {:>12} {:>12} {:>12}\n", toString(static_cast<AllocTag>(i)),
+			               cells[0], s.liveCount, cells[1], cells[2], cells[3]);
+		}
+
+		out += "Allocation sizes (count per size class)\n";
+		for (size_t i = 0; i < kSizeClasses; ++i)
+		{
+			const uint64_t count = gSizeClasses[i].load(std::memory_order_relaxed);
+			if (count == 0) continue;
+			const uint64_t upper = i == 0 ? 0 : (1ull << i) - 1;
+			fmt::format_to(it, "  <= {:>10} B: {}\n", upper, count);
+		}
+
+		struct SiteRow
+		{
+			uintptr_t address;
+			uint64_t count;
+			uint64_t bytes;
+		};
+		std::vector<SiteRow> rows;
+		for (const Site& site : gSites)
+			if (const uintptr_t address = site.address.load(std::memory_order_relaxed))
+				rows.push_back({address, site.count.load(std::memory_order_relaxed),
+				                site.bytes.load(std::memory_order_relaxed)});
+		const size_t shown = std::min(topSites, rows.size());
+		std::partial_sort(rows.begin(), rows.begin() + static_cast<std::ptrdiff_t>(shown), rows.end(),
+		                  [](const SiteRow& a, const SiteRow& b) { return a.count > b.count; });
+		fmt::format_to(it, "Top {} of {} allocation sites (return address of operator new)\n", shown, rows.size());
+		for (size_t i = 0; i < shown; ++i)
+		{
+			fmt::format_to(it, "  {:#018x} {:>10} allocs  ", rows[i].address, rows[i].count);
+			formatBytes(it, rows[i].bytes);
+			out += '\n';
+		}
+		if (const uint64_t other = gOtherSiteCount.load(std::memory_order_relaxed))
+			fmt::format_to(it, "  (site table full: {} allocations not attributed)\n", other);
+		return out;
+	}
+}
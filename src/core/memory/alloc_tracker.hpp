@@ -0,0 +1,97 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// Per-subsystem accounting in the global operator new/delete (heap_counter.cpp). Opt-in for soak tests and
+// memory investigations (-DLUSTER_TRACK_ALLOCATIONS=ON); compiled out, tag scopes expand to nothing.
+#ifndef LUSTER_TRACK_ALLOCATIONS
+#define LUSTER_TRACK_ALLOCATIONS 0
+#endif
+
+namespace luster
+{
+	// Subsystem an allocation is charged to: the innermost LUSTER_ALLOC_TAG scope of the allocating thread
+	enum class AllocTag : uint8_t { Untagged, Renderer, Assets, Logging, Platform, Simulation, Count };
+
+	const char* toString(AllocTag tag);
+
+	struct AllocTagStats
+	{
+		uint64_t liveBytes = 0;
+		uint64_t liveCount = 0;
+		uint64_t peakBytes = 0; // high-water mark of liveBytes
+		uint64_t totalAllocations = 0;
+		uint64_t totalBytes = 0;
+		// Handed out by LinearArena/PoolAllocator instances created under the tag (their blocks count above too)
+		uint64_t customBytes = 0;
+		uint64_t customPeakBytes = 0;
+	};
+
+	struct AllocFrameReport
+	{
+		uint64_t allocations = 0; // all threads, since the previous endFrame()
+		uint64_t bytes = 0;
+		bool spike = false; // far above the running average of recent frames
+	};
+
+	// Counters are relaxed atomics in fixed tables: the hooks never allocate or lock, so every thread can be
+	// tracked at a few atomic adds per allocation. Allocation sites are the return addresses of operator new,
+	// bucketed in an open-addressed table (sites beyond kMaxSites are counted as "other").
+	class AllocTracker
+	{
+	public:
+		static constexpr bool kEnabled = LUSTER_TRACK_ALLOCATIONS != 0;
+		static constexpr size_t kMaxSites = 4096;
+		static constexpr size_t kHeaderSize = 16; // in front of every tracked block: size, tag, offset to base
+		// A frame is a spike with kSpikeFactor times the average allocation count and at least kSpikeMinAllocations
+		static constexpr double kSpikeFactor = 4.0;
+		static constexpr uint64_t kSpikeMinAllocations = 64;
+		static constexpr uint32_t kSpikeWarmupFrames = 30;
+
+		static AllocTag currentTag() noexcept;
+		static AllocTagStats stats(AllocTag tag) noexcept;
+		// Custom allocators report bytes they hand out (positive) and take back (negative)
+		static void noteCustom(AllocTag tag, int64_t bytes) noexcept;
+		// Once per frame from one thread (the recording thread); the first call only records the baseline and
+		// reports nothing
+		static AllocFrameReport endFrame() noexcept;
+		// Per-tag table, size classes and the `topSites` busiest call sites (raw addresses: resolve with
+		// addr2line/llvm-symbolizer, or the debugger's disassembly on Windows)
+		static std::string summary(size_t topSites = 16);
+
+		// Called by the operator new/delete replacements: `base` has headerSize (>= kHeaderSize) bytes in front of
+		// the user block; onFree returns the base pointer to release
+		static void* onAllocate(void* base, size_t size, size_t headerSize, void* site) noexcept;
+		static void* onFree(void* p) noexcept;
+
+	private:
+		friend class AllocTagScope;
+		static AllocTag exchangeTag(AllocTag tag) noexcept;
+	};
+
+	class AllocTagScope
+	{
+	public:
+		explicit AllocTagScope(AllocTag tag) noexcept : previous_(AllocTracker::exchangeTag(tag)) {}
+		~AllocTagScope() { AllocTracker::exchangeTag(previous_); }
+
+		AllocTagScope(const AllocTagScope&) = delete;
+		AllocTagScope& operator=(const AllocTagScope&) = delete;
+
+	private:
+		AllocTag previous_;
+	};
+
+#define LUSTER_ALLOC_CONCAT_INNER(a, b) a##b
+#define LUSTER_ALLOC_CONCAT(a, b) LUSTER_ALLOC_CONCAT_INNER(a, b)
+
+#if LUSTER_TRACK_ALLOCATIONS
+	// LUSTER_ALLOC_TAG(Assets): charges the rest of the enclosing scope's allocations on this thread to the tag
+#define LUSTER_ALLOC_TAG(tag) \
+	::luster::AllocTagScope LUSTER_ALLOC_CONCAT(_luster_alloc_tag_, __LINE__)(::luster::AllocTag::tag)
+#else
+#define LUSTER_ALLOC_TAG(tag) do {} while(0)
+#endif
+}
@@ -0,0 +1,50 @@
+#pragma once
+
+#include "core/memory/memory_resource.hpp"
+#include <algorithm>
+#include <array>
+
+namespace luster
+{
+	// One LinearArena per frame in flight, for CPU data that must live as long as its frame (callbacks run at
+	// submit, data a deferred step reads back). begin(slot) resets the slot's arena: call it once that slot's
+	// previous frame has retired (after its fence wait), never while the frame may still be referenced.
+	class FrameArenas
+	{
+	public:
+		static constexpr uint32_t kMaxSlots = 3; // CommandContext::kMaxFramesInFlight
+
+		FrameArenas() = default;
+		FrameArenas(const FrameArenas&) = delete; // the resources point into this object
+		FrameArenas& operator=(const FrameArenas&) = delete;
+
+		void reserve(size_t bytesPerSlot)
+		{
+			for (auto& arena : arenas_) arena.reserve(bytesPerSlot);
+		}
+
+		LinearArena& begin(uint32_t slot)
+		{
+			current_ = slot % kMaxSlots;
+			arenas_[current_].reset();
+			return arenas_[current_];
+		}
+
+		LinearArena& current() { return arenas_[current_]; }
+		std::pmr::memory_resource* resource() { return &resources_[current_]; }
+
+		size_t highWater() const
+		{
+			size_t h = 0;
+			for (const auto& arena : arenas_) h = std::max(h, arena.highWater());
+			return h;
+		}
+		size_t capacity() const { return arenas_[0].capacity(); }
+
+	private:
+		std::array<LinearArena, kMaxSlots> arenas_{};
+		std::array<ArenaResource, kMaxSlots> resources_{ArenaResource(arenas_[0]), ArenaResource(arenas_[1]),
+		                                                ArenaResource(arenas_[2])};
+		uint32_t current_ = 0;
+	};
+}
@@ -0,0 +1,129 @@
+#include "core/memory/heap_counter.hpp"
+#include "core/memory/alloc_tracker.hpp"
+#include <algorithm>
+#include <cstdlib>
+#include <new>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#define LUSTER_RETURN_ADDRESS() _ReturnAddress()
+#else
+#define LUSTER_RETURN_ADDRESS() __builtin_return_address(0)
+#endif
+
+namespace luster
+{
+#if LUSTER_COUNT_ALLOCATIONS
+	static thread_local uint64_t tlsAllocations = 0;
+
+	uint64_t threadHeapAllocations() noexcept { return tlsAllocations; }
+
+	static void* countedAlloc(std::size_t size, [[maybe_unused]] void* site) noexcept
+	{
+		++tlsAllocations;
+#if LUSTER_TRACK_ALLOCATIONS
+		return AllocTracker::onAllocate(std::malloc(size + AllocTracker::kHeaderSize), size, AllocTracker::kHeaderSize,
+		                                site);
+#else
+		return std::malloc(size ? size : 1);
+#endif
+	}
+
+	static void* countedAlignedAlloc(std::size_t size, std::size_t align, [[maybe_unused]] void* site) noexcept
+	{
+		++tlsAllocations;
+		// Tracked: a whole alignment unit in front keeps the user block aligned and holds the header
+		const std::size_t header = LUSTER_TRACK_ALLOCATIONS ? std::max(align, AllocTracker::kHeaderSize) : 0;
+		const std::size_t total = std::max<std::size_t>(size + header, 1);
+#if defined(_MSC_VER)
+		void* base = _aligned_malloc(total, align);
+#else
+		// aligned_alloc wants a size that is a multiple of the alignment
+		void* base = std::aligned_alloc(align, (total + align - 1) / align * align);
+#endif
+#if LUSTER_TRACK_ALLOCATIONS
+		return AllocTracker::onAllocate(base, size, header, site);
+#else
+		return base;
+#endif
+	}
+
+	static void countedFree(void* p) noexcept
+	{
+		if (!p) return;
+#if LUSTER_TRACK_ALLOCATIONS
+		p = AllocTracker::onFree(p);
+#endif
+		std::free(p);
+	}
+
+	static void alignedFree(void* p) noexcept
+	{
+		if (!p) return;
+#if LUSTER_TRACK_ALLOCATIONS
+		p = AllocTracker::onFree(p);
+#endif
+#if defined(_MSC_VER)
+		_aligned_free(p);
+#else
+		std::free(p);
+#endif
+	}
+#else
+	uint64_t threadHeapAllocations() noexcept { return 0; }
+#endif
+}
+
+#if LUSTER_COUNT_ALLOCATIONS
+// Replacements of the global allocation functions; linked in with this object file, which every counter user
+// pulls in through threadHeapAllocations(). The return address is the allocation site for the tracker.
+void* operator new(std::size_t size)
+{
+	if (void* p = luster::countedAlloc(size, LUSTER_RETURN_ADDRESS())) return p;
+	throw std::bad_alloc();
+}
+void* operator new[](std::size_t size)
+{
+	if (void* p = luster::countedAlloc(size, LUSTER_RETURN_ADDRESS())) return p;
+	throw std::bad_alloc();
+}
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept
+{
+	return luster::countedAlloc(size, LUSTER_RETURN_ADDRESS());
+}
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept
+{
+	return luster::countedAlloc(size, LUSTER_RETURN_ADDRESS());
+}
+void* operator new(std::size_t size, std::align_val_t align)
+{
+	if (void* p = luster::countedAlignedAlloc(size, static_cast<std::size_t>(align), LUSTER_RETURN_ADDRESS())) return p;
+	throw std::bad_alloc();
+}
+void* operator new[](std::size_t size, std::align_val_t align)
+{
+	if (void* p = luster::countedAlignedAlloc(size, static_cast<std::size_t>(align), LUSTER_RETURN_ADDRESS())) return p;
+	throw std::bad_alloc();
+}
+void* operator new(std::size_t size, std::align_val_t align, const std::nothrow_t&) noexcept
+{
+	return luster::countedAlignedAlloc(size, static_cast<std::size_t>(align), LUSTER_RETURN_ADDRESS());
+}
+void* operator new[](std::size_t size, std::align_val_t align, const std::nothrow_t&) noexcept
+{
+	return luster::countedAlignedAlloc(size, static_cast<std::size_t>(align), LUSTER_RETURN_ADDRESS());
+}
+
+void operator delete(void* p) noexcept { luster::countedFree(p); }
+void operator delete[](void* p) noexcept { luster::countedFree(p); }
+void operator delete(void* p, std::size_t) noexcept { luster::countedFree(p); }
+void operator delete[](void* p, std::size_t) noexcept { luster::countedFree(p); }
+void operator delete(void* p, const std::nothrow_t&) noexcept { luster::countedFree(p); }
+void operator delete[](void* p, const std::nothrow_t&) noexcept { luster::countedFree(p); }
+void operator delete(void* p, std::align_val_t) noexcept { luster::alignedFree(p); }
+void operator delete[](void* p, std::align_val_t) noexcept { luster::alignedFree(p); }
+void operator delete(void* p, std::size_t, std::align_val_t) noexcept { luster::alignedFree(p); }
+void operator delete[](void* p, std::size_t, std::align_val_t) noexcept { luster::alignedFree(p); }
+void operator delete(void* p, std::align_val_t, const std::nothrow_t&) noexcept { luster::alignedFree(p); }
+void operator delete[](void* p, std::align_val_t, const std::nothrow_t&) noexcept { luster::alignedFree(p); }
+#endif
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <cstdint>
+
+// Global operator new/delete count allocations per thread (on in Debug builds, see src/core/CMakeLists.txt)
+#ifndef LUSTER_COUNT_ALLOCATIONS
+#define LUSTER_COUNT_ALLOCATIONS 0
+#endif
+#ifndef LUSTER_TRACK_ALLOCATIONS
+#define LUSTER_TRACK_ALLOCATIONS 0
+#endif
+// The allocation tracker (alloc_tracker.hpp) hooks the same replacements, so it implies counting
+#if LUSTER_TRACK_ALLOCATIONS && !LUSTER_COUNT_ALLOCATIONS
+#undef LUSTER_COUNT_ALLOCATIONS
+#define LUSTER_COUNT_ALLOCATIONS 1
+#endif
+
+namespace luster
+{
+	// Heap allocations made by the calling thread so far; always 0 when counting is compiled out
+	uint64_t threadHeapAllocations() noexcept;
+	inline constexpr bool kHeapCountingEnabled = LUSTER_COUNT_ALLOCATIONS != 0;
+
+	// Counts the calling thread's global heap allocations between construction and allocations()
+	class HeapAllocationScope
+	{
+	public:
+		HeapAllocationScope() noexcept : start_(threadHeapAllocations()) {}
+		uint64_t allocations() const noexcept { return threadHeapAllocations() - start_; }
+
+	private:
+		uint64_t start_;
+	};
+}
@@ -0,0 +1,111 @@
+#pragma once
+
+#include "core/memory/alloc_tracker.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace luster
+{
+	// Bump allocator over one fixed block. Allocation is a pointer increment, reset() frees everything at
+	// once; nothing is destroyed, so only trivially destructible types may live here.
+	// Throws std::bad_alloc when the block is exhausted (size it for the worst frame).
+	class LinearArena
+	{
+	public:
+		LinearArena() = default;
+		explicit LinearArena(size_t capacity) { reserve(capacity); }
+
+		LinearArena(const LinearArena&) = delete;
+		LinearArena& operator=(const LinearArena&) = delete;
+		// The moved-from arena is left empty
+		LinearArena(LinearArena&& other) noexcept { *this = std::move(other); }
+		LinearArena& operator=(LinearArena&& other) noexcept
+		{
+			if (this == &other) return *this;
+			track(-static_cast<int64_t>(offset_));
+			data_ = std::move(other.data_);
+			capacity_ = std::exchange(other.capacity_, 0);
+			offset_ = std::exchange(other.offset_, 0);
+			highWater_ = std::exchange(other.highWater_, 0);
+#if LUSTER_TRACK_ALLOCATIONS
+			tag_ = other.tag_; // the moved allocations stay charged where they were
+#endif
+			return *this;
+		}
+		~LinearArena() { track(-static_cast<int64_t>(offset_)); }
+
+		// Replaces the block (invalidates every allocation)
+		void reserve(size_t capacity)
+		{
+			track(-static_cast<int64_t>(offset_));
+			data_ = std::make_unique<std::byte[]>(capacity);
+			capacity_ = capacity;
+			offset_ = 0;
+		}
+
+		void* allocate(size_t size, size_t align = alignof(std::max_align_t))
+		{
+			const uintptr_t base = reinterpret_cast<uintptr_t>(data_.get());
+			const uintptr_t aligned = (base + offset_ + (align - 1)) & ~static_cast<uintptr_t>(align - 1);
+			const size_t end = static_cast<size_t>(aligned - base) + size;
+			if (end > capacity_) throw std::bad_alloc();
+			track(static_cast<int64_t>(end - offset_));
+			offset_ = end;
+			if (offset_ > highWater_) highWater_ = offset_;
+			return reinterpret_cast<void*>(aligned);
+		}
+
+		template <class T>
+		T* allocArray(size_t count)
+		{
+			static_assert(std::is_trivially_destructible_v<T>, "LinearArena never runs destructors");
+			return static_cast<T*>(allocate(sizeof(T) * count, alignof(T)));
+		}
+
+		template <class T, class... Args>
+		T* make(Args&&... args)
+		{
+			static_assert(std::is_trivially_destructible_v<T>, "LinearArena never runs destructors");
+			return ::new (allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+		}
+
+		void reset()
+		{
+			track(-static_cast<int64_t>(offset_));
+			offset_ = 0;
+		}
+		// Stack-style release: rewind(marker()) frees everything allocated after the marker was taken
+		size_t marker() const { return offset_; }
+		void rewind(size_t marker)
+		{
+			if (marker >= offset_) return;
+			track(-static_cast<int64_t>(offset_ - marker));
+			offset_ = marker;
+		}
+
+		size_t used() const { return offset_; }
+		size_t capacity() const { return capacity_; }
+		size_t highWater() const { return highWater_; }
+
+	private:
+		// Bytes handed out, for the allocation tracker's custom-allocator columns; nothing when compiled out
+		void track([[maybe_unused]] int64_t bytes) const noexcept
+		{
+#if LUSTER_TRACK_ALLOCATIONS
+			if (bytes) AllocTracker::noteCustom(tag_, bytes);
+#endif
+		}
+
+		std::unique_ptr<std::byte[]> data_{};
+		size_t capacity_ = 0;
+		size_t offset_ = 0;
+		size_t highWater_ = 0;
+#if LUSTER_TRACK_ALLOCATIONS
+		AllocTag tag_ = AllocTracker::currentTag();
+#endif
+	};
+}
@@ -0,0 +1,52 @@
+#pragma once
+
+#include "core/memory/linear_arena.hpp"
+#include "core/memory/pool_allocator.hpp"
+#include <memory_resource>
+
+namespace luster
+{
+	// std::pmr adapters, so standard containers can draw from the engine allocators:
+	//   std::pmr::vector<VkImageMemoryBarrier> barriers(scratch.resource());
+
+	// Bump allocation from a LinearArena; deallocate is a no-op (memory returns with the arena's reset/rewind).
+	// Growing containers leave their old buffers behind: reserve() up front where the size is known.
+	class ArenaResource final : public std::pmr::memory_resource
+	{
+	public:
+		explicit ArenaResource(LinearArena& arena) : arena_(&arena) {}
+
+	private:
+		void* do_allocate(size_t bytes, size_t align) override { return arena_->allocate(bytes, align); }
+		void do_deallocate(void*, size_t, size_t) override {}
+		bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override { return this == &other; }
+
+		LinearArena* arena_;
+	};
+
+	// Node containers (std::pmr::list/map/unordered_map) over a PoolAllocator: requests that fit a block come
+	// from the pool, larger ones (bucket arrays) go to `upstream`
+	class PoolResource final : public std::pmr::memory_resource
+	{
+	public:
+		explicit PoolResource(PoolAllocator& pool,
+		                      std::pmr::memory_resource* upstream = std::pmr::new_delete_resource())
+			: pool_(&pool), upstream_(upstream) {}
+
+	private:
+		void* do_allocate(size_t bytes, size_t align) override
+		{
+			if (pool_->fits(bytes, align)) return pool_->allocate();
+			return upstream_->allocate(bytes, align);
+		}
+		void do_deallocate(void* p, size_t bytes, size_t align) override
+		{
+			if (pool_->fits(bytes, align)) pool_->deallocate(p);
+			else upstream_->deallocate(p, bytes, align);
+		}
+		bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override { return this == &other; }
+
+		PoolAllocator* pool_;
+		std::pmr::memory_resource* upstream_;
+	};
+}
@@ -0,0 +1,94 @@
+#pragma once
+
+#include "core/memory/alloc_tracker.hpp"
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <vector>
+
+namespace luster
+{
+	// Fixed-size blocks from chunks of `blocksPerChunk`, recycled through an intrusive free list: allocate and
+	// deallocate are a pointer pop/push. Chunks are only released by the destructor, so after warm-up the pool
+	// never touches the global heap. Not thread-safe (one pool per owner/thread).
+	class PoolAllocator
+	{
+	public:
+		PoolAllocator(size_t blockSize, size_t blockAlign = alignof(std::max_align_t), size_t blocksPerChunk = 64)
+			: align_(std::max(blockAlign, alignof(void*))),
+			  blockSize_((std::max(blockSize, sizeof(void*)) + align_ - 1) / align_ * align_),
+			  blocksPerChunk_(std::max<size_t>(blocksPerChunk, 1)) {}
+
+		PoolAllocator(const PoolAllocator&) = delete;
+		PoolAllocator& operator=(const PoolAllocator&) = delete;
+		~PoolAllocator() { track(-static_cast<int64_t>(live_)); }
+
+		void* allocate()
+		{
+			if (!free_) grow();
+			void* p = free_;
+			free_ = *static_cast<void**>(free_);
+			++live_;
+			track(1);
+			return p;
+		}
+
+		void deallocate(void* p)
+		{
+			if (!p) return;
+			*static_cast<void**>(p) = free_;
+			free_ = p;
+			--live_;
+			track(-1);
+		}
+
+		// Allocates chunks until `blocks` are available without growing
+		void reserve(size_t blocks)
+		{
+			while (capacity() - live_ < blocks) grow();
+		}
+
+		bool fits(size_t bytes, size_t align) const { return bytes <= blockSize_ && align <= align_; }
+		size_t blockSize() const { return blockSize_; }
+		size_t live() const { return live_; }
+		size_t capacity() const { return chunks_.size() * blocksPerChunk_; }
+
+	private:
+		struct ChunkDeleter
+		{
+			std::align_val_t align;
+			void operator()(std::byte* p) const { ::operator delete[](p, align); }
+		};
+
+		void track([[maybe_unused]] int64_t blocks) const noexcept
+		{
+#if LUSTER_TRACK_ALLOCATIONS
+			if (blocks) AllocTracker::noteCustom(tag_, blocks * static_cast<int64_t>(blockSize_));
+#endif
+		}
+
+		void grow()
+		{
+			auto* chunk = static_cast<std::byte*>(::operator new[](blockSize_ * blocksPerChunk_, std::align_val_t(align_)));
+			chunks_.emplace_back(chunk, ChunkDeleter{std::align_val_t(align_)});
+			// Thread the new blocks onto the free list, lowest address first
+			for (size_t i = blocksPerChunk_; i-- > 0;)
+			{
+				void* block = chunk + i * blockSize_;
+				*static_cast<void**>(block) = free_;
+				free_ = block;
+			}
+		}
+
+		size_t align_;
+		size_t blockSize_;
+		size_t blocksPerChunk_;
+		std::vector<std::unique_ptr<std::byte[], ChunkDeleter>> chunks_{};
+		void* free_ = nullptr;
+		size_t live_ = 0;
+#if LUSTER_TRACK_ALLOCATIONS
+		AllocTag tag_ = AllocTracker::currentTag(); // where the pool was created
+#endif
+	};
+}
@@ -0,0 +1,15 @@
+#include "core/memory/scratch.hpp"
+
+namespace luster
+{
+	static LinearArena& threadScratch()
+	{
+		thread_local LinearArena arena(ScratchScope::kStackBytes);
+		return arena;
+	}
+
+	ScratchScope::ScratchScope()
+		: arena_(threadScratch()), marker_(arena_.marker()), resource_(arena_) {}
+
+	size_t ScratchScope::threadUsed() { return threadScratch().used(); }
+}
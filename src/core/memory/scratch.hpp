@@ -0,0 +1,37 @@
+#pragma once
+
+#include "core/memory/memory_resource.hpp"
+
+namespace luster
+{
+	// Per-thread scratch stack for temporaries that die with the calling function (barrier lists, query results,
+	// string formatting). Each thread's arena is allocated on its first use and reused for the life of the thread.
+	// ScratchScope marks the stack on entry and rewinds on exit, so scopes nest like the call stack. Memory from a
+	// scope must not escape it, and an inner scope must end before the outer one allocates again.
+	class ScratchScope
+	{
+	public:
+		static constexpr size_t kStackBytes = 1u << 20; // per thread; throws std::bad_alloc beyond
+
+		ScratchScope();
+		~ScratchScope() { arena_.rewind(marker_); }
+
+		ScratchScope(const ScratchScope&) = delete;
+		ScratchScope& operator=(const ScratchScope&) = delete;
+
+		void* allocate(size_t size, size_t align = alignof(std::max_align_t)) { return arena_.allocate(size, align); }
+		template <class T>
+		T* allocArray(size_t count) { return arena_.allocArray<T>(count); }
+
+		// For std::pmr containers; valid until the scope ends
+		std::pmr::memory_resource* resource() { return &resource_; }
+
+		// Bytes in use by all open scopes of the calling thread
+		static size_t threadUsed();
+
+	private:
+		LinearArena& arena_;
+		size_t marker_;
+		ArenaResource resource_;
+	};
+}
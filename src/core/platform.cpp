@@ -39,6 +39,16 @@ namespace luster
 		{
 			SDL_Delay(static_cast<Uint32>(milliseconds));
 		}
+
+		void sleepNs(uint64_t nanoseconds)
+		{
+			SDL_DelayNS(static_cast<Uint64>(nanoseconds));
+		}
+
+		void waitEventsMs(uint32_t timeoutMs)
+		{
+			SDL_WaitEventTimeout(nullptr, static_cast<Sint32>(timeoutMs));
+		}
 	}
 }
 
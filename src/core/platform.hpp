@@ -15,6 +15,10 @@ namespace luster
 		void setCursorVisible(bool visible);
 		// 睡眠毫秒
 		void sleepMs(uint32_t milliseconds);
+		// 高精度睡眠（纳秒；实际时长取决于系统调度，可能更长）
+		void sleepNs(uint64_t nanoseconds);
+		// 阻塞直到有事件到达或超时（不取出事件），用于后台节流
+		void waitEventsMs(uint32_t timeoutMs);
 	}
 }
 
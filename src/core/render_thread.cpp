@@ -0,0 +1,81 @@
+#include "core/render_thread.hpp"
+#include "core/renderer.hpp"
+#include "core/utils/profiler.hpp"
+#include "core/utils/log.hpp"
+#include <algorithm>
+#include <exception>
+
+namespace luster
+{
+	void RenderThread::start(Renderer& renderer, Window* window, size_t arenaBytes)
+	{
+		if (running()) return;
+		for (auto& arena : arenas_) arena.reserve(arenaBytes);
+		produced_ = 0;
+		consumed_.store(0, std::memory_order_relaxed);
+		failed_.store(false, std::memory_order_relaxed);
+		thread_ = std::thread([this, &renderer, window] { run(renderer, window); });
+	}
+
+	void RenderThread::stop()
+	{
+		if (!running()) return;
+		queue_.push(nullptr);
+		thread_.join();
+		spdlog::info("Render thread stopped after {} frames (snapshot arena high water {} / {} bytes)",
+		             consumed_.load(std::memory_order_relaxed),
+		             std::max(arenas_[0].highWater(), arenas_[1].highWater()), arenas_[0].capacity());
+	}
+
+	LinearArena& RenderThread::beginFrame()
+	{
+		PROFILE_SCOPE("RenderThread::beginFrame");
+		// Snapshot N reuses the arena of snapshot N-2: wait until that one has been recorded
+		if (produced_ >= arenas_.size())
+		{
+			const uint64_t needed = produced_ - arenas_.size() + 1;
+			uint64_t done = consumed_.load(std::memory_order_acquire);
+			while (done < needed)
+			{
+				consumed_.wait(done, std::memory_order_acquire);
+				done = consumed_.load(std::memory_order_acquire);
+			}
+		}
+		LinearArena& arena = arenas_[produced_ % arenas_.size()];
+		arena.reset();
+		return arena;
+	}
+
+	bool RenderThread::submit(const FrameSnapshot* snapshot)
+	{
+		if (failed()) return false;
+		PROFILE_SCOPE("RenderThread::submit");
+		queue_.push(snapshot);
+		++produced_;
+		return true;
+	}
+
+	void RenderThread::run(Renderer& renderer, Window* window)
+	{
+		Profiler::setThreadName("render");
+		while (const FrameSnapshot* snapshot = queue_.pop())
+		{
+			// After a failure keep draining so the game thread never blocks on a full queue
+			if (!failed())
+			{
+				try
+				{
+					if (!renderer.renderSnapshot(*snapshot, window))
+						failed_.store(true, std::memory_order_release);
+				}
+				catch (const std::exception& ex)
+				{
+					spdlog::error("Render thread: {}", ex.what());
+					failed_.store(true, std::memory_order_release);
+				}
+			}
+			consumed_.fetch_add(1, std::memory_order_release);
+			consumed_.notify_one();
+		}
+	}
+}
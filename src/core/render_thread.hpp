@@ -0,0 +1,53 @@
+#pragma once
+
+#include "core/frame_snapshot.hpp"
+#include "core/memory/linear_arena.hpp"
+#include "core/utils/spsc_queue.hpp"
+#include <array>
+#include <atomic>
+#include <thread>
+
+namespace luster
+{
+	class Renderer;
+	class Window;
+
+	// Pipelined rendering: the game thread builds FrameSnapshots and hands them over through a one-slot
+	// SPSC queue; this thread records, submits and presents them. Snapshot memory alternates between two
+	// arenas, so at most one frame is queued while another is being recorded (one frame of latency).
+	// While running, only this thread may touch the renderer's GPU objects.
+	class RenderThread
+	{
+	public:
+		static constexpr size_t kDefaultArenaBytes = 256 * 1024;
+
+		RenderThread() = default;
+		~RenderThread() { stop(); }
+		RenderThread(const RenderThread&) = delete;
+		RenderThread& operator=(const RenderThread&) = delete;
+
+		// window == nullptr renders headless
+		void start(Renderer& renderer, Window* window, size_t arenaBytes = kDefaultArenaBytes);
+		// Drains queued frames, then joins. Safe to call when not running.
+		void stop();
+
+		// Game thread: arena for the next snapshot. Blocks until the frame that last used it was rendered.
+		LinearArena& beginFrame();
+		// Game thread: queues the snapshot built in beginFrame()'s arena (blocks while one is still queued).
+		// False once the render thread failed; the caller should stop.
+		bool submit(const FrameSnapshot* snapshot);
+
+		bool running() const { return thread_.joinable(); }
+		bool failed() const { return failed_.load(std::memory_order_acquire); }
+
+	private:
+		void run(Renderer& renderer, Window* window);
+
+		SpscQueue<const FrameSnapshot*, 1> queue_{}; // nullptr = stop
+		std::array<LinearArena, 2> arenas_{};
+		uint64_t produced_ = 0; // snapshots handed over (game thread only)
+		std::atomic<uint64_t> consumed_{0}; // snapshots fully recorded, their arena is free again
+		std::atomic<bool> failed_{false};
+		std::thread thread_{};
+	};
+}
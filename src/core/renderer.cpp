@@ -5,14 +5,23 @@
 #include "core/gfx/render_pass.hpp"
 #include "core/gfx/pipeline.hpp"
 #include "core/gfx/command_context.hpp"
+#include "core/gfx/async_compute.hpp"
+#include "core/gfx/gpu_allocator.hpp"
 #include "core/gfx/framebuffers.hpp"
 #include "core/gfx/image.hpp"
 #include "core/gfx/buffer.hpp"
 #include "core/gfx/vertex_layout.hpp"
 #include "core/gfx/descriptor.hpp"
 #include "core/gfx/mesh.hpp"
+#include "core/memory/alloc_tracker.hpp"
+#include "core/memory/heap_counter.hpp"
+#include <algorithm>
+#include <array>
+#include <cassert>
 #include <cstdint>
 #include <cstring>
+#include <filesystem>
+#include <memory>
 #include <stdexcept>
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
@@ -25,46 +34,54 @@ namespace luster
 {
 	// 旧的静态辅助函数均已下沉到 gfx 层或不再需要，移除以减少编译警告
 
+	static constexpr const char* kPushVertexShader = "shaders/triangle_push.vert.spv";
+
+	// Frustum planes (xyz = inward normal, w = distance) from a [0,1]-depth view-projection matrix
+	static std::array<glm::vec4, 6> frustumPlanes(const glm::mat4& m)
+	{
+		const glm::vec4 r0{m[0][0], m[1][0], m[2][0], m[3][0]};
+		const glm::vec4 r1{m[0][1], m[1][1], m[2][1], m[3][1]};
+		const glm::vec4 r2{m[0][2], m[1][2], m[2][2], m[3][2]};
+		const glm::vec4 r3{m[0][3], m[1][3], m[2][3], m[3][3]};
+		std::array<glm::vec4, 6> planes{r3 + r0, r3 - r0, r3 + r1, r3 - r1, r2, r3 - r2};
+		for (auto& p : planes) p /= glm::length(glm::vec3(p));
+		return planes;
+	}
+
+	static bool sphereVisible(const std::array<glm::vec4, 6>& planes, const glm::vec3& center, float radius)
+	{
+		for (const auto& p : planes)
+			if (glm::dot(glm::vec3(p), center) + p.w < -radius) return false;
+		return true;
+	}
+
 	Renderer::Renderer() = default;
 	Renderer::~Renderer() { cleanup(); }
 
 	void Renderer::init(Window& window, const EngineConfig& config)
 	{
+		LUSTER_ALLOC_TAG(Renderer);
 		try
 		{
 			// Cache config
 			config_ = config;
+			headless_ = false;
+			resolveFramePolicy(config_.framePolicy);
 			// Create device (includes instance, surface, physical & logical device)
 			createInstance(window, config_.device);
 			spdlog::info("Device initialized");
 
 			// Create swapchain
 			createSwapchainAndViews(window);
-			spdlog::info("Swapchain created: {} images, {}x{}, format {}",
+			publishExtent();
+			spdlog::info("Swapchain created: {} images, {}x{}, format {}, present {}, policy {}",
 			             static_cast<int>(swapchain_->imageViews().size()),
 			             swapchain_->extent().width, swapchain_->extent().height,
-			             static_cast<int>(swapchain_->imageFormat()));
+			             static_cast<int>(swapchain_->imageFormat()), gfx::toString(swapchain_->presentMode()),
+			             toString(framePolicy_));
 
-			createRenderPass();
-			createFramebuffers();
-			createGeometry();
-			createDescriptors();
-			createCommandsAndSync();
-			gpuProfiler_.init(*device_);
-
-			auto now0 = std::chrono::steady_clock::now();
-			fpsLastUpdate_ = now0;
-			fpsAccumMs_ = 0.0;
-			fpsCount_ = 0;
-			// Apply FPS intervals if customized
-			cpuFps_.setReportIntervalMs(config_.fpsReportIntervalMs);
-			gpuFps_.setReportIntervalMs(config_.fpsReportIntervalMs);
-
-			// Apply camera controller params from config
-			cameraController_.setMoveSpeed(config_.cameraController.moveSpeed);
-			cameraController_.setFastMultiplier(config_.cameraController.fastMultiplier);
-			cameraController_.setSlowMultiplier(config_.cameraController.slowMultiplier);
-			cameraController_.setMouseSensitivity(config_.cameraController.mouseSensitivity);
+			initDynamicResolution();
+			initCommon();
 		}
 		catch (const std::exception& ex)
 		{
@@ -73,6 +90,72 @@ namespace luster
 		}
 	}
 
+	void Renderer::initHeadless(const EngineConfig& config)
+	{
+		LUSTER_ALLOC_TAG(Renderer);
+		try
+		{
+			config_ = config;
+			headless_ = true;
+			resolveFramePolicy(config_.framePolicy);
+			device_ = std::make_unique<gfx::Device>();
+			device_->initHeadless(config_.device);
+			createGpuAllocator();
+			spdlog::info("Device initialized (headless)");
+
+			createOffscreenTarget();
+			publishExtent();
+			const gfx::Image& target = resources_.get(offscreenColor_);
+			spdlog::info("Offscreen target created: {}x{}", target.width(), target.height());
+
+			initCommon();
+		}
+		catch (const std::exception& ex)
+		{
+			spdlog::critical("Vulkan headless initialization failed: {}", ex.what());
+			throw;
+		}
+	}
+
+	void Renderer::initCommon()
+	{
+		createScene();
+		snapshotArena_.reserve(config_.threading.snapshotArenaBytes);
+		frameArenas_.reserve(config_.memory.frameArenaBytes);
+		dynamicRendering_ = device_->dynamicRenderingEnabled();
+		spdlog::info("Render path: {}", dynamicRendering_ ? "dynamic rendering + synchronization2" : "render pass");
+		// The late latch rewrites per-draw data after recording: only possible while it lives in the UBO
+		pushConstants_ = config_.pipeline.pushConstants && !config_.latency.lateLatch;
+		// Without glslc the build only warns: fall back to the UBO shader rather than fail pipeline creation
+		if (pushConstants_ && !std::filesystem::exists(kPushVertexShader))
+		{
+			spdlog::warn("{} not found (shaders not compiled?), using the dynamic UBO path", kPushVertexShader);
+			pushConstants_ = false;
+		}
+		spdlog::info("Per-draw data: {}", pushConstants_ ? "push constants" : "dynamic UBO");
+		createRenderPass();
+		createFramebuffers();
+		createGeometry();
+		createDescriptors();
+		createCommandsAndSync();
+		gpuProfiler_.init(*device_);
+
+		auto now0 = std::chrono::steady_clock::now();
+		fpsLastUpdate_ = now0;
+		fpsAccumMs_ = 0.0;
+		fpsCount_ = 0;
+		// Apply FPS intervals if customized
+		cpuFps_.setReportIntervalMs(config_.fpsReportIntervalMs);
+		gpuFps_.setReportIntervalMs(config_.fpsReportIntervalMs);
+
+		// Apply camera controller params from config
+		cameraController_.setMoveSpeed(config_.cameraController.moveSpeed);
+		cameraController_.setFastMultiplier(config_.cameraController.fastMultiplier);
+		cameraController_.setSlowMultiplier(config_.cameraController.slowMultiplier);
+		cameraController_.setMouseSensitivity(config_.cameraController.mouseSensitivity);
+		prevSim_ = {camera_.eye(), camera_.target(), sceneTime_};
+	}
+
 	void Renderer::init(Window& window, const gfx::Device::InitParams& params)
 	{
 		EngineConfig cfg{};
@@ -90,11 +173,17 @@ namespace luster
 
 	void Renderer::update(float dt, const InputSnapshot& input)
 	{
-		// 更新相机（使用真实 dt）
-		camera_.setPerspective(glm::radians(60.0f),
-		                       static_cast<float>(swapchain_->extent().width) / static_cast<float>(swapchain_->extent().
-			                       height), 0.1f, 100.0f);
-		cameraController_.update(camera_, dt, input);
+		simulate(dt, input);
+		alpha_ = 1.0f; // variable-dt callers render the state they just produced
+	}
+
+	void Renderer::simulate(float stepDt, const InputSnapshot& input)
+	{
+		PROFILE_SCOPE("Renderer::simulate");
+		LUSTER_ALLOC_TAG(Simulation);
+		prevSim_ = {camera_.eye(), camera_.target(), sceneTime_};
+		sceneTime_ += static_cast<double>(stepDt);
+		cameraController_.update(camera_, stepDt, input);
 		// 定期打印相机位置
 		const auto now = std::chrono::steady_clock::now();
 		if (camLogLast_.time_since_epoch().count() == 0) camLogLast_ = now;
@@ -103,63 +192,483 @@ namespace luster
 		if (elapsedMs >= camLogIntervalMs_)
 		{
 			const glm::vec3& e = camera_.eye();
-			spdlog::info("Camera pos: ({:.2f}, {:.2f}, {:.2f}) | speed:{:.1f}x sens:{:.3f}",
-			             e.x, e.y, e.z,
-			             cameraController_.fastMultiplier(), cameraController_.mouseSensitivity());
+			// Deferred: only the floats are copied here, the writer thread formats them
+			Log::info("Camera pos: ({:.2f}, {:.2f}, {:.2f}) | speed:{:.1f}x sens:{:.3f}",
+			          e.x, e.y, e.z,
+			          cameraController_.fastMultiplier(), cameraController_.mouseSensitivity());
 			camLogLast_ = now;
 		}
 	}
 
-	bool Renderer::drawFrame(Window& window)
+	const FrameSnapshot* Renderer::buildSnapshot(LinearArena& arena, bool resized)
 	{
-		// Update MVP (rotation over time)
-		static auto t0 = std::chrono::steady_clock::now();
-		auto now = std::chrono::steady_clock::now();
-		float seconds = std::chrono::duration<float>(now - t0).count();
-		const glm::mat4& proj = camera_.proj();
-		//const glm::mat4& view = glm::translate(glm::mat4(1.0f), {0, 0, -1});
-		const glm::mat4& view = camera_.view();
-		glm::mat4 model = glm::rotate(glm::mat4(1.0f), seconds, glm::vec3(0, 1, 0));
-		glm::mat4 mvp = proj * view * model;
-		if (uniformBuffer_)
-		{
-			void* p = uniformBuffer_->map(*device_);
-			memcpy(p, &mvp, sizeof(mvp));
-			uniformBuffer_->unmap(*device_);
+		PROFILE_SCOPE("Renderer::buildSnapshot");
+		LUSTER_ALLOC_TAG(Renderer);
+		const VkExtent2D extent = renderExtent();
+		const float aspect = extent.height > 0 ? static_cast<float>(extent.width) / static_cast<float>(extent.height) : 1.0f;
+		constexpr float farPlane = 100.0f;
+		camera_.setPerspective(glm::radians(60.0f), aspect, 0.1f, farPlane);
+		// Blend the last two simulated states so motion stays smooth when render and simulation rates differ
+		const float a = alpha_;
+		const glm::vec3 eye = glm::mix(prevSim_.eye, camera_.eye(), a);
+		const glm::vec3 target = glm::mix(prevSim_.target, camera_.target(), a);
+		// Model rotation follows simulated time, so fixed-step runs are reproducible
+		const float seconds = static_cast<float>(prevSim_.sceneTime + (sceneTime_ - prevSim_.sceneTime) * a);
+
+		FrameSnapshot* snap = arena.make<FrameSnapshot>();
+		snap->frameIndex = snapshotCounter_++;
+		snap->view = glm::lookAt(eye, target, camera_.up());
+		snap->proj = camera_.proj();
+		snap->viewProj = snap->proj * snap->view;
+		snap->eye = eye;
+		snap->target = target;
+		snap->extent = extent;
+		snap->inputSampleTime = inputSampleTime_.time_since_epoch().count() != 0
+			                        ? inputSampleTime_
+			                        : std::chrono::steady_clock::now();
+		snap->resized = resized;
+
+		const auto maxDraws = static_cast<uint32_t>(std::min<size_t>(objects_.size(), kMaxDraws));
+		uint32_t* visible = arena.allocArray<uint32_t>(maxDraws);
+		DrawConstants* constants = arena.allocArray<DrawConstants>(maxDraws);
+		glm::mat4* models = arena.allocArray<glm::mat4>(maxDraws);
+		const auto planes = frustumPlanes(snap->viewProj);
+		const glm::mat4 spin = glm::rotate(glm::mat4(1.0f), seconds, glm::vec3(0, 1, 0));
+		// Cull into the draw list; the sort key decides submission order (opaque: state, then front-to-back)
+		drawList_.clear();
+		const glm::vec3 forward = glm::normalize(target - eye);
+		for (uint32_t i = 0; i < static_cast<uint32_t>(objects_.size()); ++i)
+		{
+			const SceneObject& obj = objects_[i];
+			if (drawList_.size() == maxDraws || !sphereVisible(planes, obj.position, obj.radius))
+			{
+				++snap->culledCount;
+				continue;
+			}
+			// Single pipeline/material/mesh today: those fields are 0 and only depth orders the draws
+			const float depth = glm::dot(obj.position - eye, forward) / farPlane;
+			drawList_.add(sortkey::opaque(0, 0, 0, 0, depth), i);
 		}
-		else
+		if (config_.scene.sortDraws) drawList_.sort(config_.threading.drawSortThreads);
+		const auto count = static_cast<uint32_t>(drawList_.size());
+		const uint32_t* order = drawList_.order();
+		for (uint32_t d = 0; d < count; ++d)
+		{
+			const uint32_t i = order[d];
+			visible[d] = i;
+			models[d] = glm::translate(glm::mat4(1.0f), objects_[i].position) * spin;
+			constants[d].mvp = snap->viewProj * models[d];
+		}
+		snap->visibleObjects = visible;
+		snap->drawConstants = constants;
+		snap->models = models;
+		snap->drawCount = count;
+		return snap;
+	}
+
+	void Renderer::uploadDrawConstants(const FrameSnapshot& snapshot)
+	{
+		// Called after the slot's fence wait: the GPU no longer reads this slot's previous constants
+		if (!uniformBuffer_)
 		{
 			spdlog::error("uniform buffer not init");
+			return;
 		}
+		auto* dst = static_cast<uint8_t*>(resources_.get(uniformBuffer_).mapped()) + frameUboBase();
+		for (uint32_t i = 0; i < snapshot.drawCount; ++i)
+			std::memcpy(dst + i * drawStride_, &snapshot.drawConstants[i], sizeof(DrawConstants));
+	}
 
-		auto result = framebuffers_->drawFrame(
-			window, *device_, *renderPass_, *context_, *swapchain_,
-			[&](VkCommandBuffer /*cb*/, uint32_t imageIndex)
+	VkDeviceSize Renderer::frameUboBase() const
+	{
+		// Each frame slot owns a region: frames still in flight keep reading their own constants
+		return static_cast<VkDeviceSize>(context_->frameSlot()) * kMaxDraws * drawStride_;
+	}
+
+	void Renderer::lateLatch(const FrameSnapshot& snapshot)
+	{
+		PROFILE_SCOPE("Renderer::lateLatch");
+		// Peek, not capture: the next simulation step still consumes these deltas and edges for real
+		const InputSnapshot input = Input::peekSnapshot();
+		const auto now = std::chrono::steady_clock::now();
+		const float dt = std::min(std::chrono::duration<float>(now - snapshot.inputSampleTime).count(),
+		                          config_.latency.maxLatchSeconds);
+		// Display-only prediction of where the camera will be: predict() leaves the camera and the controller's
+		// look angles alone, the simulation applies the same input once more when it consumes it
+		Camera latched{};
+		latched.setViewLookAt(snapshot.eye, snapshot.target, camera_.up());
+		const Camera cam = cameraController_.predict(latched, dt, input);
+		const glm::mat4 viewProj = snapshot.proj * glm::lookAt(cam.eye(), cam.target(), cam.up());
+		// Command buffer is recorded but not submitted: the coherent mapping can still be rewritten
+		auto* dst = static_cast<uint8_t*>(resources_.get(uniformBuffer_).mapped()) + frameUboBase();
+		for (uint32_t i = 0; i < snapshot.drawCount; ++i)
+		{
+			const glm::mat4 mvp = viewProj * snapshot.models[i];
+			std::memcpy(dst + i * drawStride_, &mvp, sizeof(mvp));
+		}
+		frameInputTime_ = now;
+		frameLatched_ = true;
+	}
+
+	void Renderer::recordScene(uint32_t imageIndex, const FrameSnapshot& snapshot)
+	{
+		PROFILE_SCOPE("Renderer::recordScene");
+		if (!pushConstants_) uploadDrawConstants(snapshot);
+		gpuProfiler_.beginScope(*context_, "TrianglePass");
+		// With dynamic resolution the scene goes to the single scaled target, limited to a sub-rect
+		const VkExtent2D scene = sceneExtent();
+		if (dynamicRendering_)
+		{
+			VkClearValue clear{};
+			clear.color = {{0.05f, 0.06f, 0.09f, 1.0f}};
+			recordSceneTargetBarriers(imageIndex, true);
+			const VkImageView color = headless_ ? resources_.get(offscreenColor_).view()
+				                          : drsEnabled_ ? resources_.get(scaledColor_).view()
+				                          : swapchain_->imageViews()[imageIndex];
+			context_->beginRendering(color, resources_.get(depthImage_).view(), scene, clear);
+		}
+		else
+		{
+			const VkFramebuffer framebuffer = framebuffers_->handles()[drsEnabled_ ? 0 : imageIndex];
+			context_->beginRender(*renderPass_, framebuffer, scene, 0.05f, 0.06f, 0.09f, 1.0f);
+		}
+		context_->setViewportScissor(scene);
+		// Every draw states its full binding set; CommandContext drops what is already bound, so only the
+		// per-draw data reaches Vulkan per object: 64 bytes of push constants, or a dynamic UBO offset
+		const gfx::Pipeline& pipeline = resources_.get(pipeline_);
+		if (pushConstants_)
+		{
+			for (uint32_t i = 0; i < snapshot.drawCount; ++i)
 			{
-				gpuProfiler_.beginLabel(*context_, "TrianglePass");
-				gpuProfiler_.beginFrame(*context_);
-				context_->beginRender(*renderPass_, framebuffers_->handles()[imageIndex], swapchain_->extent(),
-				                      0.05f, 0.06f, 0.09f, 1.0f);
-				context_->bindPipeline(*pipeline_);
-				// bind mesh buffers
+				context_->bindPipeline(pipeline);
 				if (mesh_) mesh_->bind(*context_);
-				// bind descriptor set (UBO)
-				if (dset_)
-				{
-					VkDescriptorSet set = dset_->handle();
-					context_->bindDescriptorSets(pipeline_->layout(), 0, &set, 1);
-				}
-				// draw indexed
+				context_->pushConstants(pipeline.layout(), VK_SHADER_STAGE_VERTEX_BIT, snapshot.drawConstants[i]);
 				context_->drawIndexed(mesh_ ? mesh_->indexCount() : 0);
-				context_->endRender();
-				gpuProfiler_.endFrame(*context_);
-				gpuProfiler_.endLabel(*context_);
 			}
-		);
+		}
+		else if (dset_)
+		{
+			VkDescriptorSet set = dset_->handle();
+			const VkDeviceSize base = frameUboBase();
+			for (uint32_t i = 0; i < snapshot.drawCount; ++i)
+			{
+				context_->bindPipeline(pipeline);
+				if (mesh_) mesh_->bind(*context_);
+				const auto offset = static_cast<uint32_t>(base + i * drawStride_);
+				context_->bindDescriptorSets(pipeline.layout(), 0, &set, 1, &offset, 1);
+				context_->drawIndexed(mesh_ ? mesh_->indexCount() : 0);
+			}
+		}
+		context_->endRender();
+		if (dynamicRendering_) recordSceneTargetBarriers(imageIndex, false);
+		gpuProfiler_.endScope(*context_);
+		if (drsEnabled_)
+		{
+			gpuProfiler_.beginScope(*context_, "Upscale");
+			recordUpscale(imageIndex, scene, renderExtent());
+			gpuProfiler_.endScope(*context_);
+		}
+		gpuProfiler_.endFrame(*context_);
+		frameStats_.renderScale = renderScale();
+		const gfx::CommandStats& cmds = context_->stats();
+		frameStats_.commands = {cmds.issued(), cmds.skipped(), cmds.draws};
+	}
+
+	void Renderer::recordSceneTargetBarriers(uint32_t imageIndex, bool beforeRendering)
+	{
+		// What the render pass objects did implicitly: initial/final layouts and their external dependencies
+		const bool swapTarget = !headless_ && !drsEnabled_;
+		const VkImage color = headless_ ? resources_.get(offscreenColor_).image()
+			                      : drsEnabled_ ? resources_.get(scaledColor_).image()
+			                      : swapchain_->images()[imageIndex];
+		if (beforeRendering)
+		{
+			// Contents are cleared: discard them. COLOR_ATTACHMENT_OUTPUT chains onto the acquire semaphore wait;
+			// TRANSFER covers the previous frame's blit/readback of an offscreen target.
+			context_->imageBarrier(color, VK_IMAGE_ASPECT_COLOR_BIT, VK_IMAGE_LAYOUT_UNDEFINED,
+			                       VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL,
+			                       VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT | VK_PIPELINE_STAGE_2_TRANSFER_BIT,
+			                       VK_ACCESS_2_NONE, VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT,
+			                       VK_ACCESS_2_COLOR_ATTACHMENT_WRITE_BIT);
+			const VkFormat df = resources_.get(depthImage_).format();
+			const bool stencil = df == VK_FORMAT_D24_UNORM_S8_UINT || df == VK_FORMAT_D32_SFLOAT_S8_UINT ||
+				df == VK_FORMAT_D16_UNORM_S8_UINT;
+			constexpr VkPipelineStageFlags2 tests = VK_PIPELINE_STAGE_2_EARLY_FRAGMENT_TESTS_BIT |
+				VK_PIPELINE_STAGE_2_LATE_FRAGMENT_TESTS_BIT;
+			// The depth image is shared by all frames in flight: order against the previous frame's writes
+			context_->imageBarrier(resources_.get(depthImage_).image(),
+			                       VK_IMAGE_ASPECT_DEPTH_BIT | (stencil ? VK_IMAGE_ASPECT_STENCIL_BIT : 0),
+			                       VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL,
+			                       tests, VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT, tests,
+			                       VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_READ_BIT |
+			                       VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT);
+			return;
+		}
+		if (swapTarget)
+			context_->imageBarrier(color, VK_IMAGE_ASPECT_COLOR_BIT, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL,
+			                       VK_IMAGE_LAYOUT_PRESENT_SRC_KHR, VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT,
+			                       VK_ACCESS_2_COLOR_ATTACHMENT_WRITE_BIT, VK_PIPELINE_STAGE_2_NONE, VK_ACCESS_2_NONE);
+		else // upscale blit or readback source
+			context_->imageBarrier(color, VK_IMAGE_ASPECT_COLOR_BIT, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL,
+			                       VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT,
+			                       VK_ACCESS_2_COLOR_ATTACHMENT_WRITE_BIT, VK_PIPELINE_STAGE_2_TRANSFER_BIT,
+			                       VK_ACCESS_2_TRANSFER_READ_BIT);
+	}
+
+	VkExtent2D Renderer::sceneExtent() const
+	{
+		const VkExtent2D out = renderExtent();
+		if (!drsEnabled_) return out;
+		// Same scale on both axes keeps the aspect ratio, so the projection needs no change
+		const float s = drs_.scale();
+		return {std::clamp(static_cast<uint32_t>(static_cast<float>(out.width) * s + 0.5f), 1u, out.width),
+		        std::clamp(static_cast<uint32_t>(static_cast<float>(out.height) * s + 0.5f), 1u, out.height)};
+	}
+
+	void Renderer::recordUpscale(uint32_t imageIndex, VkExtent2D src, VkExtent2D dst)
+	{
+		const VkCommandBuffer cmd = context_->commandBuffer();
+		const VkImage swapImage = swapchain_->images()[imageIndex];
+		const VkImage sceneImage = resources_.get(scaledColor_).image();
+		const gfx::DeviceDispatch& vk = device_->vk();
+
+		// Swapchain image: contents are fully overwritten, so discard them (UNDEFINED → TRANSFER_DST).
+		// srcStage COLOR_ATTACHMENT_OUTPUT chains onto the acquire semaphore wait of the submit.
+		if (dynamicRendering_)
+		{
+			// recordSceneTargetBarriers(false) already moved the scene target to TRANSFER_SRC for the blit
+			context_->imageBarrier(swapImage, VK_IMAGE_ASPECT_COLOR_BIT, VK_IMAGE_LAYOUT_UNDEFINED,
+			                       VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT,
+			                       VK_ACCESS_2_NONE, VK_PIPELINE_STAGE_2_TRANSFER_BIT, VK_ACCESS_2_TRANSFER_WRITE_BIT);
+		}
+		else
+		{
+			// Render pass path (synchronization2 may be unavailable): the pass left the scene target in
+			// TRANSFER_SRC; make its color writes visible to the blit
+			VkImageMemoryBarrier pre[2]{};
+			pre[0].sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+			pre[0].srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+			pre[0].dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+			pre[0].oldLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+			pre[0].newLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+			pre[0].srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+			pre[0].dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+			pre[0].image = sceneImage;
+			pre[0].subresourceRange = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1};
+			pre[1] = pre[0];
+			pre[1].srcAccessMask = 0;
+			pre[1].dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+			pre[1].oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+			pre[1].newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+			pre[1].image = swapImage;
+			vk.CmdPipelineBarrier(cmd, VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT,
+			                      0, 0, nullptr, 0, nullptr, 2, pre);
+		}
+
+		VkImageBlit blit{};
+		blit.srcSubresource = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 0, 1};
+		blit.srcOffsets[1] = {static_cast<int32_t>(src.width), static_cast<int32_t>(src.height), 1};
+		blit.dstSubresource = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 0, 1};
+		blit.dstOffsets[1] = {static_cast<int32_t>(dst.width), static_cast<int32_t>(dst.height), 1};
+		vk.CmdBlitImage(cmd, sceneImage, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, swapImage,
+		                VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &blit, upscaleFilter_);
+
+		if (dynamicRendering_)
+		{
+			context_->imageBarrier(swapImage, VK_IMAGE_ASPECT_COLOR_BIT, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+			                       VK_IMAGE_LAYOUT_PRESENT_SRC_KHR, VK_PIPELINE_STAGE_2_TRANSFER_BIT,
+			                       VK_ACCESS_2_TRANSFER_WRITE_BIT, VK_PIPELINE_STAGE_2_NONE, VK_ACCESS_2_NONE);
+			return;
+		}
+		VkImageMemoryBarrier present{VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER};
+		present.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+		present.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+		present.newLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
+		present.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+		present.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+		present.image = swapImage;
+		present.subresourceRange = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1};
+		vk.CmdPipelineBarrier(cmd, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT,
+		                      0, 0, nullptr, 0, nullptr, 1, &present);
+	}
+
+	void Renderer::initDynamicResolution()
+	{
+		drsEnabled_ = false;
+		if (!config_.dynamicResolution.enabled || headless_) return;
+		if (!(swapchain_->imageUsage() & VK_IMAGE_USAGE_TRANSFER_DST_BIT))
+		{
+			spdlog::warn("Dynamic resolution disabled: swapchain images cannot be blit targets");
+			return;
+		}
+		VkFormatProperties props{};
+		vkGetPhysicalDeviceFormatProperties(device_->physical(), swapchain_->imageFormat(), &props);
+		const VkFormatFeatureFlags blit = VK_FORMAT_FEATURE_BLIT_SRC_BIT | VK_FORMAT_FEATURE_BLIT_DST_BIT;
+		if ((props.optimalTilingFeatures & blit) != blit)
+		{
+			spdlog::warn("Dynamic resolution disabled: format {} does not support blits",
+			             static_cast<int>(swapchain_->imageFormat()));
+			return;
+		}
+		upscaleFilter_ = (props.optimalTilingFeatures & VK_FORMAT_FEATURE_SAMPLED_IMAGE_FILTER_LINEAR_BIT)
+			                 ? VK_FILTER_LINEAR
+			                 : VK_FILTER_NEAREST;
+
+		DynamicResolutionController::Settings settings{};
+		settings.targetGpuMs = config_.dynamicResolution.targetGpuMs;
+		settings.minScale = config_.dynamicResolution.minScale;
+		settings.maxScale = config_.dynamicResolution.maxScale;
+		drs_.configure(settings);
+		drsEnabled_ = true;
+		spdlog::info("Dynamic resolution: {:.0f}%-{:.0f}% of output, GPU budget {:.2f} ms, {} upscale",
+		             drs_.settings().minScale * 100.0f, drs_.settings().maxScale * 100.0f, settings.targetGpuMs,
+		             upscaleFilter_ == VK_FILTER_LINEAR ? "bilinear" : "nearest");
+	}
+
+	void Renderer::onFrameSubmitted()
+	{
+		++frameNumber_;
+		frameStats_.frameNumber = frameNumber_;
+		frameStats_.cpuMs = std::chrono::duration<double, std::milli>(
+			std::chrono::steady_clock::now() - frameCpuStart_).count();
+		frameStats_.gpuMs = 0.0;
+		using Ms = std::chrono::duration<double, std::milli>;
+		frameStats_.inputToSubmitMs = Ms(frameSubmitTime_ - frameInputTime_).count();
+		// drawFrame returns right after vkQueuePresentKHR
+		frameStats_.submitToPresentMs = headless_ ? 0.0 : Ms(std::chrono::steady_clock::now() - frameSubmitTime_).count();
+		frameStats_.lateLatched = frameLatched_;
+		frameStats_.passes.clear(); // keeps capacity: no per-frame allocation
+		frameStats_.counters.clear();
+
+		// GPU timings resolve a frame or two later (non-blocking readback); stats carry the newest resolved frame
+		gpuProfiler_.onSubmitted();
+		if (gpuProfiler_.collect(*device_))
+		{
+			const gfx::GpuFrameTimings& gpu = gpuProfiler_.latest();
+			fpsAccumMs_ += gpu.totalMs;
+			++fpsCount_;
+			gpuFps_.addSampleMs(gpu.totalMs);
+			frameStats_.gpuMs = gpu.totalMs;
+			if (drsEnabled_) drs_.update(gpu.totalMs);
+			for (const auto& scope : gpu.scopes)
+				frameStats_.passes.push_back({scope.name, scope.durationMs, scope.depth, scope.hasStats, scope.stats});
+			frameStats_.counters.assign(gpu.counters.begin(), gpu.counters.end());
+		}
+
+		// VRAM: driver budgets (VK_EXT_memory_budget) and LRU eviction of residents the GPU no longer reads
+		gfx::MemoryBudget& budget = device_->memoryBudget();
+		device_->refreshMemoryBudget();
+		const uint64_t inFlight = context_->framesInFlight();
+		budget.setCompletedFrame(frameNumber_ > inFlight ? frameNumber_ - inFlight : 0);
+		frameStats_.gpuMemoryEvictedBytes = budget.enforce();
+		budget.deviceLocalTotals(frameStats_.gpuMemoryUsedBytes, frameStats_.gpuMemoryBudgetBytes);
+
+		// Steady-state frames (warmed up, nothing recreated) must not touch the global heap: Debug counts it and
+		// asserts; counting enabled in other builds (LUSTER_TRACK_ALLOCATIONS) only warns once
+		frameStats_.heapAllocations = threadHeapAllocations() - frameHeapStart_;
+		if (kHeapCountingEnabled && frameStats_.heapAllocations && !heapWarned_ &&
+			frameNumber_ > kAllocationWarmupFrames && recreateCount_ == frameRecreateStart_)
+		{
+			Log::warn("Frame {} made {} heap allocations on the render thread (steady state should make none)",
+			          frameNumber_, frameStats_.heapAllocations);
+			heapWarned_ = true;
+#ifndef NDEBUG
+			Log::flush(); // the message is queued: write it before the abort
+			assert(frameStats_.heapAllocations == 0 && "steady-state frame allocated on the render thread");
+#endif
+		}
+		// Opt-in tracker: allocations of all threads since the last frame, against their running average
+		if (AllocTracker::kEnabled)
+		{
+			const AllocFrameReport allocs = AllocTracker::endFrame();
+			frameStats_.heapAllocationSpike = allocs.spike;
+			if (allocs.spike)
+				Log::warn("Allocation spike in frame {}: {} allocations, {} KiB (all threads)", frameNumber_,
+				          allocs.allocations, allocs.bytes >> 10);
+		}
+
+		// CPU-based FPS（基于每帧调用频率估算，不反映GPU时）
+		cpuFps_.tick();
+	}
+
+	bool Renderer::drawFrame(Window& window)
+	{
+		snapshotArena_.reset();
+		return renderSnapshot(*buildSnapshot(snapshotArena_), &window);
+	}
+
+	bool Renderer::drawFrameHeadless()
+	{
+		snapshotArena_.reset();
+		return renderSnapshot(*buildSnapshot(snapshotArena_), nullptr);
+	}
+
+	bool Renderer::renderSnapshot(const FrameSnapshot& snapshot, Window* window)
+	{
+		PROFILE_SCOPE("Renderer::renderSnapshot");
+		LUSTER_ALLOC_TAG(Renderer);
+		const int pending = pendingPolicy_.exchange(-1);
+		if (pending >= 0) applyFramePolicy(static_cast<FramePolicy>(pending), window);
+		frameCpuStart_ = std::chrono::steady_clock::now();
+		frameHeapStart_ = threadHeapAllocations();
+		frameRecreateStart_ = recreateCount_;
+		// N frames in flight: everything up to N frames before the newest submitted one has completed
+		const uint64_t inFlight = context_->framesInFlight();
+		const uint64_t completed = frameNumber_ > inFlight ? frameNumber_ - inFlight : 0;
+		retired_.flush(completed);
+		gpuAllocator_->collect(completed);
+		const auto record = [&](VkCommandBuffer cb, uint32_t imageIndex)
+		{
+			frameArenas_.begin(context_->frameSlot());
+			gpuProfiler_.beginFrame(*context_);
+			// Moves next: everything recorded after (this frame's draws) resolves the new locations. Inside the
+			// profiled frame, so the copies count towards the GPU time dynamic resolution reacts to.
+			const VkDeviceSize defragBudget = static_cast<VkDeviceSize>(config_.memory.defragBudgetKiB) << 10;
+			frameStats_.gpuMemoryDefragBytes = 0;
+			// Scope only for frames that move something: a settled heap adds no timestamps
+			if (gpuAllocator_->planDefragment(defragBudget) > 0)
+			{
+				gpuProfiler_.beginScope(*context_, "Defrag");
+				frameStats_.gpuMemoryDefragBytes = gpuAllocator_->recordDefragment(cb, frameNumber_ + 1);
+				gpuProfiler_.endScope(*context_);
+			}
+			// After the slot's fence wait: the compute slot is free too, its last consumer has completed
+			if (computeRecorder_)
+			{
+				computeRecorder_(*asyncCompute_, asyncCompute_->begin(context_->frameSlot(), frameArenas_.resource()));
+				asyncCompute_->submit(*context_);
+				asyncCompute_->recordAcquires(cb);
+			}
+			recordScene(imageIndex, snapshot);
+		};
+		frameInputTime_ = snapshot.inputSampleTime;
+		frameLatched_ = false;
+		const auto preSubmit = [&]
+		{
+			if (config_.latency.lateLatch && !headless_) lateLatch(snapshot);
+			frameSubmitTime_ = std::chrono::steady_clock::now();
+		};
+
+		if (headless_)
+		{
+			auto result = framebuffers_->drawOffscreen(*device_, *context_, record, preSubmit);
+			if (result != gfx::Framebuffers::FrameResult::Ok)
+			{
+				spdlog::error("drawFrameHeadless failed");
+				return false;
+			}
+			onFrameSubmitted();
+			return true;
+		}
+
+		if (!window) return false;
+		if (snapshot.resized) recreateSwapchain(*window);
+		auto result = framebuffers_->drawFrame(*window, *device_, *context_, *swapchain_, record,
+		                                       preSubmit);
 
 		if (result == gfx::Framebuffers::FrameResult::NeedRecreate)
 		{
-			recreateSwapchain(window);
+			recreateSwapchain(*window);
 			return true;
 		}
 		if (result == gfx::Framebuffers::FrameResult::Error)
@@ -168,35 +677,204 @@ namespace luster
 			return false;
 		}
 
-		// FPS accumulation based on GPU frame time
-		// GPU-based FPS
-		double ms = 0.0;
-		if (gpuProfiler_.getLastTimingMs(*device_, ms))
+		recordPresentInterval();
+		onFrameSubmitted();
+		return true;
+	}
+
+	void Renderer::recordPresentInterval()
+	{
+		// CPU-side: taken when vkQueuePresentKHR returns, which tracks the display cadence once the
+		// swapchain queue is full (FIFO) and the render rate otherwise
+		const auto now = std::chrono::steady_clock::now();
+		if (lastPresent_ != std::chrono::steady_clock::time_point{})
 		{
-			fpsAccumMs_ += ms;
-			++fpsCount_;
-			gpuFps_.addSampleMs(ms);
+			const double ms = std::chrono::duration<double, std::milli>(now - lastPresent_).count();
+			frameStats_.presentIntervalMs = ms;
+			if (presentIntervalsMs_.size() < kPresentHistory) presentIntervalsMs_.push_back(ms);
+			else presentIntervalsMs_[presentIntervalNext_] = ms;
+			presentIntervalNext_ = (presentIntervalNext_ + 1) % kPresentHistory;
 		}
+		lastPresent_ = now;
+	}
 
-		// CPU-based FPS（基于每帧调用频率估算，不反映GPU时）
-		cpuFps_.tick();
+	FrameTimeSummary Renderer::presentIntervalSummary() const
+	{
+		return summarizeFrameTimes(presentIntervalsMs_);
+	}
+
+	VkPresentModeKHR Renderer::presentMode() const
+	{
+		return swapchain_ && !headless_ ? swapchain_->presentMode() : VK_PRESENT_MODE_FIFO_KHR;
+	}
+
+	void Renderer::resolveFramePolicy(FramePolicy policy)
+	{
+		const FramePolicySettings s = framePolicySettings(policy, config_.swapchain, config_.framesInFlight);
+		framePolicy_ = policy;
+		swapchainInfo_ = s.swapchain;
+		framesInFlight_ = std::clamp(s.framesInFlight, 1u, gfx::CommandContext::kMaxFramesInFlight);
+		if (config_.dynamicResolution.enabled && !headless_)
+			swapchainInfo_.imageUsage |= VK_IMAGE_USAGE_TRANSFER_DST_BIT; // upscale blit target
+	}
 
+	void Renderer::applyFramePolicy(FramePolicy policy, Window* window)
+	{
+		PROFILE_SCOPE("Renderer::applyFramePolicy");
+		resolveFramePolicy(policy);
+		// Frame slots and sync objects are rebuilt: rare and user-triggered, so a full stall is fine here
+		device_->waitIdle();
+		retired_.flushAll();
+		context_->setFramesInFlight(*device_, framesInFlight_);
+		if (!headless_ && window) recreateSwapchain(*window);
+		// Intervals under the old policy would skew the new distribution
+		presentIntervalsMs_.clear();
+		presentIntervalNext_ = 0;
+		lastPresent_ = {};
+		frameStats_.presentIntervalMs = 0.0;
+		spdlog::info("Frame policy {}: present {}, {} swapchain images, {} frames in flight", toString(framePolicy_),
+		             gfx::toString(presentMode()), swapchain_ ? swapchain_->imageCount() : 0u,
+		             context_->framesInFlight());
+	}
+
+	bool Renderer::readbackColor(std::vector<uint8_t>& outRgba, uint32_t& outWidth, uint32_t& outHeight)
+	{
+		// The render pass leaves the target in TRANSFER_SRC only after at least one frame
+		if (!headless_ || !offscreenColor_ || frameNumber_ == 0) return false;
+		context_->waitAllFences(*device_);
+
+		const gfx::Image& target = resources_.get(offscreenColor_);
+		const uint32_t w = target.width();
+		const uint32_t h = target.height();
+		const VkDeviceSize size = static_cast<VkDeviceSize>(w) * h * 4;
+
+		gfx::Buffer staging;
+		gfx::BufferCreateInfo ci{};
+		ci.size = size;
+		ci.usage = VK_BUFFER_USAGE_TRANSFER_DST_BIT;
+		ci.properties = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+		ci.category = gfx::MemoryCategory::Staging;
+		staging.create(*device_, ci);
+
+		const VkImage image = target.image();
+		const gfx::DeviceDispatch& vk = device_->vk();
+		device_->submitImmediate([&](VkCommandBuffer cmd)
+		{
+			// Make the render pass color writes visible to the transfer
+			VkImageMemoryBarrier barrier{VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER};
+			barrier.srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+			barrier.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+			barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+			barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+			barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+			barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+			barrier.image = image;
+			barrier.subresourceRange = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1};
+			vk.CmdPipelineBarrier(cmd, VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT,
+			                      0, 0, nullptr, 0, nullptr, 1, &barrier);
+
+			VkBufferImageCopy region{};
+			region.imageSubresource = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 0, 1};
+			region.imageExtent = {w, h, 1};
+			vk.CmdCopyImageToBuffer(cmd, image, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, staging.handle(), 1, &region);
+		});
+
+		outRgba.resize(static_cast<size_t>(size));
+		const void* p = staging.map(*device_);
+		std::memcpy(outRgba.data(), p, outRgba.size());
+		staging.unmap(*device_);
+		staging.cleanup(*device_);
+		outWidth = w;
+		outHeight = h;
 		return true;
 	}
 
+	VkExtent2D Renderer::renderExtent() const
+	{
+		// One atomic word: the game thread reads it while the render thread may be recreating the swapchain
+		const uint64_t packed = extentPacked_.load(std::memory_order_acquire);
+		return {static_cast<uint32_t>(packed >> 32), static_cast<uint32_t>(packed)};
+	}
+
+	void Renderer::publishExtent()
+	{
+		VkExtent2D e{};
+		if (headless_ && offscreenColor_)
+		{
+			const gfx::Image& target = resources_.get(offscreenColor_);
+			e = {target.width(), target.height()};
+		}
+		else if (swapchain_) e = swapchain_->extent();
+		extentPacked_.store(static_cast<uint64_t>(e.width) << 32 | e.height, std::memory_order_release);
+	}
+
 	void Renderer::recreateSwapchain(Window& window)
 	{
+		// In pipelined mode this runs on the render thread; SDL size queries are plain reads and fine there
 		int w = 0, h = 0;
 		window.getSize(w, h);
 		if (w == 0 || h == 0)
 			return;
 
-		device_->waitIdle();
-		cleanupSwapchain();
-		swapchain_->recreate(*device_, window, config_.swapchain);
-		createRenderPass();
+		PROFILE_SCOPE("Renderer::recreateSwapchain");
+		const auto t0 = std::chrono::steady_clock::now();
+		// The last submitted frame may still use the old images; +1 leaves time for its present
+		const uint64_t retireFrame = frameNumber_ + 1;
+		const VkFormat oldFormat = swapchain_->imageFormat();
+		retireFramebuffers(retireFrame);
+		swapchain_->recreate(*device_, window, swapchainInfo_, retired_, retireFrame);
+		publishExtent();
+		if (swapchain_->imageFormat() != oldFormat)
+		{
+			// Render pass and pipeline depend on the color format: rare, take the slow path
+			device_->waitIdle();
+			retired_.flushAll();
+			if (renderPass_) renderPass_->cleanup(*device_);
+			createRenderPass();
+			createDescriptors();
+		}
 		createFramebuffers();
-		createDescriptors();
+		lastRecreateMs_ = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+		++recreateCount_;
+	}
+
+	void Renderer::resizeOffscreen(uint32_t width, uint32_t height)
+	{
+		if (!headless_ || width == 0 || height == 0) return;
+		PROFILE_SCOPE("Renderer::resizeOffscreen");
+		const auto t0 = std::chrono::steady_clock::now();
+		const uint64_t retireFrame = frameNumber_;
+		retireFramebuffers(retireFrame);
+		if (offscreenColor_)
+		{
+			retired_.push(retireFrame, [this, old = offscreenColor_]() mutable { resources_.destroy(*device_, old); });
+			offscreenColor_ = {};
+		}
+		config_.headless.width = width;
+		config_.headless.height = height;
+		createOffscreenTarget();
+		publishExtent();
+		createFramebuffers();
+		lastRecreateMs_ = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+		++recreateCount_;
+	}
+
+	void Renderer::retireFramebuffers(uint64_t frame)
+	{
+		const gfx::Device* device = device_.get();
+		if (framebuffers_)
+		{
+			retired_.push(frame, [device, fbs = framebuffers_->release()]
+			{
+				for (auto fb : fbs) device->vk().DestroyFramebuffer(device->logical(), fb, nullptr);
+			});
+		}
+		for (auto* image : {&depthImage_, &scaledColor_})
+		{
+			if (!*image) continue;
+			retired_.push(frame, [this, old = *image]() mutable { resources_.destroy(*device_, old); });
+			*image = {};
+		}
 	}
 
 	void Renderer::cleanup()
@@ -205,10 +883,16 @@ namespace luster
 			return;
 
 		device_->waitIdle();
+		retired_.flushAll();
 
 		// Destroy GPU profiler resources before device is destroyed
 		gpuProfiler_.cleanup(*device_);
 
+		if (asyncCompute_)
+		{
+			asyncCompute_->cleanup(*device_);
+			asyncCompute_.reset();
+		}
 		if (context_)
 		{
 			context_->cleanup(*device_);
@@ -235,26 +919,23 @@ namespace luster
 			swapchain_.reset();
 		}
 
-		if (uniformBuffer_)
-		{
-			uniformBuffer_->cleanup(*device_);
-			uniformBuffer_.reset();
-		}
-		if (vertexBuffer_)
-		{
-			vertexBuffer_->cleanup(*device_);
-			vertexBuffer_.reset();
-		}
-		if (indexBuffer_)
-		{
-			indexBuffer_->cleanup(*device_);
-			indexBuffer_.reset();
-		}
+		resources_.destroy(*device_, uniformBuffer_);
+		resources_.destroy(*device_, computeClearBuffer_);
 		if (mesh_)
 		{
 			mesh_->cleanup(*device_);
 			mesh_.reset();
 		}
+		resources_.destroy(*device_, offscreenColor_);
+		resources_.destroy(*device_, scaledColor_);
+		resources_.cleanup(*device_); // anything created through resources() by the application
+		// Last: the registry's buffers and images live in it
+		if (gpuAllocator_)
+		{
+			gpuAllocator_->cleanup(*device_);
+			gpuAllocator_.reset();
+		}
+		resources_.setAllocator(nullptr);
 		if (device_)
 		{
 			device_->cleanup();
@@ -266,123 +947,261 @@ namespace luster
 	{
 		device_ = std::make_unique<gfx::Device>();
 		device_->init(window, params);
+		createGpuAllocator();
+	}
+
+	void Renderer::createGpuAllocator()
+	{
+		// Before any registry buffer or image: they are suballocated from it
+		gpuAllocator_ = std::make_unique<gfx::GpuAllocator>();
+		gpuAllocator_->create(*device_);
+		resources_.setAllocator(gpuAllocator_.get());
 	}
 
 	void Renderer::createSwapchainAndViews(Window& window)
 	{
 		swapchain_ = std::make_unique<gfx::Swapchain>();
-		swapchain_->create(*device_, window, config_.swapchain);
+		swapchain_->create(*device_, window, swapchainInfo_);
+	}
+
+	void Renderer::createOffscreenTarget()
+	{
+		gfx::ImageCreateInfo ci{};
+		ci.width = config_.headless.width;
+		ci.height = config_.headless.height;
+		ci.format = VK_FORMAT_R8G8B8A8_UNORM; // matches readbackColor's RGBA8 layout
+		ci.usage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT;
+		ci.properties = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
+		ci.aspect = VK_IMAGE_ASPECT_COLOR_BIT;
+		ci.category = gfx::MemoryCategory::RenderTarget;
+		resources_.destroy(*device_, offscreenColor_);
+		offscreenColor_ = resources_.createImage(*device_, ci);
+	}
+
+	VkFormat Renderer::colorTargetFormat() const
+	{
+		return headless_ ? resources_.get(offscreenColor_).format() : swapchain_->imageFormat();
 	}
 
 	void Renderer::createRenderPass()
 	{
+		if (dynamicRendering_)
+		{
+			renderPass_.reset(); // pipelines are built against attachment formats instead
+			return;
+		}
 		renderPass_ = std::make_unique<gfx::RenderPass>();
 		// Choose a supported depth format
 		VkFormat depthFormat = device_->findDepthFormat();
-		renderPass_->create(*device_, swapchain_->imageFormat(), depthFormat);
+		if (headless_)
+			renderPass_->create(*device_, resources_.get(offscreenColor_).format(), depthFormat,
+			                    VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL);
+		else if (drsEnabled_) // blit source for the upscale
+			renderPass_->create(*device_, swapchain_->imageFormat(), depthFormat, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL);
+		else
+			renderPass_->create(*device_, swapchain_->imageFormat(), depthFormat);
 	}
 
 	void Renderer::createPipeline()
 	{
-		pipeline_ = std::make_unique<gfx::Pipeline>();
+		resources_.destroy(*device_, pipeline_);
 		gfx::PipelineCreateInfo info{};
 		info.vsSpvPath = "shaders/triangle.vert.spv";
 		info.fsSpvPath = "shaders/triangle.frag.spv";
-		info.viewportExtent = swapchain_->extent();
+		info.viewportExtent = renderExtent();
 		info.enableDepthTest = config_.pipeline.enableDepthTest ? VK_TRUE : VK_FALSE;
 		info.enableDepthWrite = config_.pipeline.enableDepthWrite ? VK_TRUE : VK_FALSE;
-		pipeline_->create(*device_, *renderPass_, info);
+		buildPipeline(info);
+	}
+
+	void Renderer::buildPipeline(const gfx::PipelineCreateInfo& info)
+	{
+		if (!dynamicRendering_)
+		{
+			pipeline_ = resources_.createPipeline(*device_, *renderPass_, info);
+			return;
+		}
+		gfx::PipelineCreateInfo dyn = info;
+		dyn.colorFormat = colorTargetFormat();
+		dyn.depthFormat = device_->findDepthFormat();
+		pipeline_ = resources_.createPipeline(*device_, dyn);
 	}
 
 	void Renderer::createFramebuffers()
 	{
 		if (!framebuffers_) framebuffers_ = std::make_unique<gfx::Framebuffers>();
-		if (!depthImage_) depthImage_ = std::make_unique<gfx::Image>();
+		const VkExtent2D extent = renderExtent();
 		gfx::ImageCreateInfo di{};
-		di.width = swapchain_->extent().width;
-		di.height = swapchain_->extent().height;
+		di.width = extent.width;
+		di.height = extent.height;
 		di.format = device_->findDepthFormat();
 		di.usage = VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT;
 		di.properties = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
 		di.tiling = VK_IMAGE_TILING_OPTIMAL;
 		di.aspect = VK_IMAGE_ASPECT_DEPTH_BIT;
-		depthImage_->cleanup(*device_);
-		depthImage_->create(*device_, di);
+		di.category = gfx::MemoryCategory::RenderTarget;
+		resources_.destroy(*device_, depthImage_);
+		depthImage_ = resources_.createImage(*device_, di);
 
-		framebuffers_->create(*device_, *renderPass_, swapchain_->extent(), swapchain_->imageViews(),
-		                      depthImage_->view());
+		if (drsEnabled_)
+		{
+			// Allocated at the full output size: scale changes only move the render area, never reallocate
+			gfx::ImageCreateInfo ci{};
+			ci.width = extent.width;
+			ci.height = extent.height;
+			ci.format = swapchain_->imageFormat();
+			ci.usage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT;
+			ci.properties = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
+			ci.aspect = VK_IMAGE_ASPECT_COLOR_BIT;
+			ci.category = gfx::MemoryCategory::RenderTarget;
+			resources_.destroy(*device_, scaledColor_);
+			scaledColor_ = resources_.createImage(*device_, ci);
+		}
+
+		// Dynamic rendering binds image views at vkCmdBeginRendering: nothing else to (re)create
+		if (dynamicRendering_) return;
+		const VkImageView depth = resources_.get(depthImage_).view();
+		if (headless_)
+			framebuffers_->create(*device_, *renderPass_, extent, {resources_.get(offscreenColor_).view()}, depth);
+		else if (drsEnabled_)
+			framebuffers_->create(*device_, *renderPass_, extent, {resources_.get(scaledColor_).view()}, depth);
+		else
+			framebuffers_->create(*device_, *renderPass_, extent, swapchain_->imageViews(), depth);
 	}
 
 	void Renderer::createGeometry()
 	{
-		if (!vertexBuffer_) vertexBuffer_ = std::make_unique<gfx::Buffer>();
 		if (!mesh_) mesh_ = std::make_unique<gfx::Mesh>();
 		mesh_->cleanup(*device_);
-		mesh_->createCube(*device_);
+		{
+			LUSTER_ALLOC_TAG(Assets);
+			mesh_->createCube(*gpuAllocator_);
+		}
 
-		if (!uniformBuffer_) uniformBuffer_ = std::make_unique<gfx::Buffer>();
+		// Dynamic UBO: one DrawConstants slot per draw, each aligned for dynamic offsets; one region per
+		// possible frame in flight so a policy switch never resizes it. Not needed with push constants.
+		resources_.destroy(*device_, uniformBuffer_);
+		if (pushConstants_) return;
+		const VkDeviceSize align = std::max<VkDeviceSize>(device_->minUniformBufferOffsetAlignment(), 1);
+		drawStride_ = (sizeof(DrawConstants) + align - 1) / align * align;
 		gfx::BufferCreateInfo ubi{};
-		ubi.size = sizeof(glm::mat4); // MVP
+		ubi.size = drawStride_ * kMaxDraws * gfx::CommandContext::kMaxFramesInFlight;
 		ubi.usage = VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT;
 		ubi.properties = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
-		uniformBuffer_->cleanup(*device_);
-		uniformBuffer_->create(*device_, ubi);
+		ubi.persistentMap = true; // rewritten every frame, and again by the late latch
+		ubi.category = gfx::MemoryCategory::Uniform;
+		uniformBuffer_ = resources_.createBuffer(*device_, ubi);
 	}
 
 	void Renderer::createDescriptors()
 	{
-		// Ensure pipeline object exists
-		if (!pipeline_) pipeline_ = std::make_unique<gfx::Pipeline>();
-
 		// Destroy old pipeline (and its layout) BEFORE destroying old set layout
-		pipeline_->cleanup(*device_);
+		resources_.destroy(*device_, pipeline_);
 
 		// If a descriptor pool exists, destroy it first (frees sets implicitly)
 		if (dsp_) { dsp_->cleanup(*device_); }
 
-		// Destroy old descriptor set layout, then recreate it
-		VkDescriptorSetLayoutBinding ubo{};
-		ubo.binding = 0;
-		ubo.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
-		ubo.descriptorCount = 1;
-		ubo.stageFlags = VK_SHADER_STAGE_VERTEX_BIT;
-		if (!dsl_) dsl_ = std::make_unique<gfx::DescriptorSetLayout>();
-		dsl_->cleanup(*device_);
-		dsl_->create(*device_, &ubo, 1);
+		// Destroy old descriptor set layout, then recreate it (UBO path only: push constants need no set)
+		if (dsl_) dsl_->cleanup(*device_);
+		if (!pushConstants_)
+		{
+			VkDescriptorSetLayoutBinding ubo{};
+			ubo.binding = 0;
+			ubo.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
+			ubo.descriptorCount = 1;
+			ubo.stageFlags = VK_SHADER_STAGE_VERTEX_BIT;
+			if (!dsl_) dsl_ = std::make_unique<gfx::DescriptorSetLayout>();
+			dsl_->create(*device_, &ubo, 1);
+		}
 		gfx::PipelineCreateInfo info{};
-		info.vsSpvPath = "shaders/triangle.vert.spv";
+		info.vsSpvPath = pushConstants_ ? kPushVertexShader : "shaders/triangle.vert.spv";
 		info.fsSpvPath = "shaders/triangle.frag.spv";
-		info.viewportExtent = swapchain_->extent();
+		info.viewportExtent = renderExtent();
 		info.enableDepthTest = config_.pipeline.enableDepthTest ? VK_TRUE : VK_FALSE;
 		info.enableDepthWrite = config_.pipeline.enableDepthWrite ? VK_TRUE : VK_FALSE;
-		VkDescriptorSetLayout layout = dsl_->handle();
-		info.setLayouts = &layout;
-		info.setLayoutCount = 1;
+		const VkPushConstantRange pushRange{VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof(DrawConstants)};
+		const VkDescriptorSetLayout layout = pushConstants_ ? VK_NULL_HANDLE : dsl_->handle();
+		if (pushConstants_)
+		{
+			info.pushConstantRanges = &pushRange;
+			info.pushConstantRangeCount = 1;
+		}
+		else
+		{
+			info.setLayouts = &layout;
+			info.setLayoutCount = 1;
+		}
 		// vertex input via VertexLayout (recreate to avoid duplicated attributes)
 		vertexLayout_ = std::make_unique<gfx::VertexLayout>();
 		// use mesh's layout
 		vertexLayout_ = std::make_unique<gfx::VertexLayout>(*mesh_->vertexLayout());
 		info.vertexLayout = mesh_->vertexLayout();
-		pipeline_->create(*device_, *renderPass_, info);
+		buildPipeline(info);
+		if (pushConstants_) return;
 
 		// Descriptor pool & set
 		if (!dsp_) dsp_ = std::make_unique<gfx::DescriptorPool>();
 		dsp_->cleanup(*device_);
 		VkDescriptorPoolSize poolSize{};
-		poolSize.type = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+		poolSize.type = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
 		poolSize.descriptorCount = 1;
 		dsp_->create(*device_, &poolSize, 1, 1);
 
 		if (!dset_) dset_ = std::make_unique<gfx::DescriptorSet>();
 		dset_->allocate(*device_, *dsp_, *dsl_);
-		dset_->updateUniformBuffer(*device_, 0, uniformBuffer_->handle(), uniformBuffer_->size());
+		dset_->updateUniformBuffer(*device_, 0, resources_.get(uniformBuffer_).handle(), sizeof(DrawConstants),
+		                           VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC);
+	}
+
+	void Renderer::createScene()
+	{
+		// Square grid on the XZ plane centred at the origin
+		const uint32_t n = std::max(config_.scene.gridSize, 1u);
+		const float half = static_cast<float>(n - 1) * 0.5f;
+		objects_.clear();
+		objects_.reserve(static_cast<size_t>(n) * n);
+		for (uint32_t z = 0; z < n; ++z)
+			for (uint32_t x = 0; x < n; ++x)
+				objects_.push_back({glm::vec3((static_cast<float>(x) - half) * config_.scene.spacing, 0.0f,
+				                              (static_cast<float>(z) - half) * config_.scene.spacing)});
+		drawList_.reserve(std::min<size_t>(objects_.size(), kMaxDraws));
+		if (objects_.size() > kMaxDraws)
+			spdlog::warn("Scene has {} objects, only {} can be drawn per frame", objects_.size(), kMaxDraws);
 	}
 
 	void Renderer::createCommandsAndSync()
 	{
 		if (!context_) context_ = std::make_unique<gfx::CommandContext>();
-		context_->create(*device_, device_->gfxQueueFamily());
+		context_->create(*device_, device_->gfxQueueFamily(), framesInFlight_);
+		context_->setStateFiltering(config_.pipeline.filterRedundantState);
 		context_->createSync(*device_);
+		if (!asyncCompute_) asyncCompute_ = std::make_unique<gfx::AsyncCompute>();
+		asyncCompute_->create(*device_);
+		if (config_.compute.clearPass && !computeRecorder_)
+		{
+			gfx::BufferCreateInfo bi{};
+			bi.size = kComputeClearBytes * gfx::AsyncCompute::kMaxSlots;
+			bi.usage = VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT;
+			bi.properties = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
+			computeClearBuffer_ = resources_.createBuffer(*device_, bi);
+			computeRecorder_ = [this](gfx::AsyncCompute& compute, VkCommandBuffer cmd)
+			{
+				recordComputeClear(compute, cmd);
+			};
+		}
+	}
+
+	void Renderer::recordComputeClear(gfx::AsyncCompute& compute, VkCommandBuffer cmd)
+	{
+		// Stand-in for real compute work: goes through the compute submit, the semaphore wait and (with a
+		// dedicated family) the ownership transfer, with nothing else changing. Each slot clears its own region,
+		// a previous frame may still read the others.
+		const VkBuffer buffer = resources_.get(computeClearBuffer_).handle();
+		const VkDeviceSize offset = static_cast<VkDeviceSize>(context_->frameSlot()) * kComputeClearBytes;
+		device_->vk().CmdFillBuffer(cmd, buffer, offset, kComputeClearBytes, 0);
+		compute.releaseBuffer(buffer, offset, kComputeClearBytes, VK_PIPELINE_STAGE_TRANSFER_BIT,
+		                      VK_ACCESS_TRANSFER_WRITE_BIT, VK_PIPELINE_STAGE_VERTEX_SHADER_BIT,
+		                      VK_ACCESS_SHADER_READ_BIT);
 	}
 
 	void Renderer::cleanupSwapchain()
@@ -393,20 +1212,12 @@ namespace luster
 			framebuffers_.reset();
 		}
 
-		if (pipeline_)
-		{
-			pipeline_->cleanup(*device_);
-			pipeline_.reset();
-		}
+		resources_.destroy(*device_, pipeline_);
 		if (renderPass_)
 		{
 			renderPass_->cleanup(*device_);
 			renderPass_.reset();
 		}
-		if (depthImage_)
-		{
-			depthImage_->cleanup(*device_);
-			depthImage_.reset();
-		}
+		resources_.destroy(*device_, depthImage_);
 	}
 } // namespace luster
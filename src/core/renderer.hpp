@@ -3,12 +3,23 @@
 #include "core/core.hpp"
 #include "core/gfx/device.hpp"
 #include "core/gfx/gpu_profiler.hpp"
+#include "core/gfx/resource_registry.hpp"
 #include "core/utils/profiler.hpp"
 #include "core/utils/fps_counter.hpp"
 #include "core/config.hpp"
 #include "core/camera.hpp"
 #include "core/camera_controller.hpp"
+#include "core/frame_stats.hpp"
+#include "core/frame_snapshot.hpp"
+#include "core/dynamic_resolution.hpp"
+#include "core/draw_list.hpp"
+#include "core/memory/frame_arenas.hpp"
+#include "core/memory/linear_arena.hpp"
+#include "core/utils/deletion_queue.hpp"
+#include "core/utils/frame_time_stats.hpp"
+#include <atomic>
 #include <chrono>
+#include <functional>
 #include <vector>
 
 namespace luster
@@ -21,6 +32,8 @@ namespace luster
 		class RenderPass;
 		class Pipeline;
 		class CommandContext;
+		class AsyncCompute;
+		class GpuAllocator;
 		class Framebuffers;
 		class Image;
 		class Buffer;
@@ -40,24 +53,149 @@ namespace luster
 		void init(Window& window, const EngineConfig& config);
 		// Backward-compatible overload: only device params → build EngineConfig under the hood
 		void init(Window& window, const gfx::Device::InitParams& params = gfx::Device::InitParams{});
+		// Headless: renders into offscreen gfx::Image targets (no window, surface or swapchain)
+		void initHeadless(const EngineConfig& config);
+		// Single-threaded frame: buildSnapshot() + renderSnapshot() back to back
 		bool drawFrame(Window& window);
+		bool drawFrameHeadless();
+		// Game-thread half of a frame: interpolated camera, frustum culling and per-draw constants, all
+		// allocated from `arena`. Reads simulation state only, never GPU objects.
+		const FrameSnapshot* buildSnapshot(LinearArena& arena, bool resized = false);
+		// Recording half: uploads the snapshot's constants, records, submits and presents (window == nullptr
+		// when headless). Runs on the render thread in pipelined mode (see RenderThread).
+		bool renderSnapshot(const FrameSnapshot& snapshot, Window* window);
+		// Copies the last headless frame into tightly packed RGBA8 (blocks until the GPU is done)
+		bool readbackColor(std::vector<uint8_t>& outRgba, uint32_t& outWidth, uint32_t& outHeight);
+		// Variable-dt convenience: one simulation step of dt, rendered without interpolation
 		void update(float dt);
 		void update(float dt, const InputSnapshot& input);
+		// Fixed-step simulation: advances camera and scene by exactly stepDt
+		void simulate(float stepDt, const InputSnapshot& input);
+		// Call right after sampling the frame's input; anchors the input-to-submit latency marker
+		void markInputSampled() { inputSampleTime_ = std::chrono::steady_clock::now(); }
+		// Render-time blend between the previous and current simulated state (FixedStepClock::alpha())
+		void setInterpolationAlpha(float alpha) { alpha_ = alpha; }
+		// Rebuilds only extent-dependent objects (swapchain, framebuffers, depth) without a device-wide wait;
+		// the old ones are retired and destroyed once the frames using them completed
 		void recreateSwapchain(Window& window);
+		// Headless counterpart: new offscreen target size (benchmarks' resize storms)
+		void resizeOffscreen(uint32_t width, uint32_t height);
+		// Frame-delivery policy switch, applied by the recording thread before its next frame (any thread)
+		void requestFramePolicy(FramePolicy policy) { pendingPolicy_.store(static_cast<int>(policy)); }
+		FramePolicy framePolicy() const { return framePolicy_; }
+		// Present-to-present intervals over the last kPresentHistory frames (recording thread)
+		FrameTimeSummary presentIntervalSummary() const;
+		// Granted present mode (FIFO headless)
+		VkPresentModeKHR presentMode() const;
+		// Dynamic resolution scale for the next frame (1 when disabled)
+		float renderScale() const { return drsEnabled_ ? drs_.scale() : 1.0f; }
+		// Per-draw data path in use (config_.pipeline.pushConstants, forced off by the late latch)
+		bool usesPushConstants() const { return pushConstants_; }
+		// Compute work of every frame, recorded on the render thread into the async compute command buffer
+		// (dedicated compute queue, or the graphics queue without one); this frame's graphics submit waits for it.
+		// Release what graphics reads through AsyncCompute::release*(). Empty function: no compute submit.
+		using ComputeRecorder = std::function<void(gfx::AsyncCompute&, VkCommandBuffer)>;
+		void setComputeRecorder(ComputeRecorder recorder) { computeRecorder_ = std::move(recorder); }
+		// Suballocated, defragmented resources (meshes, streamed content); render thread only. Resources the
+		// compute recorder reads must be created non-movable: compute is submitted before this frame's moves run.
+		gfx::GpuAllocator& gpuAllocator() { return *gpuAllocator_; }
+		// Registry of the renderer's GPU objects; what the application creates here is destroyed at cleanup()
+		gfx::ResourceRegistry& resources() { return resources_; }
+		// Render-thread CPU memory for the frame being recorded (compute recorder, record callbacks): lives until
+		// this frame slot is reused, i.e. until the frame has retired on the GPU
+		LinearArena& frameArena() { return frameArenas_.current(); }
+		double lastRecreateMs() const { return lastRecreateMs_; }
+		uint64_t recreateCount() const { return recreateCount_; }
 		void cleanup();
 
+		bool isHeadless() const { return headless_; }
+		// Safe from any thread
+		VkExtent2D renderExtent() const;
+		const gfx::Device& device() const { return *device_; }
+		// Scripted camera control (benchmarks); input-driven updates still apply in update()
+		Camera& camera() { return camera_; }
+		// Written by the recording thread; read it from there (or single-threaded)
+		const FrameStats& lastFrameStats() const { return frameStats_; }
+		// Names for FrameStats::counters (empty without VK_KHR_performance_query)
+		const std::vector<std::string>& gpuCounterNames() const { return gpuProfiler_.counterNames(); }
+		void resetSceneTime() { sceneTime_ = 0.0; prevSim_.sceneTime = 0.0; }
+
 	private:
+		static constexpr uint32_t kMaxDraws = 1024; // dynamic UBO slots per frame in flight
+		static constexpr VkDeviceSize kComputeClearBytes = 256; // config_.compute.clearPass, per frame slot
+		static constexpr size_t kPresentHistory = 240;
+		static constexpr uint64_t kAllocationWarmupFrames = 120; // until vectors and pools reach steady capacity
+
+		struct SceneObject
+		{
+			glm::vec3 position{0.0f};
+			float radius = 0.87f; // bounding sphere of the unit cube
+		};
+
 		// Configuration
 		EngineConfig config_{};
+		bool headless_ = false;
+		uint64_t frameNumber_ = 0; // frames submitted so far
+		double sceneTime_ = 0.0; // accumulated simulation time; drives model animation deterministically
+		// Simulated state before the latest step, blended with the current one by alpha_ when rendering
+		struct SimState
+		{
+			glm::vec3 eye{0.0f};
+			glm::vec3 target{0.0f};
+			double sceneTime = 0.0;
+		} prevSim_{};
+		float alpha_ = 1.0f;
+		FrameStats frameStats_{};
+		std::vector<SceneObject> objects_{};
+		DrawList drawList_{}; // game thread: visible draws of the snapshot being built
+		LinearArena snapshotArena_{}; // single-threaded drawFrame()
+		FrameArenas frameArenas_{}; // per frame slot, reset after the slot's fence wait
+		// Debug allocation check: render thread's heap allocation count at frame start, and the recreate count
+		uint64_t frameHeapStart_ = 0;
+		uint64_t frameRecreateStart_ = 0;
+		bool heapWarned_ = false;
+		uint64_t snapshotCounter_ = 0;
+		std::atomic<uint64_t> extentPacked_{0}; // width << 32 | height
+		DeletionQueue retired_{}; // keyed by frameNumber_
+		FramePolicy framePolicy_ = FramePolicy::Custom;
+		gfx::SwapchainCreateInfo swapchainInfo_{}; // config_.swapchain resolved through the policy
+		uint32_t framesInFlight_ = 1;
+		std::atomic<int> pendingPolicy_{-1};
+		std::vector<double> presentIntervalsMs_{}; // ring, kPresentHistory entries
+		size_t presentIntervalNext_ = 0;
+		std::chrono::steady_clock::time_point lastPresent_{};
+		double lastRecreateMs_ = 0.0;
+		uint64_t recreateCount_ = 0;
+		std::chrono::steady_clock::time_point frameCpuStart_{};
+		std::chrono::steady_clock::time_point inputSampleTime_{};
+		// Latency markers of the frame being submitted
+		std::chrono::steady_clock::time_point frameInputTime_{};
+		std::chrono::steady_clock::time_point frameSubmitTime_{};
+		bool frameLatched_ = false;
 
 		// Core GPU objects
 		std::unique_ptr<gfx::Device> device_;
 		std::unique_ptr<gfx::Swapchain> swapchain_;
 		std::unique_ptr<gfx::RenderPass> renderPass_;
-		std::unique_ptr<gfx::Pipeline> pipeline_;
 		std::unique_ptr<gfx::Framebuffers> framebuffers_;
-		std::unique_ptr<gfx::Image> depthImage_;
+		// Buffers, images, pipelines and samplers live in dense pools; members hold 32-bit handles
+		gfx::ResourceRegistry resources_{};
+		gfx::PipelineHandle pipeline_{};
+		gfx::ImageHandle depthImage_{};
+		gfx::ImageHandle offscreenColor_{}; // headless color target
+		// Dynamic resolution: output-sized scene target, rendered into a top-left sub-rect and blitted up
+		gfx::ImageHandle scaledColor_{};
+		DynamicResolutionController drs_{};
+		bool drsEnabled_ = false;
+		// VK_KHR_dynamic_rendering path: no VkRenderPass/VkFramebuffer, sync2 layout transitions in recordScene
+		bool dynamicRendering_ = false;
+		// Per-draw MVP as push constants (triangle_push.vert) instead of the dynamic UBO
+		bool pushConstants_ = false;
+		VkFilter upscaleFilter_ = VK_FILTER_LINEAR;
 		std::unique_ptr<gfx::CommandContext> context_;
+		std::unique_ptr<gfx::AsyncCompute> asyncCompute_;
+		ComputeRecorder computeRecorder_{};
+		gfx::BufferHandle computeClearBuffer_{}; // config_.compute.clearPass: one region per frame slot
 
 		// Descriptors
 		std::unique_ptr<gfx::DescriptorSetLayout> dsl_;
@@ -65,10 +203,11 @@ namespace luster
 		std::unique_ptr<gfx::DescriptorSet> dset_;
 
 		// Geometry & buffers
-		std::unique_ptr<gfx::Buffer> vertexBuffer_;
-		std::unique_ptr<gfx::Buffer> indexBuffer_;
-		std::unique_ptr<gfx::Buffer> uniformBuffer_;
+		// Dynamic UBO: one region per frame in flight, kMaxDraws slots of drawStride_ bytes each
+		gfx::BufferHandle uniformBuffer_{};
+		VkDeviceSize drawStride_ = 0;
 		std::unique_ptr<gfx::VertexLayout> vertexLayout_;
+		std::unique_ptr<gfx::GpuAllocator> gpuAllocator_;
 		std::unique_ptr<gfx::Mesh> mesh_;
 
 		// Profiling & FPS
@@ -86,11 +225,33 @@ namespace luster
 		double camLogIntervalMs_ = 500.0;
 
 		void createInstance(Window& window, const gfx::Device::InitParams& params);
+		void createGpuAllocator();
 		void createSwapchainAndViews(Window& window);
+		void createOffscreenTarget();
+		void initCommon();
+		void createScene();
+		void publishExtent();
+		void uploadDrawConstants(const FrameSnapshot& snapshot);
+		void lateLatch(const FrameSnapshot& snapshot);
+		VkDeviceSize frameUboBase() const;
+		void resolveFramePolicy(FramePolicy policy);
+		void applyFramePolicy(FramePolicy policy, Window* window);
+		void recordPresentInterval();
+		void initDynamicResolution();
+		VkExtent2D sceneExtent() const;
+		void recordUpscale(uint32_t imageIndex, VkExtent2D src, VkExtent2D dst);
+		// Records after gpuProfiler_.beginFrame() (the record callback's first command) and ends the profiler frame
+		void recordScene(uint32_t imageIndex, const FrameSnapshot& snapshot);
+		void onFrameSubmitted();
 		void createRenderPass();
 		void createPipeline();
+		void buildPipeline(const gfx::PipelineCreateInfo& info);
+		VkFormat colorTargetFormat() const;
+		void recordSceneTargetBarriers(uint32_t imageIndex, bool beforeRendering);
 		void createFramebuffers();
+		void retireFramebuffers(uint64_t frame);
 		void createCommandsAndSync();
+		void recordComputeClear(gfx::AsyncCompute& compute, VkCommandBuffer cmd);
 		void createGeometry();
 		void createDescriptors();
 		void cleanupSwapchain();
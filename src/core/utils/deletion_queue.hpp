@@ -0,0 +1,55 @@
+#pragma once
+
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <utility>
+
+namespace luster
+{
+	// Deferred destruction keyed by frame number: an object retired while frame N may still use it is
+	// destroyed once frame N is known complete, instead of stalling on vkDeviceWaitIdle.
+	// Frames must be pushed in non-decreasing order; callbacks run in push order.
+	class DeletionQueue
+	{
+	public:
+		void push(uint64_t frame, std::function<void()> destroy)
+		{
+			entries_.push_back({frame, std::move(destroy)});
+		}
+
+		// Runs every entry whose frame <= completedFrame
+		void flush(uint64_t completedFrame)
+		{
+			while (!entries_.empty() && entries_.front().frame <= completedFrame)
+			{
+				auto destroy = std::move(entries_.front().destroy);
+				entries_.pop_front();
+				destroy();
+			}
+		}
+
+		// Everything, regardless of frame (after vkDeviceWaitIdle)
+		void flushAll()
+		{
+			while (!entries_.empty())
+			{
+				auto destroy = std::move(entries_.front().destroy);
+				entries_.pop_front();
+				destroy();
+			}
+		}
+
+		size_t size() const { return entries_.size(); }
+		bool empty() const { return entries_.empty(); }
+
+	private:
+		struct Entry
+		{
+			uint64_t frame;
+			std::function<void()> destroy;
+		};
+
+		std::deque<Entry> entries_{};
+	};
+}
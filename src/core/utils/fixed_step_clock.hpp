@@ -0,0 +1,64 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+namespace luster
+{
+	// Fixed-timestep accumulator: real frame time goes in, a whole number of simulation steps comes out,
+	// and alpha() says how far the render time sits between the last two simulated states.
+	// Steps per frame are clamped so a slow frame cannot trigger an ever-growing catch-up (spiral of death);
+	// the time that does not fit is dropped and the simulation runs slower than real time instead.
+	class FixedStepClock
+	{
+	public:
+		explicit FixedStepClock(double stepSeconds = 1.0 / 120.0, uint32_t maxStepsPerFrame = 8)
+		{
+			configure(stepSeconds, maxStepsPerFrame);
+		}
+
+		void configure(double stepSeconds, uint32_t maxStepsPerFrame)
+		{
+			step_ = stepSeconds > 0.0 ? stepSeconds : 1.0 / 120.0;
+			maxSteps_ = std::max<uint32_t>(maxStepsPerFrame, 1);
+			accumulator_ = 0.0;
+		}
+
+		// Returns the number of steps to simulate for a frame that took frameSeconds
+		uint32_t advance(double frameSeconds)
+		{
+			accumulator_ += std::max(frameSeconds, 0.0);
+			uint32_t steps = 0;
+			while (accumulator_ >= step_ && steps < maxSteps_)
+			{
+				accumulator_ -= step_;
+				++steps;
+			}
+			if (accumulator_ >= step_)
+			{
+				// Drop whole steps only: the fractional part keeps alpha continuous
+				const double kept = std::fmod(accumulator_, step_);
+				droppedSeconds_ += accumulator_ - kept;
+				accumulator_ = kept;
+			}
+			totalSteps_ += steps;
+			return steps;
+		}
+
+		// Interpolation factor in [0, 1) between the previous and the current simulated state
+		double alpha() const { return accumulator_ / step_; }
+		double step() const { return step_; }
+		uint32_t maxStepsPerFrame() const { return maxSteps_; }
+		uint64_t totalSteps() const { return totalSteps_; }
+		// Real time discarded by the clamp so far
+		double droppedSeconds() const { return droppedSeconds_; }
+
+	private:
+		double step_ = 1.0 / 120.0;
+		uint32_t maxSteps_ = 8;
+		double accumulator_ = 0.0;
+		uint64_t totalSteps_ = 0;
+		double droppedSeconds_ = 0.0;
+	};
+}
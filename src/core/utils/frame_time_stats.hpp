@@ -0,0 +1,54 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace luster
+{
+	struct FrameTimeSummary
+	{
+		size_t count = 0;
+		double minMs = 0.0;
+		double meanMs = 0.0;
+		double p50Ms = 0.0;
+		double p95Ms = 0.0;
+		double p99Ms = 0.0;
+		double maxMs = 0.0;
+		// Frames slower than stutterFactor * median
+		uint32_t stutterCount = 0;
+	};
+
+	// Linear interpolation between closest ranks; `sorted` must be ascending and non-empty
+	inline double percentileSorted(const std::vector<double>& sorted, double p)
+	{
+		if (sorted.empty()) return 0.0;
+		const double rank = std::clamp(p, 0.0, 100.0) / 100.0 * static_cast<double>(sorted.size() - 1);
+		const size_t lo = static_cast<size_t>(rank);
+		const size_t hi = std::min(lo + 1, sorted.size() - 1);
+		const double frac = rank - static_cast<double>(lo);
+		return sorted[lo] + (sorted[hi] - sorted[lo]) * frac;
+	}
+
+	// Takes samples by value: sorting a copy keeps the caller's frame order intact
+	inline FrameTimeSummary summarizeFrameTimes(std::vector<double> samplesMs, double stutterFactor = 2.0)
+	{
+		FrameTimeSummary s{};
+		if (samplesMs.empty()) return s;
+		std::sort(samplesMs.begin(), samplesMs.end());
+		s.count = samplesMs.size();
+		s.minMs = samplesMs.front();
+		s.maxMs = samplesMs.back();
+		double sum = 0.0;
+		for (double v : samplesMs) sum += v;
+		s.meanMs = sum / static_cast<double>(s.count);
+		s.p50Ms = percentileSorted(samplesMs, 50.0);
+		s.p95Ms = percentileSorted(samplesMs, 95.0);
+		s.p99Ms = percentileSorted(samplesMs, 99.0);
+		const double limit = s.p50Ms * stutterFactor;
+		const auto firstStutter = std::upper_bound(samplesMs.begin(), samplesMs.end(), limit);
+		s.stutterCount = static_cast<uint32_t>(samplesMs.end() - firstStutter);
+		return s;
+	}
+}
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+namespace luster
+{
+	// Non-owning reference to a callable: two pointers, never allocates (a std::function built from a lambda
+	// with more than a couple of captures does, on every call site). The callable must outlive the reference,
+	// so use it for parameters invoked before the call returns, never for stored callbacks.
+	template <typename Signature>
+	class FunctionRef;
+
+	template <typename R, typename... Args>
+	class FunctionRef<R(Args...)>
+	{
+	public:
+		FunctionRef() = default;
+
+		template <typename F>
+			requires (!std::is_same_v<std::remove_cvref_t<F>, FunctionRef> && std::is_invocable_r_v<R, F&, Args...>)
+		FunctionRef(F&& f) noexcept
+			: object_(const_cast<void*>(static_cast<const void*>(std::addressof(f)))),
+			  call_([](void* object, Args... args) -> R
+			  {
+				  return std::invoke(*static_cast<std::remove_reference_t<F>*>(object), std::forward<Args>(args)...);
+			  }) {}
+
+		R operator()(Args... args) const { return call_(object_, std::forward<Args>(args)...); }
+		explicit operator bool() const { return call_ != nullptr; }
+
+	private:
+		void* object_ = nullptr;
+		R (*call_)(void*, Args...) = nullptr;
+	};
+}
@@ -0,0 +1,175 @@
+#pragma once
+
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Stale-handle checks in at(): on in debug builds, where a use-after-free throws instead of reading another object
+#ifndef LUSTER_CHECK_HANDLES
+#  ifdef NDEBUG
+#    define LUSTER_CHECK_HANDLES 0
+#  else
+#    define LUSTER_CHECK_HANDLES 1
+#  endif
+#endif
+
+namespace luster
+{
+	// 32-bit generational handle: 20-bit slot index + 12-bit generation, 0 = null. A plain value: copy it across
+	// threads, jobs and frames freely. Typed, so a Handle<Image> never resolves in a buffer pool.
+	template <typename T>
+	struct Handle
+	{
+		static constexpr uint32_t kIndexBits = 20;
+		static constexpr uint32_t kMaxIndex = (1u << kIndexBits) - 1;
+		static constexpr uint32_t kMaxGeneration = (1u << (32 - kIndexBits)) - 1;
+
+		uint32_t value = 0;
+
+		static Handle make(uint32_t index, uint32_t generation) { return {generation << kIndexBits | index}; }
+		uint32_t index() const { return value & kMaxIndex; }
+		uint32_t generation() const { return value >> kIndexBits; }
+		bool valid() const { return value != 0; }
+		explicit operator bool() const { return valid(); }
+		friend bool operator==(Handle, Handle) = default;
+	};
+
+	// Dense typed storage addressed by Handle<T>: live objects sit contiguously (iteration never touches holes),
+	// a slot table maps a handle's index to the object's position. Insert, lookup and remove are O(1); remove
+	// moves the last object into the hole. References are invalidated by insert/remove: keep handles, not pointers.
+	// A slot's generation bumps on every remove, so old handles stop resolving; a slot whose generation is used up
+	// is retired rather than reused. Not thread-safe: concurrent lookups are fine while nobody inserts or removes.
+	template <typename T>
+	class HandlePool
+	{
+	public:
+		using HandleType = Handle<T>;
+
+		HandleType insert(T object)
+		{
+			uint32_t index;
+			if (!free_.empty())
+			{
+				index = free_.back();
+				free_.pop_back();
+			}
+			else
+			{
+				if (slots_.size() >= HandleType::kMaxIndex)
+					throw std::runtime_error("HandlePool: out of handle indices");
+				index = static_cast<uint32_t>(slots_.size());
+				slots_.push_back({kNoObject, 1});
+			}
+			slots_[index].dense = static_cast<uint32_t>(objects_.size());
+			objects_.push_back(std::move(object));
+			owners_.push_back(index);
+			return HandleType::make(index, slots_[index].generation);
+		}
+
+		bool contains(HandleType h) const
+		{
+			const uint32_t i = h.index();
+			return h.valid() && i < slots_.size() && slots_[i].dense != kNoObject &&
+				slots_[i].generation == h.generation();
+		}
+
+		// nullptr for null and stale handles
+		T* get(HandleType h) { return contains(h) ? &objects_[slots_[h.index()].dense] : nullptr; }
+		const T* get(HandleType h) const { return contains(h) ? &objects_[slots_[h.index()].dense] : nullptr; }
+
+		// Handle known to be live: unchecked in release builds
+		T& at(HandleType h)
+		{
+			check(h);
+			return objects_[slots_[h.index()].dense];
+		}
+		const T& at(HandleType h) const
+		{
+			check(h);
+			return objects_[slots_[h.index()].dense];
+		}
+
+		// Takes the object out (the caller releases its GPU objects); throws on a stale handle
+		T remove(HandleType h)
+		{
+			if (!contains(h)) throw std::runtime_error("HandlePool: remove of a stale handle");
+			Slot& slot = slots_[h.index()];
+			const uint32_t dense = slot.dense;
+			T out = std::move(objects_[dense]);
+			const uint32_t last = static_cast<uint32_t>(objects_.size() - 1);
+			if (dense != last)
+			{
+				objects_[dense] = std::move(objects_[last]);
+				owners_[dense] = owners_[last];
+				slots_[owners_[dense]].dense = dense;
+			}
+			objects_.pop_back();
+			owners_.pop_back();
+			slot.dense = kNoObject;
+			if (slot.generation < HandleType::kMaxGeneration)
+			{
+				++slot.generation;
+				free_.push_back(h.index());
+			}
+			return out;
+		}
+
+		size_t size() const { return objects_.size(); }
+		bool empty() const { return objects_.empty(); }
+		void reserve(size_t n)
+		{
+			objects_.reserve(n);
+			owners_.reserve(n);
+		}
+		// Live objects in dense order (not insertion order)
+		std::vector<T>& objects() { return objects_; }
+		const std::vector<T>& objects() const { return objects_; }
+		// Handle of objects()[dense], for walks that need to refer back to what they visit
+		HandleType handleAt(size_t dense) const
+		{
+			const uint32_t index = owners_[dense];
+			return HandleType::make(index, slots_[index].generation);
+		}
+
+		// Drops every object; outstanding handles stop resolving
+		void clear()
+		{
+			for (uint32_t index : owners_)
+			{
+				Slot& slot = slots_[index];
+				slot.dense = kNoObject;
+				if (slot.generation < HandleType::kMaxGeneration)
+				{
+					++slot.generation;
+					free_.push_back(index);
+				}
+			}
+			objects_.clear();
+			owners_.clear();
+		}
+
+	private:
+		static constexpr uint32_t kNoObject = UINT32_MAX;
+		struct Slot
+		{
+			uint32_t dense = kNoObject;
+			uint32_t generation = 1; // 0 never appears in a live handle: value 0 stays null
+		};
+
+		void check([[maybe_unused]] HandleType h) const
+		{
+#if LUSTER_CHECK_HANDLES
+			if (!contains(h))
+				throw std::runtime_error("HandlePool: stale or null handle (index " + std::to_string(h.index()) +
+				                         ", generation " + std::to_string(h.generation()) + ")");
+#endif
+		}
+
+		std::vector<T> objects_{};
+		std::vector<uint32_t> owners_{}; // dense position -> slot index
+		std::vector<Slot> slots_{};
+		std::vector<uint32_t> free_{};
+	};
+}
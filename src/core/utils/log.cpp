@@ -1,9 +1,226 @@
 #include "core/utils/log.hpp"
+#include "core/memory/alloc_tracker.hpp"
+#include "core/utils/profiler.hpp"
+#include <chrono>
+#include <condition_variable>
+#include <csignal>
+#include <cstdlib>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <spdlog/details/null_mutex.h>
+#include <spdlog/details/os.h>
+#include <spdlog/sinks/base_sink.h>
 #include <spdlog/sinks/stdout_color_sinks.h>
 #include <spdlog/sinks/basic_file_sink.h>
 
 namespace luster
 {
+	namespace
+	{
+		static_assert((Log::kQueueCapacity & (Log::kQueueCapacity - 1)) == 0, "queue capacity must be a power of two");
+
+		constexpr auto kWriterIdleWait = std::chrono::milliseconds(2);
+		constexpr auto kCrashDrainTimeout = std::chrono::seconds(1);
+
+		// Bounded MPSC ring (Vyukov): a producer claims a cell with one CAS on enqueuePos and publishes it through
+		// the cell's sequence number; a full ring fails the claim instead of waiting
+		struct Cell
+		{
+			std::atomic<uint64_t> sequence{0};
+			LogRecord record{};
+		};
+
+		struct Pipeline
+		{
+			std::unique_ptr<Cell[]> cells{};
+			alignas(64) std::atomic<uint64_t> enqueuePos{0};
+			alignas(64) std::atomic<uint64_t> dequeuePos{0}; // advanced by the writer only
+			std::atomic<uint64_t> dropped{0};
+			std::atomic<bool> running{false};
+			std::atomic<bool> stop{false};
+			std::vector<spdlog::sink_ptr> sinks{};
+			std::thread writer{};
+			std::mutex wakeMutex{};
+			std::condition_variable wake{};
+
+			// Exit without Log::shutdown(): destroying a joinable std::thread would call std::terminate
+			~Pipeline()
+			{
+				if (!writer.joinable()) return;
+				running.store(false, std::memory_order_release);
+				stop.store(true, std::memory_order_release);
+				wake.notify_one();
+				writer.join();
+			}
+		};
+
+		Pipeline& pipeline()
+		{
+			static Pipeline p;
+			return p;
+		}
+
+		// Feeds spdlog::info(...) & co. into the queue: spdlog formats the arguments on the caller, the pattern
+		// and the sinks run on the writer
+		class QueueSink final : public spdlog::sinks::base_sink<spdlog::details::null_mutex>
+		{
+		protected:
+			void sink_it_(const spdlog::details::log_msg& msg) override
+			{
+				Log::enqueueText(msg.level, msg.time, std::string_view(msg.payload.data(), msg.payload.size()),
+				                 msg.thread_id);
+			}
+			void flush_() override { Log::flush(); }
+		};
+
+		void writeToSinks(Pipeline& p, spdlog::log_clock::time_point time, size_t threadId,
+		                  spdlog::level::level_enum level, std::string_view text)
+		{
+			spdlog::details::log_msg msg(time, spdlog::source_loc{}, "core", level,
+			                             spdlog::string_view_t(text.data(), text.size()));
+			msg.thread_id = threadId;
+			for (const auto& sink : p.sinks)
+			{
+				if (!sink->should_log(level)) continue;
+				try
+				{
+					sink->log(msg);
+				}
+				catch (const std::exception&)
+				{
+					// A failing sink (disk full...) must not take the writer down
+				}
+			}
+		}
+
+		void flushSinks(Pipeline& p)
+		{
+			for (const auto& sink : p.sinks)
+			{
+				try
+				{
+					sink->flush();
+				}
+				catch (const std::exception&)
+				{
+				}
+			}
+		}
+
+		// Writes the oldest published record; false when the ring is empty or its head is still being filled
+		bool writeOne(Pipeline& p, spdlog::memory_buf_t& text, bool& wroteWarning)
+		{
+			const uint64_t pos = p.dequeuePos.load(std::memory_order_relaxed);
+			Cell& cell = p.cells[pos & (Log::kQueueCapacity - 1)];
+			if (cell.sequence.load(std::memory_order_acquire) != pos + 1) return false;
+
+			LogRecord& r = cell.record;
+			std::string_view message;
+			if (r.formatFn)
+			{
+				text.clear();
+				try
+				{
+					r.formatFn(text, r.format, r.payload);
+					message = std::string_view(text.data(), text.size());
+				}
+				catch (const std::exception&)
+				{
+					message = r.format; // the raw format string beats losing the message
+				}
+			}
+			else if (r.longText)
+				message = *r.longText;
+			else
+				message = std::string_view(reinterpret_cast<const char*>(r.payload), r.textSize);
+			writeToSinks(p, r.time, r.threadId, r.level, message);
+			wroteWarning |= r.level >= spdlog::level::warn;
+			delete r.longText;
+			r.longText = nullptr;
+
+			cell.sequence.store(pos + Log::kQueueCapacity, std::memory_order_release);
+			p.dequeuePos.store(pos + 1, std::memory_order_release);
+			return true;
+		}
+
+		void writerLoop(Pipeline& p)
+		{
+			Profiler::setThreadName("log writer");
+			LUSTER_ALLOC_TAG(Logging);
+			spdlog::memory_buf_t text;
+			uint64_t reportedDrops = 0;
+			for (;;)
+			{
+				bool wroteWarning = false;
+				bool wrote = false;
+				while (writeOne(p, text, wroteWarning)) wrote = true;
+
+				const uint64_t dropped = p.dropped.load(std::memory_order_relaxed);
+				if (dropped != reportedDrops)
+				{
+					text.clear();
+					fmt::format_to(std::back_inserter(text), "Log queue full: {} messages dropped", dropped - reportedDrops);
+					writeToSinks(p, spdlog::log_clock::now(), spdlog::details::os::thread_id(), spdlog::level::warn,
+					             std::string_view(text.data(), text.size()));
+					reportedDrops = dropped;
+					wroteWarning = true;
+				}
+				// Warnings and errors reach the file right away; info lines ride the stream buffers
+				if (wroteWarning) flushSinks(p);
+
+				if (!wrote)
+				{
+					if (p.stop.load(std::memory_order_acquire)) break;
+					// Producers never notify (that would cost them a syscall): poll at a short interval instead
+					std::unique_lock lock(p.wakeMutex);
+					p.wake.wait_for(lock, kWriterIdleWait);
+				}
+			}
+			flushSinks(p);
+		}
+
+		// Best effort from a dying thread: wait for the writer to catch up, then flush. Not async-signal-safe,
+		// but the alternative is losing the messages that explain the crash.
+		void drainForCrash()
+		{
+			Pipeline& p = pipeline();
+			if (!p.running.load(std::memory_order_acquire)) return;
+			if (std::this_thread::get_id() != p.writer.get_id())
+			{
+				const uint64_t target = p.enqueuePos.load(std::memory_order_acquire);
+				const auto deadline = std::chrono::steady_clock::now() + kCrashDrainTimeout;
+				while (p.dequeuePos.load(std::memory_order_acquire) < target &&
+				       std::chrono::steady_clock::now() < deadline)
+					std::this_thread::sleep_for(std::chrono::milliseconds(1));
+			}
+			flushSinks(p);
+		}
+
+		void onFatalSignal(int signal)
+		{
+			drainForCrash();
+			std::signal(signal, SIG_DFL);
+			std::raise(signal);
+		}
+
+		std::terminate_handler gPreviousTerminate = nullptr;
+
+		void installCrashHandlers()
+		{
+			static bool installed = false;
+			if (installed) return;
+			installed = true;
+			for (int signal : {SIGSEGV, SIGABRT, SIGFPE, SIGILL})
+				std::signal(signal, onFatalSignal);
+			gPreviousTerminate = std::set_terminate([] {
+				drainForCrash();
+				if (gPreviousTerminate) gPreviousTerminate();
+				std::abort();
+			});
+		}
+	}
+
 	std::shared_ptr<spdlog::logger> Log::coreLogger_{};
 
 	void Log::init()
@@ -13,18 +230,47 @@ namespace luster
 		std::vector<spdlog::sink_ptr> sinks;
 		sinks.push_back(std::make_shared<spdlog::sinks::stdout_color_sink_mt>());
 		sinks.push_back(std::make_shared<spdlog::sinks::basic_file_sink_mt>("luster.log", true));
-		coreLogger_ = std::make_shared<spdlog::logger>("core", sinks.begin(), sinks.end());
+		for (const auto& sink : sinks) sink->set_pattern("[%H:%M:%S.%e] [%^%l%$] %v");
+		init(std::move(sinks));
+	}
+
+	void Log::init(std::vector<spdlog::sink_ptr> sinks)
+	{
+		if (coreLogger_) return;
+
+		Pipeline& p = pipeline();
+		p.cells = std::make_unique<Cell[]>(kQueueCapacity);
+		for (size_t i = 0; i < kQueueCapacity; ++i) p.cells[i].sequence.store(i, std::memory_order_relaxed);
+		p.enqueuePos.store(0, std::memory_order_relaxed);
+		p.dequeuePos.store(0, std::memory_order_relaxed);
+		p.dropped.store(0, std::memory_order_relaxed);
+		p.stop.store(false, std::memory_order_relaxed);
+		p.sinks = std::move(sinks);
+
+		coreLogger_ = std::make_shared<spdlog::logger>("core", std::make_shared<QueueSink>());
 #if defined(LUSTER_LOG_LEVEL)
 		coreLogger_->set_level(static_cast<spdlog::level::level_enum>(LUSTER_LOG_LEVEL));
 #else
         coreLogger_->set_level(spdlog::level::info);
 #endif
-		coreLogger_->set_pattern("[%H:%M:%S.%e] [%^%l%$] %v");
 		spdlog::set_default_logger(coreLogger_);
+
+		p.running.store(true, std::memory_order_release);
+		p.writer = std::thread(writerLoop, std::ref(p));
+		installCrashHandlers();
 	}
 
 	void Log::shutdown()
 	{
+		Pipeline& p = pipeline();
+		if (p.running.exchange(false, std::memory_order_acq_rel))
+		{
+			// The writer drains everything published before it stops
+			p.stop.store(true, std::memory_order_release);
+			p.wake.notify_one();
+			p.writer.join();
+			p.sinks.clear();
+		}
 		coreLogger_.reset();
 		spdlog::shutdown();
 	}
@@ -33,4 +279,93 @@ namespace luster
 	{
 		return coreLogger_;
 	}
+
+	void Log::flush()
+	{
+		Pipeline& p = pipeline();
+		if (!p.running.load(std::memory_order_acquire)) return;
+		if (std::this_thread::get_id() == p.writer.get_id()) return; // a sink logging from the writer
+		const uint64_t target = p.enqueuePos.load(std::memory_order_acquire);
+		p.wake.notify_one();
+		while (p.dequeuePos.load(std::memory_order_acquire) < target)
+			std::this_thread::sleep_for(std::chrono::microseconds(100));
+		flushSinks(p);
+	}
+
+	uint64_t Log::droppedCount()
+	{
+		return pipeline().dropped.load(std::memory_order_relaxed);
+	}
+
+	LogRecord* Log::beginRecord(spdlog::level::level_enum level, spdlog::log_clock::time_point time) noexcept
+	{
+		Pipeline& p = pipeline();
+		if (!p.running.load(std::memory_order_relaxed)) return nullptr;
+		uint64_t pos = p.enqueuePos.load(std::memory_order_relaxed);
+		for (;;)
+		{
+			Cell& cell = p.cells[pos & (kQueueCapacity - 1)];
+			const uint64_t sequence = cell.sequence.load(std::memory_order_acquire);
+			const int64_t diff = static_cast<int64_t>(sequence - pos);
+			if (diff == 0)
+			{
+				if (p.enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+				{
+					LogRecord& r = cell.record;
+					r.time = time;
+					r.threadId = spdlog::details::os::thread_id();
+					r.level = level;
+					r.formatFn = nullptr;
+					r.format = {};
+					r.longText = nullptr;
+					r.textSize = 0;
+					return &r;
+				}
+			}
+			else if (diff < 0)
+			{
+				// Full: the writer is a whole ring behind. Drop rather than stall the caller.
+				p.dropped.fetch_add(1, std::memory_order_relaxed);
+				return nullptr;
+			}
+			else
+				pos = p.enqueuePos.load(std::memory_order_relaxed);
+		}
+	}
+
+	void Log::commitRecord(LogRecord* record) noexcept
+	{
+		Pipeline& p = pipeline();
+		// Cells are one array: the record's cell follows from its address
+		const size_t index = static_cast<size_t>(reinterpret_cast<const std::byte*>(record) -
+			reinterpret_cast<const std::byte*>(&p.cells[0].record)) / sizeof(Cell);
+		Cell& cell = p.cells[index];
+		// Only the claiming producer touches the cell until this store: sequence still equals its position
+		cell.sequence.store(cell.sequence.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+	}
+
+	void Log::enqueueText(spdlog::level::level_enum level, spdlog::log_clock::time_point time, std::string_view text,
+	                      size_t threadId)
+	{
+		LogRecord* r = beginRecord(level, time);
+		if (!r) return;
+		if (threadId) r->threadId = threadId;
+		if (text.size() > LogRecord::kPayloadBytes)
+		{
+			try
+			{
+				r->longText = new std::string(text);
+			}
+			catch (const std::bad_alloc&)
+			{
+				text = text.substr(0, LogRecord::kPayloadBytes);
+			}
+		}
+		if (!r->longText)
+		{
+			std::memcpy(r->payload, text.data(), text.size());
+			r->textSize = static_cast<uint32_t>(text.size());
+		}
+		commitRecord(r);
+	}
 }
@@ -1,19 +1,210 @@
 #pragma once
 
 #include "core/core.hpp"
+#include <array>
+#include <atomic>
+#include <cstring>
+#include <iterator>
 #include <memory>
+#include <new>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
 #include <spdlog/spdlog.h>
 
 namespace luster
 {
+	// One queued log message: fixed size, so the queue never allocates per message
+	struct LogRecord
+	{
+		static constexpr size_t kPayloadBytes = 192;
+		// Formats `payload` (arguments packed by Log::write) with `format`
+		using FormatFn = void (*)(spdlog::memory_buf_t& out, std::string_view format, const std::byte* payload);
+
+		spdlog::log_clock::time_point time{};
+		size_t threadId = 0;
+		spdlog::level::level_enum level = spdlog::level::info;
+		FormatFn formatFn = nullptr; // nullptr: payload holds `textSize` bytes of text
+		std::string_view format{}; // compile-time format string (static storage)
+		std::string* longText = nullptr; // text that did not fit the payload (owned by the record)
+		uint32_t textSize = 0;
+		alignas(16) std::byte payload[kPayloadBytes];
+	};
+
+	// Value types a deferred record may carry besides numbers and enums: specialize as std::true_type next to the
+	// type's fmt::formatter. Only for types that hold their whole value (no pointer, reference or view inside).
+	template <class T>
+	struct LogDeferrable : std::false_type {};
+
+	// Asynchronous logging. Every message becomes a LogRecord in a bounded lock-free queue; a writer thread
+	// formats it and writes the sinks (console, luster.log), so the calling thread never touches a file or a sink
+	// mutex. When the queue is full the message is dropped and counted instead of waiting (the writer reports the
+	// drops), so hot threads never block on logging.
+	//  - spdlog::info(...) and friends still work: arguments are formatted on the caller, the rest is deferred.
+	//  - Log::info(...) defers the formatting too when every argument is a number, an enum or a LogDeferrable
+	//    type: the arguments are copied into the record and formatted on the writer thread. Anything else
+	//    (strings, pointers, views, types that may refer to other storage) is formatted eagerly, its storage may
+	//    be gone by then. So are fmt::runtime() format strings: a deferred record only keeps a view of the
+	//    format, which must be a string literal.
+	// Fatal signals and std::terminate drain the queue before the process dies.
 	class Log
 	{
 	public:
+		static constexpr size_t kQueueCapacity = 8192; // records, power of two
+		// fmt::runtime(...): format text built at run time, not checked at compile time
+		using RuntimeFormat = decltype(fmt::runtime(std::string_view{}));
+
 		static void init();
+		// Custom sinks (tests, tools); the writer thread is the only one calling them
+		static void init(std::vector<spdlog::sink_ptr> sinks);
 		static void shutdown();
 		static std::shared_ptr<spdlog::logger>& core();
 
+		// Blocks until everything logged before the call is written and the sinks are flushed (not for hot paths)
+		static void flush();
+		// Messages lost to a full queue since init()
+		static uint64_t droppedCount();
+
+		template <class... Args>
+		static void write(spdlog::level::level_enum level, spdlog::format_string_t<Args...> format, Args&&... args)
+		{
+			if (!coreLogger_ || !coreLogger_->should_log(level)) return;
+			if constexpr ((kDeferrable<std::remove_cvref_t<Args>> && ...) &&
+			              layout<std::remove_cvref_t<Args>...>().size <= LogRecord::kPayloadBytes)
+			{
+				LogRecord* record = beginRecord(level);
+				if (!record) return;
+				pack<std::remove_cvref_t<Args>...>(record->payload, std::index_sequence_for<Args...>{}, args...);
+				record->formatFn = &formatPacked<std::remove_cvref_t<Args>...>;
+				record->format = toStringView(format);
+				commitRecord(record);
+			}
+			else
+			{
+				spdlog::memory_buf_t text;
+				fmt::vformat_to(std::back_inserter(text), toStringView(format), fmt::make_format_args(args...));
+				enqueueText(level, spdlog::log_clock::now(), std::string_view(text.data(), text.size()));
+			}
+		}
+
+		// Runtime format strings may not outlive the call: always formatted on the calling thread
+		template <class... Args>
+		static void write(spdlog::level::level_enum level, RuntimeFormat format, Args&&... args)
+		{
+			if (!coreLogger_ || !coreLogger_->should_log(level)) return;
+			spdlog::memory_buf_t text;
+			fmt::vformat_to(std::back_inserter(text), format.str, fmt::make_format_args(args...));
+			enqueueText(level, spdlog::log_clock::now(), std::string_view(text.data(), text.size()));
+		}
+
+		template <class... Args>
+		static void debug(spdlog::format_string_t<Args...> format, Args&&... args)
+		{
+			write(spdlog::level::debug, format, std::forward<Args>(args)...);
+		}
+		template <class... Args>
+		static void info(spdlog::format_string_t<Args...> format, Args&&... args)
+		{
+			write(spdlog::level::info, format, std::forward<Args>(args)...);
+		}
+		template <class... Args>
+		static void warn(spdlog::format_string_t<Args...> format, Args&&... args)
+		{
+			write(spdlog::level::warn, format, std::forward<Args>(args)...);
+		}
+		template <class... Args>
+		static void error(spdlog::format_string_t<Args...> format, Args&&... args)
+		{
+			write(spdlog::level::err, format, std::forward<Args>(args)...);
+		}
+		template <class... Args>
+		static void debug(RuntimeFormat format, Args&&... args)
+		{
+			write(spdlog::level::debug, format, std::forward<Args>(args)...);
+		}
+		template <class... Args>
+		static void info(RuntimeFormat format, Args&&... args)
+		{
+			write(spdlog::level::info, format, std::forward<Args>(args)...);
+		}
+		template <class... Args>
+		static void warn(RuntimeFormat format, Args&&... args)
+		{
+			write(spdlog::level::warn, format, std::forward<Args>(args)...);
+		}
+		template <class... Args>
+		static void error(RuntimeFormat format, Args&&... args)
+		{
+			write(spdlog::level::err, format, std::forward<Args>(args)...);
+		}
+
+		// Queue plumbing, used by write() and the spdlog sink feeding the queue
+		static LogRecord* beginRecord(spdlog::level::level_enum level,
+		                              spdlog::log_clock::time_point time = spdlog::log_clock::now()) noexcept;
+		static void commitRecord(LogRecord* record) noexcept;
+		static void enqueueText(spdlog::level::level_enum level, spdlog::log_clock::time_point time,
+		                        std::string_view text, size_t threadId = 0);
+
 	private:
+		// Safe to copy now and format later: an allowlist, since a trivially copyable type may still point at
+		// storage that dies before the writer gets to it
+		template <class T>
+		static constexpr bool kDeferrable =
+			(std::is_arithmetic_v<T> || std::is_enum_v<T> || LogDeferrable<T>::value) &&
+			std::is_trivially_copyable_v<T> && alignof(T) <= alignof(LogRecord);
+
+		template <class Format>
+		static std::string_view toStringView(const Format& format)
+		{
+			const fmt::string_view view = format;
+			return {view.data(), view.size()};
+		}
+
+		struct Layout
+		{
+			std::array<size_t, 16> offsets{};
+			size_t size = 0;
+		};
+
+		// Offsets of each argument in the payload, naturally aligned
+		template <class... Args>
+		static constexpr Layout layout()
+		{
+			static_assert(sizeof...(Args) <= 16, "Log::write: at most 16 arguments");
+			Layout l;
+			[[maybe_unused]] size_t i = 0;
+			((l.size = (l.size + alignof(Args) - 1) / alignof(Args) * alignof(Args), l.offsets[i++] = l.size,
+			  l.size += sizeof(Args)), ...);
+			return l;
+		}
+
+		template <class... Args, size_t... I, class... Refs>
+		static void pack(std::byte* payload, std::index_sequence<I...>, const Refs&... args)
+		{
+			[[maybe_unused]] constexpr Layout l = layout<Args...>();
+			(std::memcpy(payload + l.offsets[I], &args, sizeof(Args)), ...);
+		}
+
+		template <class... Args>
+		static void formatPacked(spdlog::memory_buf_t& out, std::string_view format, const std::byte* payload)
+		{
+			formatPackedImpl<Args...>(out, format, payload, std::index_sequence_for<Args...>{});
+		}
+
+		template <class... Args, size_t... I>
+		static void formatPackedImpl(spdlog::memory_buf_t& out, std::string_view format, const std::byte* payload,
+		                             std::index_sequence<I...>)
+		{
+			[[maybe_unused]] constexpr Layout l = layout<Args...>();
+			// The memcpy in pack() created the objects in the payload (trivially copyable, aligned offsets)
+			std::tuple<const Args&...> args{*std::launder(reinterpret_cast<const Args*>(payload + l.offsets[I]))...};
+			fmt::vformat_to(std::back_inserter(out), fmt::string_view(format.data(), format.size()),
+			                fmt::make_format_args(std::get<I>(args)...));
+		}
+
 		static std::shared_ptr<spdlog::logger> coreLogger_;
 	};
 }
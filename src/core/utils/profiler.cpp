@@ -0,0 +1,359 @@
+#include "core/utils/profiler.hpp"
+#include <algorithm>
+#include <bit>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include <spdlog/fmt/fmt.h>
+
+namespace luster
+{
+	namespace
+	{
+		// Single producer (the owning thread) / single consumer (the thread stopping a capture)
+		struct ThreadBuffer
+		{
+			std::unique_ptr<Profiler::Event[]> events{}; // allocated on first record (guarded by State::mutex)
+			uint64_t capacity = 0; // power of two
+			std::atomic<uint64_t> head{0};
+			uint32_t tid = 0;
+			char name[32] = {};
+			uint64_t captureStart = 0; // head at capture start (guarded by State::mutex)
+			bool exited = false; // owning thread is gone; kept until the capture it may belong to ends
+		};
+
+		struct CapturedThread
+		{
+			uint32_t tid = 0;
+			std::string name;
+			std::vector<Profiler::Event> events;
+		};
+
+		struct State
+		{
+			// Guards registration and capture control; never taken by zones on the hot path
+			std::mutex mutex;
+			std::vector<std::unique_ptr<ThreadBuffer>> threads;
+			std::atomic<ThreadBuffer*> tracks[Profiler::kMaxTracks] = {};
+			uint32_t trackCount = 0;
+			uint32_t nextTid = 1;
+			uint64_t ringCapacity = Profiler::kDefaultRingCapacity;
+
+			std::atomic<bool> armed{false}; // a capture is pending or running
+			bool pending = false;
+			uint32_t pendingDelay = 0;
+			uint32_t pendingFrames = 0;
+			uint32_t framesRemaining = 0;
+
+			uint64_t startTicks = 0;
+			uint64_t endTicks = 0;
+			std::chrono::steady_clock::time_point startTime{};
+			std::chrono::steady_clock::time_point endTime{};
+			std::vector<CapturedThread> captured;
+			bool completed = false;
+		};
+
+		State& state()
+		{
+			static State s;
+			return s;
+		}
+
+		void allocateRingLocked(State& s, ThreadBuffer& buf)
+		{
+			buf.capacity = s.ringCapacity;
+			buf.events = std::make_unique<Profiler::Event[]>(buf.capacity);
+		}
+
+		// Drops exited threads' buffers, unless a capture may still need their events
+		void releaseExitedLocked(State& s)
+		{
+			if (s.armed.load(std::memory_order_relaxed)) return;
+			std::erase_if(s.threads, [](const std::unique_ptr<ThreadBuffer>& t) { return t->exited; });
+		}
+
+		// Registers the thread on first use and returns its ring to the profiler when the thread exits
+		struct ThreadRegistration
+		{
+			ThreadBuffer* buffer = nullptr;
+
+			~ThreadRegistration()
+			{
+				if (!buffer) return;
+				auto& s = state();
+				std::lock_guard lock(s.mutex);
+				buffer->exited = true;
+				releaseExitedLocked(s);
+			}
+		};
+		thread_local ThreadRegistration tlsRegistration;
+
+		ThreadBuffer* threadBuffer(bool withRing)
+		{
+			ThreadBuffer* buf = tlsRegistration.buffer;
+			if (buf && (buf->events || !withRing)) return buf;
+			auto& s = state();
+			std::lock_guard lock(s.mutex);
+			if (!buf)
+			{
+				auto owned = std::make_unique<ThreadBuffer>();
+				owned->tid = s.nextTid++;
+				std::snprintf(owned->name, sizeof(owned->name), "thread %u", owned->tid);
+				buf = tlsRegistration.buffer = owned.get();
+				s.threads.push_back(std::move(owned));
+			}
+			if (withRing && !buf->events) allocateRingLocked(s, *buf);
+			return buf;
+		}
+
+		void push(ThreadBuffer* buf, const char* name, Profiler::EventType type, uint64_t ticks) noexcept
+		{
+			const uint64_t h = buf->head.load(std::memory_order_relaxed);
+			Profiler::Event& e = buf->events[h & (buf->capacity - 1)];
+			e.name = name;
+			e.ticks = ticks;
+			e.type = type;
+			buf->head.store(h + 1, std::memory_order_release);
+		}
+
+		void startCaptureLocked(State& s)
+		{
+			for (auto& t : s.threads) t->captureStart = t->head.load(std::memory_order_acquire);
+			s.captured.clear();
+			s.completed = false;
+			s.pending = false;
+			s.framesRemaining = s.pendingFrames;
+			s.startTime = std::chrono::steady_clock::now();
+			s.startTicks = Profiler::nowTicks();
+			s.endTicks = s.startTicks;
+			s.endTime = s.startTime;
+		}
+
+		void stopCaptureLocked(State& s)
+		{
+			s.endTicks = Profiler::nowTicks();
+			s.endTime = std::chrono::steady_clock::now();
+			for (auto& t : s.threads)
+			{
+				if (!t->events) continue;
+				const uint64_t cap = t->capacity;
+				const uint64_t end = t->head.load(std::memory_order_acquire);
+				uint64_t begin = std::max(t->captureStart, end > cap ? end - cap : 0);
+				CapturedThread out{};
+				out.tid = t->tid;
+				out.name = t->name;
+				out.events.reserve(static_cast<size_t>(end - begin));
+				for (uint64_t i = begin; i < end; ++i) out.events.push_back(t->events[i & (cap - 1)]);
+				// The producer kept running while we copied: drop whatever it may have lapped over
+				const uint64_t after = t->head.load(std::memory_order_acquire);
+				if (after > cap && after - cap > begin)
+				{
+					const uint64_t lost = std::min<uint64_t>(after - cap - begin, out.events.size());
+					out.events.erase(out.events.begin(), out.events.begin() + static_cast<std::ptrdiff_t>(lost));
+				}
+				if (!out.events.empty()) s.captured.push_back(std::move(out));
+			}
+			s.completed = true;
+		}
+
+		void appendEscaped(std::string& out, const char* s)
+		{
+			for (; s && *s; ++s)
+			{
+				if (*s == '"' || *s == '\\') out += '\\';
+				out += *s;
+			}
+		}
+	}
+
+	std::atomic<bool> Profiler::capturing_{false};
+
+	void Profiler::record(const char* name, EventType type) noexcept
+	{
+		push(threadBuffer(true), name, type, nowTicks());
+	}
+
+	uint32_t Profiler::createTrack(const char* name)
+	{
+		auto& s = state();
+		std::lock_guard lock(s.mutex);
+		if (s.trackCount >= kMaxTracks) return kInvalidTrack;
+		auto buf = std::make_unique<ThreadBuffer>();
+		buf->tid = s.nextTid++;
+		std::snprintf(buf->name, sizeof(buf->name), "%s", name ? name : "");
+		allocateRingLocked(s, *buf);
+		// A track created mid-capture has an empty ring, so starting at 0 is correct
+		buf->captureStart = 0;
+		const uint32_t index = s.trackCount++;
+		s.tracks[index].store(buf.get(), std::memory_order_release);
+		s.threads.push_back(std::move(buf));
+		return index;
+	}
+
+	void Profiler::recordOnTrack(uint32_t track, const char* name, EventType type, uint64_t ticks) noexcept
+	{
+		if (track >= kMaxTracks) return;
+		if (ThreadBuffer* buf = state().tracks[track].load(std::memory_order_acquire))
+			push(buf, name, type, ticks);
+	}
+
+	double Profiler::ticksPerNanosecond()
+	{
+		static const uint64_t baseTicks = nowTicks();
+		static const auto baseTime = std::chrono::steady_clock::now();
+		const double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - baseTime).count();
+		const uint64_t ticks = nowTicks() - baseTicks;
+		// Precision improves with the interval; call once early (e.g. at init) to start the clock
+		if (ns <= 0.0 || ticks == 0) return 1.0;
+		return static_cast<double>(ticks) / ns;
+	}
+
+	void Profiler::frameMark() noexcept
+	{
+		auto& s = state();
+		if (!s.armed.load(std::memory_order_relaxed)) return;
+		threadBuffer(true); // register before taking the lock (registration locks too)
+		{
+			std::lock_guard lock(s.mutex);
+			if (capturing_.load(std::memory_order_relaxed))
+			{
+				if (s.framesRemaining > 0) --s.framesRemaining;
+				if (s.framesRemaining == 0)
+				{
+					capturing_.store(false, std::memory_order_relaxed);
+					stopCaptureLocked(s);
+					s.armed.store(false, std::memory_order_relaxed);
+					releaseExitedLocked(s);
+					return;
+				}
+			}
+			else if (s.pending)
+			{
+				if (s.pendingDelay > 0)
+				{
+					--s.pendingDelay;
+					return;
+				}
+				startCaptureLocked(s);
+				capturing_.store(true, std::memory_order_relaxed);
+			}
+		}
+		record("frame", EventType::FrameMark);
+	}
+
+	void Profiler::requestCapture(uint32_t frameCount, uint32_t delayFrames)
+	{
+		if (frameCount == 0) return;
+		auto& s = state();
+		std::lock_guard lock(s.mutex);
+		if (capturing_.load(std::memory_order_relaxed)) return; // one capture at a time
+		s.pending = true;
+		s.pendingDelay = delayFrames;
+		s.pendingFrames = frameCount;
+		s.armed.store(true, std::memory_order_relaxed);
+	}
+
+	bool Profiler::hasCompletedCapture()
+	{
+		auto& s = state();
+		std::lock_guard lock(s.mutex);
+		return s.completed;
+	}
+
+	void Profiler::setRingCapacity(uint32_t events)
+	{
+		auto& s = state();
+		std::lock_guard lock(s.mutex);
+		s.ringCapacity = std::bit_ceil(std::max<uint64_t>(events, 1024));
+	}
+
+	void Profiler::setThreadName(const char* name)
+	{
+		// Naming alone allocates no ring: threads that never record stay cheap
+		ThreadBuffer* buf = threadBuffer(false);
+		auto& s = state();
+		std::lock_guard lock(s.mutex);
+		std::snprintf(buf->name, sizeof(buf->name), "%s", name ? name : "");
+	}
+
+	std::string Profiler::chromeTraceJson()
+	{
+		auto& s = state();
+		std::lock_guard lock(s.mutex);
+
+		const double spanUs = std::chrono::duration<double, std::micro>(s.endTime - s.startTime).count();
+		const uint64_t spanTicks = s.endTicks > s.startTicks ? s.endTicks - s.startTicks : 1;
+		const double usPerTick = spanUs / static_cast<double>(spanTicks);
+		auto toUs = [&](uint64_t ticks)
+		{
+			return ticks > s.startTicks ? static_cast<double>(ticks - s.startTicks) * usPerTick : 0.0;
+		};
+
+		std::string out;
+		out.reserve(256 + 64 * [&]
+		{
+			size_t n = 0;
+			for (const auto& t : s.captured) n += t.events.size();
+			return n;
+		}());
+		auto it = std::back_inserter(out);
+		out += "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+		bool first = true;
+		auto sep = [&] { out += first ? "" : ",\n"; first = false; };
+		for (const auto& t : s.captured)
+		{
+			sep();
+			out += "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,";
+			fmt::format_to(it, "\"tid\":{},\"args\":{{\"name\":\"", t.tid);
+			appendEscaped(out, t.name.c_str());
+			out += "\"}}";
+
+			uint32_t depth = 0;
+			for (const auto& e : t.events)
+			{
+				if (e.type == EventType::End && depth == 0) continue; // zone opened before the capture
+				sep();
+				if (e.type == EventType::Begin)
+				{
+					++depth;
+					out += "{\"name\":\"";
+					appendEscaped(out, e.name);
+					fmt::format_to(it, "\",\"ph\":\"B\",\"ts\":{:.3f},\"pid\":1,\"tid\":{}}}", toUs(e.ticks), t.tid);
+				}
+				else if (e.type == EventType::End)
+				{
+					--depth;
+					fmt::format_to(it, "{{\"ph\":\"E\",\"ts\":{:.3f},\"pid\":1,\"tid\":{}}}", toUs(e.ticks), t.tid);
+				}
+				else
+				{
+					fmt::format_to(it, "{{\"name\":\"frame\",\"ph\":\"i\",\"s\":\"g\",\"ts\":{:.3f},\"pid\":1,\"tid\":{}}}",
+					               toUs(e.ticks), t.tid);
+				}
+			}
+			// Zones still open when the capture stopped end at the capture boundary
+			for (; depth > 0; --depth)
+			{
+				sep();
+				fmt::format_to(it, "{{\"ph\":\"E\",\"ts\":{:.3f},\"pid\":1,\"tid\":{}}}", toUs(s.endTicks), t.tid);
+			}
+		}
+		out += "\n]}\n";
+		return out;
+	}
+
+	bool Profiler::writeChromeTrace(const std::string& path)
+	{
+		const std::string json = chromeTraceJson();
+		std::ofstream f(path, std::ios::binary);
+		f << json;
+		if (!f) return false;
+		auto& s = state();
+		std::lock_guard lock(s.mutex);
+		s.completed = false;
+		return true;
+	}
+}
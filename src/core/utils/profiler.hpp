@@ -1,46 +1,122 @@
 #pragma once
 
+#include <atomic>
 #include <chrono>
+#include <cstdint>
 #include <string>
-#include <utility>
 #include <spdlog/spdlog.h>
 
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#define LUSTER_PROFILER_TSC 1
+#elif (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#include <x86intrin.h>
+#define LUSTER_PROFILER_TSC 1
+#else
+#define LUSTER_PROFILER_TSC 0
+#endif
+
 namespace luster
 {
-	class ScopedTimer
+	// Hierarchical CPU profiler.
+	// Zones write {name, ticks, type} into a lock-free ring buffer owned by the calling thread; nothing is
+	// formatted or allocated on the hot path, and zones are a single relaxed load while no capture is running.
+	// Captures span a frame range (driven by frameMark()) and export as Chrome trace JSON, which
+	// chrome://tracing and ui.perfetto.dev both open directly.
+	class Profiler
 	{
 	public:
-		explicit ScopedTimer(std::string name)
-			: name_(std::move(name)), start_(std::chrono::high_resolution_clock::now())
+		enum class EventType : uint32_t { Begin, End, FrameMark };
+
+		struct Event
 		{
+			const char* name; // static string literal, never owned
+			uint64_t ticks;
+			EventType type;
+		};
+
+		// Events per thread ring (24 bytes each); older events are overwritten (and dropped from the capture) on
+		// overflow. A thread gets its ring when it first records, and gives it back when it exits.
+		static constexpr uint32_t kDefaultRingCapacity = 1u << 16;
+		// Rings allocated after the call use `events` (rounded up to a power of two, at least 1024)
+		static void setRingCapacity(uint32_t events);
+
+		// Returns true if the zone was recorded (caller must then call endZone())
+		static bool beginZone(const char* name) noexcept
+		{
+			if (!capturing_.load(std::memory_order_relaxed)) return false;
+			record(name, EventType::Begin);
+			return true;
 		}
 
-		~ScopedTimer()
+		static void endZone() noexcept { record(nullptr, EventType::End); }
+
+		// Call once per frame from the main loop; starts/stops pending captures
+		static void frameMark() noexcept;
+
+		// Capture `frameCount` frames starting `delayFrames` frame marks from now
+		static void requestCapture(uint32_t frameCount, uint32_t delayFrames = 0);
+		static bool isCapturing() { return capturing_.load(std::memory_order_relaxed); }
+		// True once a requested capture finished and has not been written yet
+		static bool hasCompletedCapture();
+		static bool writeChromeTrace(const std::string& path);
+		static std::string chromeTraceJson();
+
+		// Names the calling thread in exported traces (copied, max 31 chars)
+		static void setThreadName(const char* name);
+
+		// Virtual tracks carry events produced on behalf of something else (e.g. GPU timings).
+		// Each track must have a single producer thread; returns kInvalidTrack once kMaxTracks are in use.
+		static constexpr uint32_t kMaxTracks = 8;
+		static constexpr uint32_t kInvalidTrack = ~0u;
+		static uint32_t createTrack(const char* name);
+		static void recordOnTrack(uint32_t track, const char* name, EventType type, uint64_t ticks) noexcept;
+		// nowTicks() rate, measured against steady_clock since the first call
+		static double ticksPerNanosecond();
+
+		static uint64_t nowTicks() noexcept
 		{
-			auto end = std::chrono::high_resolution_clock::now();
-			auto us = std::chrono::duration_cast<std::chrono::microseconds>(end - start_).count();
-#if LUSTER_PRINT_PROFILING
-            spdlog::info("[PROFILE] {}: {} us", name_, us);
+#if LUSTER_PROFILER_TSC
+			return __rdtsc();
+#else
+			return static_cast<uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count());
 #endif
 		}
 
 	private:
-		std::string name_;
-		std::chrono::high_resolution_clock::time_point start_;
+		static void record(const char* name, EventType type) noexcept;
+
+		static std::atomic<bool> capturing_;
+	};
+
+	// RAII zone; only pairs an end event with a begin event it actually recorded
+	class ProfileZone
+	{
+	public:
+		explicit ProfileZone(const char* name) noexcept : active_(Profiler::beginZone(name)) {}
+		~ProfileZone() { if (active_) Profiler::endZone(); }
+
+		ProfileZone(const ProfileZone&) = delete;
+		ProfileZone& operator=(const ProfileZone&) = delete;
+
+	private:
+		bool active_;
 	};
 
 #if !defined(LUSTER_ENABLE_PROFILING)
 #define LUSTER_ENABLE_PROFILING 1
 #endif
 
-	// 控制是否打印 PROFILE 日志（默认不打印）
-#if !defined(LUSTER_PRINT_PROFILING)
-#define LUSTER_PRINT_PROFILING 0
-#endif
+#define LUSTER_PROFILE_CONCAT_INNER(a, b) a##b
+#define LUSTER_PROFILE_CONCAT(a, b) LUSTER_PROFILE_CONCAT_INNER(a, b)
 
 #if LUSTER_ENABLE_PROFILING
-#define PROFILE_SCOPE(name_literal) ::luster::ScopedTimer _luster_profiler_timer_##__LINE__(name_literal)
+	// `"" name_literal` rejects non-literals at compile time: the profiler stores the pointer, not a copy
+#define PROFILE_SCOPE(name_literal) \
+	::luster::ProfileZone LUSTER_PROFILE_CONCAT(_luster_profile_zone_, __LINE__)("" name_literal)
+#define PROFILE_FRAME_MARK() ::luster::Profiler::frameMark()
 #else
 #define PROFILE_SCOPE(name_literal) do {} while(0)
+#define PROFILE_FRAME_MARK() do {} while(0)
 #endif
 }
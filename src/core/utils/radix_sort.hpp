@@ -0,0 +1,136 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <barrier>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+namespace luster
+{
+	// LSD radix sort of 64-bit keys carrying a 32-bit payload, 8 bits per pass. Stable.
+	// Byte positions where all keys agree are skipped, so keys that only use a few bit ranges
+	// (e.g. sort keys with constant fields) cost a few passes instead of eight.
+	// The serial path reads the keys once for all digit histograms, then only scatters per pass.
+	// With threadCount > 1 each pass histograms and scatters per chunk on its own thread (the caller is
+	// one of them); counts are merged per digit in chunk order, so the result equals the serial one.
+	// keyScratch/valueScratch must hold n entries. Below parallelThreshold keys the sort runs serially:
+	// starting threads costs more than sorting.
+	inline void radixSortPairs(uint64_t* keys, uint32_t* values, size_t n, uint64_t* keyScratch,
+	                           uint32_t* valueScratch, uint32_t threadCount = 1, size_t parallelThreshold = 16384)
+	{
+		if (n < 2) return;
+		using Histogram = std::array<uint32_t, 256>;
+		// One read for all eight digit histograms: a byte's histogram does not change as passes permute keys
+		std::array<Histogram, 8> global{};
+		for (size_t i = 0; i < n; ++i)
+		{
+			const uint64_t k = keys[i];
+			for (uint32_t byte = 0; byte < 8; ++byte) ++global[byte][(k >> (byte * 8)) & 0xFFu];
+		}
+		std::array<uint32_t, 8> passBytes{};
+		uint32_t passCount = 0;
+		for (uint32_t byte = 0; byte < 8; ++byte)
+			if (global[byte][(keys[0] >> (byte * 8)) & 0xFFu] != n) passBytes[passCount++] = byte;
+		if (passCount == 0) return; // all keys equal
+
+		const uint32_t threads = n < parallelThreshold ? 1u : std::clamp<uint32_t>(threadCount, 1u, 64u);
+		uint64_t* srcKeys = keys;
+		uint32_t* srcValues = values;
+		uint64_t* dstKeys = keyScratch;
+		uint32_t* dstValues = valueScratch;
+
+		if (threads == 1)
+		{
+			for (uint32_t p = 0; p < passCount; ++p)
+			{
+				const uint32_t shift = passBytes[p] * 8;
+				// Local cursors: the compiler cannot prove dstValues does not alias a shared histogram
+				Histogram cursor = global[passBytes[p]];
+				uint32_t sum = 0;
+				for (auto& c : cursor)
+				{
+					const uint32_t count = c;
+					c = sum;
+					sum += count;
+				}
+				for (size_t i = 0; i < n; ++i)
+				{
+					const uint32_t pos = cursor[(srcKeys[i] >> shift) & 0xFFu]++;
+					dstKeys[pos] = srcKeys[i];
+					dstValues[pos] = srcValues[i];
+				}
+				std::swap(srcKeys, dstKeys);
+				std::swap(srcValues, dstValues);
+			}
+		}
+		else
+		{
+			// Chunk histograms depend on the current order, so they are recounted every pass
+			std::vector<Histogram> counts(threads); // per thread: counts, then scatter cursors
+			// Turns per-chunk counts into per-chunk write cursors: digit-major, chunk-minor keeps it stable
+			const auto prefix = [&]() noexcept
+			{
+				uint32_t sum = 0;
+				for (uint32_t d = 0; d < 256; ++d)
+					for (uint32_t t = 0; t < threads; ++t)
+					{
+						const uint32_t c = counts[t][d];
+						counts[t][d] = sum;
+						sum += c;
+					}
+			};
+			// Two arrivals per pass: after counting (completion merges the counts) and after scattering
+			std::barrier sync(static_cast<std::ptrdiff_t>(threads), prefix);
+			std::barrier passDone(static_cast<std::ptrdiff_t>(threads));
+			const auto worker = [&](uint32_t t)
+			{
+				const size_t begin = n * t / threads;
+				const size_t end = n * (t + 1) / threads;
+				uint64_t* sk = srcKeys;
+				uint32_t* sv = srcValues;
+				uint64_t* dk = dstKeys;
+				uint32_t* dv = dstValues;
+				for (uint32_t p = 0; p < passCount; ++p)
+				{
+					const uint32_t shift = passBytes[p] * 8;
+					Histogram& h = counts[t];
+					h.fill(0);
+					for (size_t i = begin; i < end; ++i) ++h[(sk[i] >> shift) & 0xFFu];
+					sync.arrive_and_wait();
+					Histogram cursor = h;
+					for (size_t i = begin; i < end; ++i)
+					{
+						const uint32_t pos = cursor[(sk[i] >> shift) & 0xFFu]++;
+						dk[pos] = sk[i];
+						dv[pos] = sv[i];
+					}
+					passDone.arrive_and_wait();
+					std::swap(sk, dk);
+					std::swap(sv, dv);
+				}
+			};
+			{
+				std::vector<std::jthread> pool;
+				pool.reserve(threads - 1);
+				for (uint32_t t = 1; t < threads; ++t) pool.emplace_back(worker, t);
+				worker(0);
+			}
+			if (passCount & 1u)
+			{
+				std::swap(srcKeys, dstKeys);
+				std::swap(srcValues, dstValues);
+			}
+		}
+
+		// Odd pass count: the sorted data sits in the scratch buffers
+		if (srcKeys != keys)
+		{
+			std::memcpy(keys, srcKeys, n * sizeof(uint64_t));
+			std::memcpy(values, srcValues, n * sizeof(uint32_t));
+		}
+	}
+}
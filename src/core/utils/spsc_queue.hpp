@@ -0,0 +1,71 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace luster
+{
+	// Bounded lock-free single-producer/single-consumer ring. tryPush/tryPop never block; push/pop
+	// block on C++20 atomic waits (futex-backed), so an idle side sleeps instead of spinning.
+	// Capacity bounds how far the producer may run ahead of the consumer.
+	template <class T, size_t Capacity>
+	class SpscQueue
+	{
+		static_assert(Capacity > 0, "SpscQueue needs room for at least one element");
+
+	public:
+		bool tryPush(const T& value)
+		{
+			const uint64_t tail = tail_.load(std::memory_order_relaxed);
+			if (tail - head_.load(std::memory_order_acquire) == Capacity) return false;
+			slots_[tail % Capacity] = value;
+			tail_.store(tail + 1, std::memory_order_release);
+			tail_.notify_one();
+			return true;
+		}
+
+		bool tryPop(T& out)
+		{
+			const uint64_t head = head_.load(std::memory_order_relaxed);
+			if (head == tail_.load(std::memory_order_acquire)) return false;
+			out = slots_[head % Capacity];
+			head_.store(head + 1, std::memory_order_release);
+			head_.notify_one();
+			return true;
+		}
+
+		void push(const T& value)
+		{
+			while (!tryPush(value))
+			{
+				// Full: sleep until the consumer advances head past the value we saw
+				const uint64_t head = head_.load(std::memory_order_acquire);
+				if (tail_.load(std::memory_order_relaxed) - head == Capacity) head_.wait(head, std::memory_order_acquire);
+			}
+		}
+
+		T pop()
+		{
+			T out{};
+			while (!tryPop(out))
+			{
+				const uint64_t tail = tail_.load(std::memory_order_acquire);
+				if (tail == head_.load(std::memory_order_relaxed)) tail_.wait(tail, std::memory_order_acquire);
+			}
+			return out;
+		}
+
+		size_t sizeApprox() const
+		{
+			return static_cast<size_t>(tail_.load(std::memory_order_acquire) - head_.load(std::memory_order_acquire));
+		}
+
+	private:
+		// Separate cache lines: producer writes tail_, consumer writes head_
+		alignas(64) std::atomic<uint64_t> head_{0};
+		alignas(64) std::atomic<uint64_t> tail_{0};
+		std::array<T, Capacity> slots_{};
+	};
+}
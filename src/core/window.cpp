@@ -72,6 +72,22 @@ namespace luster
 			case SDL_EVENT_WINDOW_PIXEL_SIZE_CHANGED:
 				framebufferResized = true;
 				break;
+			case SDL_EVENT_WINDOW_MINIMIZED:
+			case SDL_EVENT_WINDOW_HIDDEN:
+				minimized_ = true;
+				break;
+			case SDL_EVENT_WINDOW_RESTORED:
+			case SDL_EVENT_WINDOW_MAXIMIZED:
+			case SDL_EVENT_WINDOW_SHOWN:
+				minimized_ = false;
+				framebufferResized = true; // extent may have changed while hidden
+				break;
+			case SDL_EVENT_WINDOW_OCCLUDED:
+				occluded_ = true;
+				break;
+			case SDL_EVENT_WINDOW_EXPOSED:
+				occluded_ = false;
+				break;
 			default:
 				break;
 			}
@@ -89,6 +105,13 @@ namespace luster
 		return surface;
 	}
 
+	void Window::setSize(int width, int height)
+	{
+		if (!window_) return;
+		SDL_SetWindowSize(window_, width, height);
+		SDL_SyncWindow(window_);
+	}
+
 	void Window::setTitle(const char* title)
 	{
 		if (window_)
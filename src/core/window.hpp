@@ -50,11 +50,19 @@ namespace luster
 		void getSize(int& width, int& height) const;
 		bool pollEvents(bool& framebufferResized);
 		void setTitle(const char* title);
+		// Programmatic resize (scripted benchmarks); blocks until the window system applied it
+		void setSize(int width, int height);
+		// Updated by pollEvents(): nothing visible to draw into, the main loop should throttle
+		bool isMinimized() const { return minimized_; }
+		bool isOccluded() const { return occluded_; }
+		bool isVisible() const { return !minimized_ && !occluded_; }
 
 		// Utility: create Vulkan surface from this window
 		VkSurfaceKHR createVulkanSurface(VkInstance instance) const;
 
 	private:
 		SDL_Window* window_ = nullptr;
+		bool minimized_ = false;
+		bool occluded_ = false;
 	};
 } // namespace luster
@@ -1,11 +1,70 @@
 // Luster Engine - Main entry point
 #include "core/application.hpp"
+#include <algorithm>
 #include <exception>
+#include <cstdio>
 #include <cstdlib>
+#include <string_view>
+
+int main(int argc, char** argv) {
+    luster::EngineConfig config{};
+    // --headless [--frames N] [--size WxH] [--readback out.ppm] [--trace N [out.json]] [--fps N] [--render-thread] [--grid N] [--late-latch]
+    //   [--policy low-latency|max-throughput|power-saver|vsync-strict] [--dynamic-res GPU_MS [MIN_SCALE]]
+    //   [--legacy-render-pass] [--gpu INDEX|NAME]
+    for (int i = 1; i < argc; ++i) {
+        const std::string_view arg = argv[i];
+        if (arg == "--headless") {
+            config.headless.enabled = true;
+        } else if (arg == "--frames" && i + 1 < argc) {
+            config.headless.frameCount = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+        } else if (arg == "--size" && i + 1 < argc) {
+            char* end = nullptr;
+            const unsigned long w = std::strtoul(argv[++i], &end, 10);
+            const unsigned long h = (end && *end == 'x') ? std::strtoul(end + 1, nullptr, 10) : 0;
+            if (w > 0 && h > 0) {
+                config.headless.width = static_cast<uint32_t>(w);
+                config.headless.height = static_cast<uint32_t>(h);
+            }
+        } else if (arg == "--readback" && i + 1 < argc) {
+            config.headless.readbackPath = argv[++i];
+        } else if (arg == "--late-latch") {
+            config.latency.lateLatch = true;
+        } else if (arg == "--policy" && i + 1 < argc) {
+            if (!luster::parseFramePolicy(argv[++i], config.framePolicy))
+                std::fprintf(stderr, "Unknown frame policy '%s', keeping custom\n", argv[i]);
+        } else if (arg == "--dynamic-res" && i + 1 < argc) {
+            config.dynamicResolution.enabled = true;
+            config.dynamicResolution.targetGpuMs = std::strtod(argv[++i], nullptr);
+            if (i + 1 < argc && argv[i + 1][0] != '-')
+                config.dynamicResolution.minScale = std::strtof(argv[++i], nullptr);
+        } else if (arg == "--legacy-render-pass") {
+            config.device.enableDynamicRendering = false;
+        } else if (arg == "--no-async-queues") {
+            config.device.enableAsyncQueues = false;
+        } else if (arg == "--compute-clear") {
+            config.compute.clearPass = true;
+        } else if (arg == "--gpu" && i + 1 < argc) {
+            const std::string_view gpu = argv[++i];
+            if (!gpu.empty() && std::all_of(gpu.begin(), gpu.end(), [](char c) { return c >= '0' && c <= '9'; }))
+                config.device.preferredDeviceIndex = std::atoi(argv[i]);
+            else
+                config.device.preferredDeviceName = gpu;
+        } else if (arg == "--render-thread") {
+            config.threading.renderThread = true;
+        } else if (arg == "--grid" && i + 1 < argc) {
+            config.scene.gridSize = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+        } else if (arg == "--fps" && i + 1 < argc) {
+            config.framePacing.targetFps = std::strtod(argv[++i], nullptr);
+        } else if (arg == "--trace" && i + 1 < argc) {
+            // Capture N frames after a short warm-up
+            config.profiling.captureFrames = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+            config.profiling.captureDelayFrames = 30;
+            if (i + 1 < argc && argv[i + 1][0] != '-') config.profiling.tracePath = argv[++i];
+        }
+    }
 
-int main() {
     try {
-        luster::Application app;
+        luster::Application app(config);
         app.run();
         return EXIT_SUCCESS;
     } catch (const std::exception& e) {
@@ -0,0 +1,74 @@
+#include <gtest/gtest.h>
+#include "core/memory/alloc_tracker.hpp"
+#include "core/memory/linear_arena.hpp"
+#include "core/memory/pool_allocator.hpp"
+#include <memory>
+#include <vector>
+
+using namespace luster;
+
+TEST(AllocTracker, ChargesTaggedScopesAndKeepsPeaks)
+{
+    if (!AllocTracker::kEnabled) GTEST_SKIP() << "allocation tracking is compiled out";
+
+    const AllocTagStats before = AllocTracker::stats(AllocTag::Assets);
+    {
+        LUSTER_ALLOC_TAG(Assets);
+        EXPECT_EQ(AllocTracker::currentTag(), AllocTag::Assets);
+        auto block = std::make_unique<char[]>(100000);
+        {
+            LUSTER_ALLOC_TAG(Simulation); // nested scope wins, then restores
+            EXPECT_EQ(AllocTracker::currentTag(), AllocTag::Simulation);
+        }
+        EXPECT_EQ(AllocTracker::currentTag(), AllocTag::Assets);
+        const AllocTagStats during = AllocTracker::stats(AllocTag::Assets);
+        EXPECT_GE(during.liveBytes, before.liveBytes + 100000);
+        EXPECT_GE(during.peakBytes, during.liveBytes);
+        EXPECT_GT(during.totalAllocations, before.totalAllocations);
+    }
+    EXPECT_EQ(AllocTracker::currentTag(), AllocTag::Untagged);
+    const AllocTagStats after = AllocTracker::stats(AllocTag::Assets);
+    EXPECT_EQ(after.liveBytes, before.liveBytes); // freed, still charged to Assets
+    EXPECT_GE(after.peakBytes, before.liveBytes + 100000);
+
+    // Aligned new takes the same path
+    {
+        LUSTER_ALLOC_TAG(Assets);
+        struct alignas(64) Wide { char bytes[64]; };
+        auto wide = std::make_unique<Wide>();
+        EXPECT_EQ(reinterpret_cast<uintptr_t>(wide.get()) % 64, 0u);
+        EXPECT_GE(AllocTracker::stats(AllocTag::Assets).liveBytes, after.liveBytes + sizeof(Wide));
+    }
+    EXPECT_EQ(AllocTracker::stats(AllocTag::Assets).liveBytes, after.liveBytes);
+}
+
+TEST(AllocTracker, CountsCustomAllocatorsAndSpikes)
+{
+    if (!AllocTracker::kEnabled) GTEST_SKIP() << "allocation tracking is compiled out";
+
+    const uint64_t customBefore = AllocTracker::stats(AllocTag::Renderer).customBytes;
+    {
+        LUSTER_ALLOC_TAG(Renderer);
+        LinearArena arena(4096);
+        PoolAllocator pool(64);
+        arena.allocate(1000);
+        void* block = pool.allocate();
+        EXPECT_GE(AllocTracker::stats(AllocTag::Renderer).customBytes, customBefore + 1000 + 64);
+        pool.deallocate(block);
+        arena.reset();
+        EXPECT_EQ(AllocTracker::stats(AllocTag::Renderer).customBytes, customBefore);
+    }
+
+    AllocTracker::endFrame(); // baseline: the allocations above are no frame
+    for (uint32_t i = 0; i <= AllocTracker::kSpikeWarmupFrames; ++i)
+        EXPECT_FALSE(AllocTracker::endFrame().spike);
+    std::vector<std::unique_ptr<int>> burst;
+    for (int i = 0; i < 1000; ++i) burst.push_back(std::make_unique<int>(i));
+    const AllocFrameReport report = AllocTracker::endFrame();
+    EXPECT_TRUE(report.spike);
+    EXPECT_GE(report.allocations, 1000u);
+
+    const std::string summary = AllocTracker::summary();
+    EXPECT_NE(summary.find("renderer"), std::string::npos);
+    EXPECT_NE(summary.find("allocation sites"), std::string::npos);
+}
@@ -0,0 +1,88 @@
+#include <gtest/gtest.h>
+#include "core/gfx/bind_state_cache.hpp"
+
+using luster::gfx::BindStateCache;
+
+namespace
+{
+    // Opaque fake handles: the cache only compares them
+    template <typename T>
+    T handle(uintptr_t v) { return reinterpret_cast<T>(v); }
+}
+
+TEST(BindStateCacheTest, SkipsIdenticalRebindsUntilReset)
+{
+    BindStateCache cache;
+    const auto pipe = handle<VkPipeline>(0x10);
+    EXPECT_TRUE(cache.setPipeline(pipe));
+    EXPECT_FALSE(cache.setPipeline(pipe));
+    EXPECT_TRUE(cache.setPipeline(handle<VkPipeline>(0x20)));
+
+    const VkBuffer vb = handle<VkBuffer>(0x30);
+    const VkDeviceSize ofs = 0;
+    EXPECT_TRUE(cache.setVertexBuffers(0, &vb, &ofs, 1));
+    EXPECT_FALSE(cache.setVertexBuffers(0, &vb, &ofs, 1));
+    const VkDeviceSize ofs2 = 64;
+    EXPECT_TRUE(cache.setVertexBuffers(0, &vb, &ofs2, 1));
+
+    EXPECT_TRUE(cache.setViewportScissor({640, 480}));
+    EXPECT_FALSE(cache.setViewportScissor({640, 480}));
+
+    cache.reset(); // new command buffer: nothing is known to be bound
+    EXPECT_TRUE(cache.setPipeline(handle<VkPipeline>(0x20)));
+    EXPECT_TRUE(cache.setViewportScissor({640, 480}));
+}
+
+TEST(BindStateCacheTest, StaticViewportPipelineInvalidatesViewport)
+{
+    BindStateCache cache;
+    EXPECT_TRUE(cache.setPipeline(handle<VkPipeline>(0x10)));
+    EXPECT_TRUE(cache.setViewportScissor({640, 480}));
+
+    // Dynamic viewport: the state set before the bind is still in effect
+    EXPECT_TRUE(cache.setPipeline(handle<VkPipeline>(0x20), true));
+    EXPECT_FALSE(cache.setViewportScissor({640, 480}));
+
+    // Baked viewport overwrote it: the next dynamic pipeline needs it set again
+    EXPECT_TRUE(cache.setPipeline(handle<VkPipeline>(0x30), false));
+    EXPECT_TRUE(cache.setPipeline(handle<VkPipeline>(0x10)));
+    EXPECT_TRUE(cache.setViewportScissor({640, 480}));
+}
+
+TEST(BindStateCacheTest, DescriptorSetsCompareDynamicOffsetsAndLayout)
+{
+    BindStateCache cache;
+    const auto layoutA = handle<VkPipelineLayout>(0x100);
+    const auto layoutB = handle<VkPipelineLayout>(0x200);
+    const VkDescriptorSet set0 = handle<VkDescriptorSet>(0x1);
+    const VkDescriptorSet set1 = handle<VkDescriptorSet>(0x2);
+
+    uint32_t offset = 0;
+    EXPECT_TRUE(cache.setDescriptorSets(layoutA, 0, &set0, 1, &offset, 1));
+    EXPECT_FALSE(cache.setDescriptorSets(layoutA, 0, &set0, 1, &offset, 1));
+    offset = 256;
+    EXPECT_TRUE(cache.setDescriptorSets(layoutA, 0, &set0, 1, &offset, 1));
+
+    EXPECT_TRUE(cache.setDescriptorSets(layoutA, 1, &set1, 1, nullptr, 0));
+    EXPECT_FALSE(cache.setDescriptorSets(layoutA, 1, &set1, 1, nullptr, 0));
+    // Rebinding set 0 with another layout may disturb set 1
+    EXPECT_TRUE(cache.setDescriptorSets(layoutB, 0, &set0, 1, &offset, 1));
+    EXPECT_TRUE(cache.setDescriptorSets(layoutA, 1, &set1, 1, nullptr, 0));
+}
+
+TEST(BindStateCacheTest, PushConstantsCompareBytes)
+{
+    BindStateCache cache;
+    const auto layout = handle<VkPipelineLayout>(0x100);
+    float a[4] = {1, 2, 3, 4};
+    EXPECT_TRUE(cache.setPushConstants(layout, VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof(a), a));
+    EXPECT_FALSE(cache.setPushConstants(layout, VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof(a), a));
+    a[3] = 5;
+    EXPECT_TRUE(cache.setPushConstants(layout, VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof(a), a));
+    // Bytes never pushed are unknown, whatever they are compared against
+    const float zeros[4] = {};
+    EXPECT_TRUE(cache.setPushConstants(layout, VK_SHADER_STAGE_VERTEX_BIT, 16, sizeof(zeros), zeros));
+    EXPECT_FALSE(cache.setPushConstants(layout, VK_SHADER_STAGE_VERTEX_BIT, 16, sizeof(zeros), zeros));
+    // Another layout invalidates everything pushed so far
+    EXPECT_TRUE(cache.setPushConstants(handle<VkPipelineLayout>(0x200), VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof(a), a));
+}
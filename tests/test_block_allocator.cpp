@@ -0,0 +1,43 @@
+#include <gtest/gtest.h>
+#include "core/gfx/block_allocator.hpp"
+
+using luster::gfx::BlockAllocator;
+
+TEST(BlockAllocator, AlignsSplitsAndCoalesces)
+{
+    BlockAllocator block(1024);
+    const auto a = block.allocate(100, 1);
+    const auto b = block.allocate(100, 256);
+    const auto c = block.allocate(150, 1);
+    ASSERT_TRUE(a && b && c);
+    EXPECT_EQ(*a, 0u);
+    EXPECT_EQ(*b, 256u);
+    EXPECT_EQ(*c, 100u); // best fit: the alignment gap before b
+    EXPECT_EQ(block.used(), 350u);
+    EXPECT_FALSE(block.allocate(700, 1)); // 668 left at the end
+
+    block.free(*b, 100);
+    block.free(*a, 100);
+    block.free(*c, 150);
+    EXPECT_TRUE(block.empty());
+    EXPECT_EQ(block.freeRangeCount(), 1u);
+    EXPECT_EQ(block.largestFreeRange(), 1024u);
+}
+
+TEST(BlockAllocator, ReusesHolesBestFit)
+{
+    BlockAllocator block(1000);
+    const auto a = block.allocate(300, 1);
+    const auto b = block.allocate(100, 1);
+    const auto c = block.allocate(200, 1);
+    const auto d = block.allocate(100, 1);
+    ASSERT_TRUE(a && b && c && d);
+    block.free(*a, 300);
+    block.free(*c, 200);
+    // Holes of 300, 200 and the 300-byte tail: 150 goes into the 200 hole
+    const auto e = block.allocate(150, 1);
+    ASSERT_TRUE(e);
+    EXPECT_EQ(*e, *c);
+    EXPECT_EQ(block.freeRangeCount(), 3u);
+    EXPECT_EQ(block.freeBytes(), 1000u - 350u);
+}
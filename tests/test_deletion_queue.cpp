@@ -0,0 +1,33 @@
+#include <gtest/gtest.h>
+#include "core/utils/deletion_queue.hpp"
+#include <vector>
+
+using luster::DeletionQueue;
+
+TEST(DeletionQueueTest, FlushesOnlyCompletedFramesInOrder)
+{
+    DeletionQueue q;
+    std::vector<int> destroyed;
+    q.push(1, [&] { destroyed.push_back(1); });
+    q.push(3, [&] { destroyed.push_back(3); });
+    q.push(3, [&] { destroyed.push_back(4); });
+
+    q.flush(0);
+    EXPECT_TRUE(destroyed.empty());
+    q.flush(2);
+    EXPECT_EQ(destroyed, (std::vector<int>{1}));
+    q.flush(3);
+    EXPECT_EQ(destroyed, (std::vector<int>{1, 3, 4}));
+    EXPECT_TRUE(q.empty());
+}
+
+TEST(DeletionQueueTest, FlushAllIgnoresFrames)
+{
+    DeletionQueue q;
+    int count = 0;
+    q.push(100, [&] { ++count; });
+    q.push(200, [&] { ++count; });
+    q.flushAll();
+    EXPECT_EQ(count, 2);
+    EXPECT_EQ(q.size(), 0u);
+}
@@ -0,0 +1,68 @@
+#include <gtest/gtest.h>
+#include "core/gfx/device_selection.hpp"
+#include <vector>
+
+using luster::gfx::DeviceCandidate;
+
+namespace
+{
+    constexpr VkDeviceSize kGiB = 1024ull * 1024ull * 1024ull;
+
+    DeviceCandidate makeCandidate(const char* name, VkPhysicalDeviceType type, VkDeviceSize vram)
+    {
+        DeviceCandidate c{};
+        c.name = name;
+        c.type = type;
+        c.apiVersion = VK_API_VERSION_1_3;
+        c.deviceLocalBytes = vram;
+        c.suitable = true;
+        return c;
+    }
+}
+
+TEST(DeviceSelection, DiscreteBeatsFullyFeaturedIntegratedAndCpu)
+{
+    DeviceCandidate integrated = makeCandidate("Intel Iris Xe", VK_PHYSICAL_DEVICE_TYPE_INTEGRATED_GPU, 16 * kGiB);
+    integrated.timelineSemaphore = integrated.descriptorIndexing = integrated.dynamicRendering = true;
+    integrated.drawIndirectCount = integrated.asyncCompute = integrated.dedicatedTransfer = true;
+    DeviceCandidate discrete = makeCandidate("NVIDIA RTX", VK_PHYSICAL_DEVICE_TYPE_DISCRETE_GPU, 8 * kGiB);
+    discrete.apiVersion = VK_API_VERSION_1_2;
+    const DeviceCandidate cpu = makeCandidate("llvmpipe", VK_PHYSICAL_DEVICE_TYPE_CPU, 64 * kGiB);
+
+    const std::vector<DeviceCandidate> gpus{cpu, integrated, discrete};
+    EXPECT_EQ(luster::gfx::selectDevice(gpus), 2);
+    EXPECT_GT(luster::gfx::scoreDevice(integrated), luster::gfx::scoreDevice(cpu));
+}
+
+TEST(DeviceSelection, FeaturesAndVramBreakTiesWithinAType)
+{
+    DeviceCandidate a = makeCandidate("A", VK_PHYSICAL_DEVICE_TYPE_DISCRETE_GPU, 8 * kGiB);
+    DeviceCandidate b = a;
+    b.name = "B";
+    EXPECT_EQ(luster::gfx::selectDevice({a, b}), 0); // equal scores keep enumeration order
+    b.asyncCompute = true;
+    EXPECT_EQ(luster::gfx::selectDevice({a, b}), 1);
+    a.deviceLocalBytes = 12 * kGiB;
+    EXPECT_EQ(luster::gfx::selectDevice({a, b}), 0);
+}
+
+TEST(DeviceSelection, OverrideByIndexOrNameUnlessUnsuitable)
+{
+    DeviceCandidate integrated = makeCandidate("AMD Radeon(TM) Graphics", VK_PHYSICAL_DEVICE_TYPE_INTEGRATED_GPU, kGiB);
+    DeviceCandidate discrete = makeCandidate("AMD Radeon RX 7900", VK_PHYSICAL_DEVICE_TYPE_DISCRETE_GPU, 24 * kGiB);
+    DeviceCandidate cpu = makeCandidate("llvmpipe (LLVM 17)", VK_PHYSICAL_DEVICE_TYPE_CPU, 0);
+    std::vector<DeviceCandidate> gpus{integrated, discrete, cpu};
+
+    EXPECT_EQ(luster::gfx::selectDevice(gpus, {}, 0), 0);
+    EXPECT_EQ(luster::gfx::selectDevice(gpus, "LLVMPIPE"), 2);
+    EXPECT_EQ(luster::gfx::selectDevice(gpus, "rx 7900"), 1);
+    // Unknown names and out-of-range indices fall back to the score
+    EXPECT_EQ(luster::gfx::selectDevice(gpus, "GeForce"), 1);
+    EXPECT_EQ(luster::gfx::selectDevice(gpus, {}, 7), 1);
+
+    gpus[2].suitable = false; // e.g. no present support for this surface
+    EXPECT_EQ(luster::gfx::selectDevice(gpus, "llvmpipe"), 1);
+    EXPECT_LT(luster::gfx::scoreDevice(gpus[2]), 0);
+    gpus[0].suitable = gpus[1].suitable = false;
+    EXPECT_EQ(luster::gfx::selectDevice(gpus), -1);
+}
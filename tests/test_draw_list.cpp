@@ -0,0 +1,56 @@
+#include <gtest/gtest.h>
+#include "core/draw_list.hpp"
+#include <algorithm>
+#include <random>
+#include <vector>
+
+using luster::DrawList;
+namespace sortkey = luster::sortkey;
+
+namespace
+{
+    // Reference order: stable sort of (key, index) pairs
+    std::vector<uint32_t> referenceOrder(const std::vector<uint64_t>& keys)
+    {
+        std::vector<uint32_t> order(keys.size());
+        for (uint32_t i = 0; i < order.size(); ++i) order[i] = i;
+        std::stable_sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) { return keys[a] < keys[b]; });
+        return order;
+    }
+}
+
+TEST(DrawListTest, RadixSortMatchesStableSortSerialAndParallel)
+{
+    std::mt19937_64 rng(42);
+    std::vector<uint64_t> keys(100000);
+    // Few distinct pipelines/materials so equal keys exercise stability; random depth
+    for (auto& k : keys)
+        k = sortkey::opaque(static_cast<uint32_t>(rng() % 2), static_cast<uint32_t>(rng() % 8),
+                            static_cast<uint32_t>(rng() % 16), 0,
+                            static_cast<float>(rng() % 1000) / 1000.0f);
+    const auto expected = referenceOrder(keys);
+
+    for (uint32_t threads : {1u, 4u})
+    {
+        DrawList list;
+        list.reserve(keys.size());
+        for (uint32_t i = 0; i < keys.size(); ++i) list.add(keys[i], i);
+        list.sort(threads);
+        ASSERT_EQ(list.size(), keys.size());
+        EXPECT_TRUE(std::equal(expected.begin(), expected.end(), list.order())) << threads << " threads";
+        EXPECT_TRUE(std::is_sorted(list.keys(), list.keys() + list.size()));
+    }
+}
+
+TEST(DrawListTest, KeyLayoutOrdersStateThenDepth)
+{
+    // Opaque: pass first, then pipeline beats depth, then front-to-back
+    EXPECT_LT(sortkey::opaque(0, 5, 0, 0, 0.9f), sortkey::opaque(1, 0, 0, 0, 0.1f));
+    EXPECT_LT(sortkey::opaque(0, 1, 0, 0, 0.9f), sortkey::opaque(0, 2, 0, 0, 0.1f));
+    EXPECT_LT(sortkey::opaque(0, 1, 3, 7, 0.2f), sortkey::opaque(0, 1, 3, 7, 0.3f));
+    // Transparent: back-to-front regardless of state
+    EXPECT_LT(sortkey::transparent(2, 0.8f, 9, 0, 0), sortkey::transparent(2, 0.4f, 1, 0, 0));
+    // Depth is clamped into range
+    EXPECT_EQ(sortkey::opaque(0, 0, 0, 0, -1.0f), sortkey::opaque(0, 0, 0, 0, 0.0f));
+    EXPECT_EQ(sortkey::opaque(0, 0, 0, 0, 2.0f), sortkey::opaque(0, 0, 0, 0, 1.0f));
+}
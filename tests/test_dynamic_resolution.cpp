@@ -0,0 +1,46 @@
+#include <gtest/gtest.h>
+#include "core/dynamic_resolution.hpp"
+
+using luster::DynamicResolutionController;
+
+namespace
+{
+    // GPU cost proportional to pixel count: fullMs at scale 1
+    float settle(DynamicResolutionController& drs, double fullMs, int frames)
+    {
+        for (int i = 0; i < frames; ++i)
+        {
+            const double s = drs.scale();
+            drs.update(fullMs * s * s);
+        }
+        return drs.scale();
+    }
+}
+
+TEST(DynamicResolutionTest, ConvergesIntoBudgetAndStaysInRange)
+{
+    DynamicResolutionController::Settings settings{};
+    settings.targetGpuMs = 10.0;
+    DynamicResolutionController drs(settings);
+
+    // Twice as expensive as the budget at full resolution: needs ~0.7 per axis
+    const float s = settle(drs, 20.0, 200);
+    const double ms = 20.0 * s * s;
+    EXPECT_LE(ms, settings.targetGpuMs);
+    EXPECT_GE(ms, settings.targetGpuMs * (1.0 - settings.headroom));
+
+    // Far too expensive: clamps at the minimum rather than going below
+    EXPECT_FLOAT_EQ(settle(drs, 200.0, 200), settings.minScale);
+}
+
+TEST(DynamicResolutionTest, RecoversFullResolutionWhenCheap)
+{
+    DynamicResolutionController::Settings settings{};
+    settings.targetGpuMs = 10.0;
+    DynamicResolutionController drs(settings);
+    settle(drs, 40.0, 200);
+    EXPECT_LT(drs.scale(), 1.0f);
+    EXPECT_FLOAT_EQ(settle(drs, 4.0, 200), 1.0f);
+    // Zero/negative samples (unresolved timings) are ignored
+    EXPECT_FLOAT_EQ(drs.update(0.0), 1.0f);
+}
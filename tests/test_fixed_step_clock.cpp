@@ -0,0 +1,33 @@
+#include <gtest/gtest.h>
+#include "core/utils/fixed_step_clock.hpp"
+
+using luster::FixedStepClock;
+
+TEST(FixedStepClockTest, AccumulatesPartialFrames)
+{
+    FixedStepClock clock(0.01, 8);
+    EXPECT_EQ(clock.advance(0.004), 0u);
+    EXPECT_NEAR(clock.alpha(), 0.4, 1e-9);
+    EXPECT_EQ(clock.advance(0.008), 1u);
+    EXPECT_NEAR(clock.alpha(), 0.2, 1e-9);
+    EXPECT_EQ(clock.totalSteps(), 1u);
+}
+
+TEST(FixedStepClockTest, StepCountIndependentOfFrameRate)
+{
+    FixedStepClock fast(1.0 / 120.0), slow(1.0 / 120.0);
+    uint64_t fastSteps = 0, slowSteps = 0;
+    for (int i = 0; i < 240; ++i) fastSteps += fast.advance(1.0 / 240.0);
+    for (int i = 0; i < 30; ++i) slowSteps += slow.advance(1.0 / 30.0);
+    EXPECT_NEAR(static_cast<double>(fastSteps), 120.0, 1.0);
+    EXPECT_NEAR(static_cast<double>(slowSteps), 120.0, 1.0);
+}
+
+TEST(FixedStepClockTest, ClampsSpiralOfDeath)
+{
+    FixedStepClock clock(0.01, 4);
+    EXPECT_EQ(clock.advance(1.005), 4u); // a 1 s hitch runs at most 4 steps
+    EXPECT_NEAR(clock.droppedSeconds(), 0.96, 1e-9);
+    EXPECT_NEAR(clock.alpha(), 0.5, 1e-6);
+    EXPECT_EQ(clock.advance(0.0), 0u); // nothing left over to catch up on
+}
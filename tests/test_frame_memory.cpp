@@ -0,0 +1,83 @@
+#include <gtest/gtest.h>
+#include "core/memory/frame_arenas.hpp"
+#include "core/memory/heap_counter.hpp"
+#include "core/memory/scratch.hpp"
+#include "core/utils/function_ref.hpp"
+#include <list>
+#include <vector>
+
+using namespace luster;
+
+TEST(FrameMemory, ScratchScopesNestAndRewind)
+{
+    const size_t before = ScratchScope::threadUsed();
+    {
+        ScratchScope outer;
+        outer.allocArray<int>(100);
+        const size_t afterOuter = ScratchScope::threadUsed();
+        {
+            ScratchScope inner;
+            std::pmr::vector<int> v(inner.resource());
+            v.reserve(1000);
+            EXPECT_GT(ScratchScope::threadUsed(), afterOuter);
+        }
+        EXPECT_EQ(ScratchScope::threadUsed(), afterOuter);
+    }
+    EXPECT_EQ(ScratchScope::threadUsed(), before);
+}
+
+TEST(FrameMemory, PoolRecyclesBlocks)
+{
+    PoolAllocator pool(24, 8, 4);
+    void* a = pool.allocate();
+    void* b = pool.allocate();
+    EXPECT_EQ(pool.capacity(), 4u);
+    pool.deallocate(a);
+    EXPECT_EQ(pool.allocate(), a); // LIFO free list
+    pool.deallocate(b);
+    pool.deallocate(a);
+    EXPECT_EQ(pool.live(), 0u);
+
+    PoolResource resource(pool);
+    std::pmr::list<int> list(&resource);
+    for (int i = 0; i < 10; ++i) list.push_back(i);
+    EXPECT_EQ(pool.live(), 10u);
+    list.clear();
+    EXPECT_EQ(pool.live(), 0u);
+}
+
+TEST(FrameMemory, SteadyStateFrameMakesNoHeapAllocations)
+{
+    if (!kHeapCountingEnabled) GTEST_SKIP() << "heap counting is compiled out (Release)";
+
+    FrameArenas arenas;
+    arenas.reserve(16 * 1024);
+    PoolAllocator pool(32, 16, 64);
+    pool.reserve(64);
+    PoolResource nodes(pool);
+    {
+        // Baseline: the counter sees an ordinary std::vector
+        HeapAllocationScope heap;
+        std::vector<int> v(16);
+        EXPECT_GT(heap.allocations(), 0u);
+    }
+
+    for (uint32_t frame = 0; frame < 6; ++frame)
+    {
+        HeapAllocationScope heap;
+        arenas.begin(frame % FrameArenas::kMaxSlots);
+        std::pmr::vector<float> perFrame(arenas.resource());
+        perFrame.resize(256, 1.0f);
+        ScratchScope scratch;
+        std::pmr::vector<int> temp(scratch.resource());
+        temp.assign(512, 7);
+        std::pmr::list<int> list(&nodes);
+        for (int i = 0; i < 32; ++i) list.push_back(i);
+        int sum = 0;
+        const auto record = [&](int x) { sum += x + temp[0] + static_cast<int>(perFrame.size()); };
+        FunctionRef<void(int)> callback = record;
+        callback(1);
+        EXPECT_GT(sum, 0);
+        EXPECT_EQ(heap.allocations(), 0u) << "frame " << frame;
+    }
+}
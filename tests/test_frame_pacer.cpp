@@ -0,0 +1,33 @@
+#include <gtest/gtest.h>
+#include "core/frame_pacer.hpp"
+
+using luster::FramePacer;
+
+namespace
+{
+    double elapsedMs(FramePacer::Clock::time_point since)
+    {
+        return std::chrono::duration<double, std::milli>(FramePacer::Clock::now() - since).count();
+    }
+}
+
+TEST(FramePacerTest, UnlimitedDoesNotWait)
+{
+    FramePacer pacer;
+    EXPECT_FALSE(pacer.isLimited());
+    const auto t0 = FramePacer::Clock::now();
+    for (int i = 0; i < 1000; ++i) pacer.wait();
+    EXPECT_LT(elapsedMs(t0), 50.0);
+}
+
+TEST(FramePacerTest, NeverFinishesFramesEarly)
+{
+    FramePacer pacer(200.0); // 5 ms period
+    pacer.wait(); // establishes the first deadline
+    const auto t0 = FramePacer::Clock::now();
+    constexpr int frames = 20;
+    for (int i = 0; i < frames; ++i) pacer.wait();
+    const double ms = elapsedMs(t0);
+    EXPECT_GE(ms, frames * 5.0 - 5.0); // the first deadline was set before t0
+    EXPECT_LT(ms, frames * 5.0 * 4.0); // loose upper bound for loaded CI machines
+}
@@ -0,0 +1,39 @@
+#include <gtest/gtest.h>
+#include "core/frame_policy.hpp"
+
+using luster::FramePolicy;
+
+TEST(FramePolicyTest, NamesRoundTrip)
+{
+    for (FramePolicy p : {FramePolicy::Custom, FramePolicy::LowLatency, FramePolicy::MaxThroughput,
+                          FramePolicy::PowerSaver, FramePolicy::VsyncStrict})
+    {
+        FramePolicy parsed = FramePolicy::Custom;
+        ASSERT_TRUE(luster::parseFramePolicy(luster::toString(p), parsed));
+        EXPECT_EQ(parsed, p);
+    }
+    FramePolicy unchanged = FramePolicy::PowerSaver;
+    EXPECT_FALSE(luster::parseFramePolicy("turbo", unchanged));
+    EXPECT_EQ(unchanged, FramePolicy::PowerSaver);
+}
+
+TEST(FramePolicyTest, SettingsOverrideOnlyDeliveryFields)
+{
+    luster::gfx::SwapchainCreateInfo base{};
+    base.preferredFormat = VK_FORMAT_R8G8B8A8_UNORM;
+    base.preferredPresentMode = VK_PRESENT_MODE_IMMEDIATE_KHR;
+
+    const auto custom = luster::framePolicySettings(FramePolicy::Custom, base, 2);
+    EXPECT_EQ(custom.swapchain.preferredPresentMode, VK_PRESENT_MODE_IMMEDIATE_KHR);
+    EXPECT_EQ(custom.framesInFlight, 2u);
+
+    const auto strict = luster::framePolicySettings(FramePolicy::VsyncStrict, base, 1);
+    EXPECT_EQ(strict.swapchain.preferredFormat, VK_FORMAT_R8G8B8A8_UNORM);
+    EXPECT_EQ(strict.swapchain.preferredPresentMode, VK_PRESENT_MODE_FIFO_KHR);
+    EXPECT_TRUE(strict.swapchain.fallbacks().empty());
+    EXPECT_EQ(strict.framesInFlight, 2u);
+
+    const auto throughput = luster::framePolicySettings(FramePolicy::MaxThroughput, base, 1);
+    EXPECT_EQ(throughput.framesInFlight, 3u);
+    EXPECT_GT(throughput.swapchain.extraImages, base.extraImages);
+}
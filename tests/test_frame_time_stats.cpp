@@ -0,0 +1,36 @@
+#include <gtest/gtest.h>
+#include "core/utils/frame_time_stats.hpp"
+
+using luster::summarizeFrameTimes;
+
+TEST(FrameTimeStatsTest, EmptyInput)
+{
+    const auto s = summarizeFrameTimes({});
+    EXPECT_EQ(s.count, 0u);
+    EXPECT_DOUBLE_EQ(s.p99Ms, 0.0);
+}
+
+TEST(FrameTimeStatsTest, PercentilesInterpolate)
+{
+    std::vector<double> samples;
+    for (int i = 100; i >= 1; --i) samples.push_back(static_cast<double>(i)); // unsorted on purpose
+    const auto s = summarizeFrameTimes(samples);
+    EXPECT_EQ(s.count, 100u);
+    EXPECT_DOUBLE_EQ(s.minMs, 1.0);
+    EXPECT_DOUBLE_EQ(s.maxMs, 100.0);
+    EXPECT_DOUBLE_EQ(s.meanMs, 50.5);
+    EXPECT_DOUBLE_EQ(s.p50Ms, 50.5);
+    EXPECT_NEAR(s.p95Ms, 95.05, 1e-9);
+    EXPECT_NEAR(s.p99Ms, 99.01, 1e-9);
+}
+
+TEST(FrameTimeStatsTest, CountsStuttersAgainstMedian)
+{
+    std::vector<double> samples(97, 16.6);
+    samples.push_back(33.3);  // > 2x median
+    samples.push_back(50.0);
+    samples.push_back(30.0);  // < 2x median
+    const auto s = summarizeFrameTimes(samples, 2.0);
+    EXPECT_EQ(s.stutterCount, 2u);
+    EXPECT_EQ(summarizeFrameTimes(samples, 1.5).stutterCount, 3u);
+}
@@ -0,0 +1,58 @@
+#include <gtest/gtest.h>
+#include "core/utils/handle_pool.hpp"
+#include <string>
+
+using luster::Handle;
+using luster::HandlePool;
+
+TEST(HandlePool, StaleHandlesStopResolvingAfterRemove)
+{
+    HandlePool<std::string> pool;
+    const auto a = pool.insert("a");
+    const auto b = pool.insert("b");
+    const auto c = pool.insert("c");
+    EXPECT_EQ(sizeof(a), 4u);
+    EXPECT_FALSE(Handle<std::string>{}.valid());
+
+    EXPECT_EQ(pool.remove(a), "a");
+    EXPECT_FALSE(pool.contains(a));
+    EXPECT_EQ(pool.get(a), nullptr);
+    // The last object filled the hole: storage stays dense, other handles still resolve
+    EXPECT_EQ(pool.size(), 2u);
+    EXPECT_EQ(pool.objects()[0], "c");
+    EXPECT_EQ(pool.at(b), "b");
+    EXPECT_EQ(pool.at(c), "c");
+    EXPECT_EQ(pool.handleAt(0), c);
+    EXPECT_EQ(pool.handleAt(1), b);
+
+    // Slot reused with a new generation: the old handle does not alias the new object
+    const auto d = pool.insert("d");
+    EXPECT_EQ(d.index(), a.index());
+    EXPECT_NE(d.generation(), a.generation());
+    EXPECT_EQ(pool.get(a), nullptr);
+    EXPECT_EQ(*pool.get(d), "d");
+#if LUSTER_CHECK_HANDLES
+    EXPECT_THROW(pool.at(a), std::runtime_error);
+#endif
+    EXPECT_THROW(pool.remove(a), std::runtime_error);
+
+    pool.clear();
+    EXPECT_TRUE(pool.empty());
+    EXPECT_FALSE(pool.contains(b));
+}
+
+TEST(HandlePool, RetiresSlotsWhoseGenerationIsUsedUp)
+{
+    HandlePool<int> pool;
+    auto h = pool.insert(0);
+    const uint32_t index = h.index();
+    for (uint32_t i = 1; i < Handle<int>::kMaxGeneration; ++i)
+    {
+        pool.remove(h);
+        h = pool.insert(static_cast<int>(i));
+        ASSERT_EQ(h.index(), index);
+    }
+    EXPECT_EQ(h.generation(), Handle<int>::kMaxGeneration);
+    pool.remove(h);
+    EXPECT_NE(pool.insert(-1).index(), index);
+}
@@ -0,0 +1,26 @@
+#include <gtest/gtest.h>
+#include "core/memory/linear_arena.hpp"
+
+using luster::LinearArena;
+
+TEST(LinearArenaTest, AlignsAndResets)
+{
+    LinearArena arena(256);
+    auto* a = arena.allocArray<uint8_t>(3);
+    auto* b = arena.allocArray<double>(2);
+    EXPECT_NE(a, nullptr);
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(b) % alignof(double), 0u);
+    EXPECT_GE(arena.used(), 3 + 2 * sizeof(double));
+    const size_t used = arena.used();
+    arena.reset();
+    EXPECT_EQ(arena.used(), 0u);
+    EXPECT_EQ(arena.highWater(), used);
+    EXPECT_EQ(arena.allocArray<uint8_t>(1), a); // memory is reused from the start
+}
+
+TEST(LinearArenaTest, ThrowsWhenExhausted)
+{
+    LinearArena arena(64);
+    EXPECT_NO_THROW(arena.allocate(64, 1));
+    EXPECT_THROW(arena.allocate(1, 1), std::bad_alloc);
+}
@@ -0,0 +1,145 @@
+#include <gtest/gtest.h>
+#include "core/utils/log.hpp"
+#include <spdlog/sinks/base_sink.h>
+#include <spdlog/sinks/ostream_sink.h>
+#include <atomic>
+#include <mutex>
+#include <sstream>
+#include <string>
+
+using namespace luster;
+
+namespace
+{
+    struct Vec2
+    {
+        float x, y;
+    };
+}
+
+template <>
+struct luster::LogDeferrable<Vec2> : std::true_type {};
+
+template <>
+struct fmt::formatter<Vec2> : fmt::formatter<float>
+{
+    auto format(const Vec2& v, format_context& ctx) const
+    {
+        ctx.advance_to(fmt::formatter<float>::format(v.x, ctx));
+        ctx.advance_to(fmt::format_to(ctx.out(), ", "));
+        return fmt::formatter<float>::format(v.y, ctx);
+    }
+};
+
+namespace
+{
+    // Refers to storage it does not own: must be formatted before the call returns
+    struct Counter
+    {
+        const int* value;
+    };
+
+    // Holds the writer thread in its first message until released
+    class GateSink final : public spdlog::sinks::base_sink<std::mutex>
+    {
+    public:
+        std::atomic<bool> open{false};
+        std::string text;
+
+    protected:
+        void sink_it_(const spdlog::details::log_msg& msg) override
+        {
+            while (!open.load()) std::this_thread::yield();
+            text.append(msg.payload.data(), msg.payload.size()).push_back('\n');
+        }
+        void flush_() override {}
+    };
+}
+
+template <>
+struct fmt::formatter<Counter> : fmt::formatter<int>
+{
+    auto format(const Counter& c, format_context& ctx) const { return fmt::formatter<int>::format(*c.value, ctx); }
+};
+
+TEST(Log, DeferredAndEagerMessagesKeepOrder)
+{
+    std::ostringstream out;
+    auto sink = std::make_shared<spdlog::sinks::ostream_sink_mt>(out);
+    sink->set_pattern("%l %v");
+    Log::init({sink});
+    Log::core()->set_level(spdlog::level::info);
+
+    const Vec2 v{1.5f, -2.0f};
+    Log::info("deferred {} {:.2f} {:.1f}", 42, 3.14159, v.x + v.y); // trivially copyable: formatted by the writer
+    std::string name = "eager";
+    Log::warn("{} string", name); // formatted now: the string may be gone by then
+    Log::debug("filtered {}", 1);
+    spdlog::info("spdlog {}", 7);
+    const std::string longLine(300, 'x');
+    spdlog::error("{}", longLine);
+    Log::flush();
+
+    EXPECT_EQ(out.str(), "info deferred 42 3.14 -0.5\nwarning eager string\ninfo spdlog 7\nerror " + longLine + "\n");
+    EXPECT_EQ(Log::droppedCount(), 0u);
+    Log::shutdown();
+}
+
+TEST(Log, RuntimeFormatStringsAreFormattedEagerly)
+{
+    std::ostringstream out;
+    auto sink = std::make_shared<spdlog::sinks::ostream_sink_mt>(out);
+    sink->set_pattern("%v");
+    Log::init({sink});
+    Log::core()->set_level(spdlog::level::info);
+
+    {
+        // Only numbers: would be deferred, but the format text dies with this scope
+        std::string format = "runtime {} {}";
+        Log::info(fmt::runtime(format), 1, 2.5);
+        format.assign(format.size(), '#');
+    }
+    Log::flush();
+
+    EXPECT_EQ(out.str(), "runtime 1 2.5\n");
+    Log::shutdown();
+}
+
+TEST(Log, FullQueueDropsInsteadOfBlocking)
+{
+    auto sink = std::make_shared<GateSink>();
+    sink->set_pattern("%v");
+    Log::init({sink});
+    Log::core()->set_level(spdlog::level::info);
+
+    // The writer is stuck in the first message, so its cell stays taken and the ring fills up
+    constexpr uint64_t kExtra = 10;
+    for (uint64_t i = 0; i < Log::kQueueCapacity + kExtra; ++i)
+        Log::info("message {}", i);
+    EXPECT_EQ(Log::droppedCount(), kExtra);
+
+    sink->open = true;
+    Log::flush();
+    EXPECT_NE(sink->text.find("message 0\n"), std::string::npos);
+    EXPECT_NE(sink->text.find("Log queue full: 10 messages dropped"), std::string::npos);
+    Log::shutdown();
+}
+
+TEST(Log, OnlyAllowlistedArgumentsAreDeferred)
+{
+    auto sink = std::make_shared<GateSink>();
+    sink->set_pattern("%v");
+    Log::init({sink});
+    Log::core()->set_level(spdlog::level::info);
+
+    Log::info("hold"); // the writer waits in this one while the rest is queued
+    int value = 1;
+    Log::info("counter {}", Counter{&value}); // trivially copyable, but points elsewhere: formatted now
+    Log::info("vec {:.1f}", Vec2{1.0f, 2.0f}); // registered value type: copied and formatted by the writer
+    value = 2;
+
+    sink->open = true;
+    Log::flush();
+    EXPECT_EQ(sink->text, "hold\ncounter 1\nvec 1.0, 2.0\n");
+    Log::shutdown();
+}
@@ -0,0 +1,74 @@
+#include <gtest/gtest.h>
+#include "core/gfx/memory_budget.hpp"
+#include <vector>
+
+using luster::gfx::MemoryBudget;
+using luster::gfx::MemoryCategory;
+
+namespace
+{
+    constexpr VkDeviceSize kMiB = 1024ull * 1024ull;
+}
+
+TEST(MemoryBudget, TracksHeapsAndCategoriesWithFallbackBudget)
+{
+    MemoryBudget budget;
+    budget.addHeap(1000 * kMiB, true);
+    budget.addHeap(4000 * kMiB, false);
+    budget.onAllocate(0, MemoryCategory::Texture, 300 * kMiB);
+    budget.onAllocate(0, MemoryCategory::Mesh, 100 * kMiB);
+    budget.onAllocate(1, MemoryCategory::Staging, 50 * kMiB);
+    budget.onFree(0, MemoryCategory::Mesh, 100 * kMiB);
+
+    const auto stats = budget.stats();
+    ASSERT_EQ(stats.heaps.size(), 2u);
+    EXPECT_FALSE(stats.driverBudget);
+    EXPECT_EQ(stats.heaps[0].usage, 300 * kMiB);
+    EXPECT_EQ(stats.heaps[0].budget, 800 * kMiB); // kFallbackBudgetFraction of the heap
+    EXPECT_EQ(stats.deviceLocalUsage(), 300 * kMiB);
+    EXPECT_EQ(stats.categoryBytes[static_cast<size_t>(MemoryCategory::Texture)], 300 * kMiB);
+    EXPECT_EQ(stats.categoryBytes[static_cast<size_t>(MemoryCategory::Mesh)], 0u);
+    EXPECT_EQ(stats.categoryAllocations[static_cast<size_t>(MemoryCategory::Staging)], 1u);
+
+    EXPECT_FALSE(budget.wouldExceed(0, MemoryCategory::Texture, 500 * kMiB));
+    EXPECT_TRUE(budget.wouldExceed(0, MemoryCategory::Texture, 501 * kMiB));
+    budget.setDriverBudget(0, 2000 * kMiB, 1200 * kMiB); // driver usage includes allocations we don't see
+    EXPECT_TRUE(budget.stats().driverBudget);
+    EXPECT_FALSE(budget.wouldExceed(0, MemoryCategory::Texture, 800 * kMiB));
+}
+
+TEST(MemoryBudget, EnforceEvictsLeastRecentlyUsedResidentsNotInFlight)
+{
+    MemoryBudget budget;
+    budget.addHeap(1000 * kMiB, true);
+    budget.setSoftBudget(MemoryCategory::Texture, 250 * kMiB);
+    std::vector<int> evicted;
+    MemoryBudget::ResidentId ids[4];
+    for (int i = 0; i < 4; ++i)
+    {
+        budget.onAllocate(0, MemoryCategory::Texture, 100 * kMiB);
+        ids[i] = budget.addResident(0, MemoryCategory::Texture, 100 * kMiB, [&evicted, i] { evicted.push_back(i); });
+    }
+    budget.touch(ids[0], 5);
+    budget.touch(ids[1], 2);
+    budget.touch(ids[2], 9); // still in flight below
+    budget.touch(ids[3], 3);
+    budget.setCompletedFrame(6);
+
+    // 400 MiB against 250: the two least recently used go, the in-flight one is never picked
+    EXPECT_EQ(budget.enforce(), 200 * kMiB);
+    EXPECT_EQ(evicted, (std::vector<int>{1, 3}));
+    // Evicted bytes count as pending until freed: no second round
+    EXPECT_EQ(budget.enforce(), 0u);
+    budget.onFree(0, MemoryCategory::Texture, 100 * kMiB);
+    budget.onFree(0, MemoryCategory::Texture, 100 * kMiB);
+    budget.removeResident(ids[1]);
+    budget.removeResident(ids[3]);
+    EXPECT_EQ(budget.enforce(), 0u);
+    EXPECT_EQ(budget.stats().evictions, 2u);
+
+    // Heap pressure: allocation-time eviction takes the remaining non-in-flight resident
+    EXPECT_EQ(budget.evict(0, 1), 100 * kMiB);
+    EXPECT_EQ(evicted.back(), 0);
+    EXPECT_EQ(budget.evict(0, 1), 0u);
+}
@@ -0,0 +1,76 @@
+#include <gtest/gtest.h>
+#include "core/utils/profiler.hpp"
+#include <string>
+#include <thread>
+
+using luster::Profiler;
+
+namespace
+{
+    size_t countOf(const std::string& s, const std::string& needle)
+    {
+        size_t n = 0;
+        for (size_t pos = s.find(needle); pos != std::string::npos; pos = s.find(needle, pos + 1)) ++n;
+        return n;
+    }
+
+    void nested()
+    {
+        PROFILE_SCOPE("outer");
+        PROFILE_SCOPE("inner");
+    }
+}
+
+TEST(ProfilerTest, ZonesAreSkippedWhileIdle)
+{
+    EXPECT_FALSE(Profiler::isCapturing());
+    EXPECT_FALSE(Profiler::beginZone("idle"));
+}
+
+TEST(ProfilerTest, CapturesFrameRangeWithNestingAndThreads)
+{
+    Profiler::setThreadName("main");
+    Profiler::requestCapture(2, 1);
+
+    PROFILE_FRAME_MARK(); // consumes the delay
+    nested();
+    EXPECT_FALSE(Profiler::isCapturing());
+
+    PROFILE_FRAME_MARK(); // capture starts
+    EXPECT_TRUE(Profiler::isCapturing());
+    nested();
+    std::thread worker([]
+    {
+        Profiler::setThreadName("worker");
+        PROFILE_SCOPE("job");
+    });
+    worker.join();
+    PROFILE_FRAME_MARK();
+    nested();
+    PROFILE_FRAME_MARK(); // capture stops after 2 frames
+
+    EXPECT_FALSE(Profiler::isCapturing());
+    ASSERT_TRUE(Profiler::hasCompletedCapture());
+    const std::string json = Profiler::chromeTraceJson();
+
+    EXPECT_EQ(countOf(json, "\"name\":\"outer\""), 2u);
+    EXPECT_EQ(countOf(json, "\"name\":\"inner\""), 2u);
+    EXPECT_EQ(countOf(json, "\"name\":\"job\""), 1u);
+    EXPECT_EQ(countOf(json, "\"ph\":\"B\""), countOf(json, "\"ph\":\"E\""));
+    EXPECT_NE(json.find("\"name\":\"main\""), std::string::npos);
+    EXPECT_NE(json.find("\"name\":\"worker\""), std::string::npos);
+    EXPECT_EQ(countOf(json, "\"ph\":\"i\""), 2u);
+}
+
+TEST(ProfilerTest, ClosesZonesOpenAtCaptureEnd)
+{
+    Profiler::requestCapture(1);
+    PROFILE_FRAME_MARK();
+    {
+        PROFILE_SCOPE("spans_end");
+        PROFILE_FRAME_MARK();
+    }
+    const std::string json = Profiler::chromeTraceJson();
+    EXPECT_EQ(countOf(json, "\"name\":\"spans_end\""), 1u);
+    EXPECT_EQ(countOf(json, "\"ph\":\"B\""), countOf(json, "\"ph\":\"E\""));
+}
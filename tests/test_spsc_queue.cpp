@@ -0,0 +1,35 @@
+#include <gtest/gtest.h>
+#include "core/utils/spsc_queue.hpp"
+#include <thread>
+
+using luster::SpscQueue;
+
+TEST(SpscQueueTest, RespectsCapacity)
+{
+    SpscQueue<int, 2> q;
+    EXPECT_TRUE(q.tryPush(1));
+    EXPECT_TRUE(q.tryPush(2));
+    EXPECT_FALSE(q.tryPush(3));
+    int v = 0;
+    EXPECT_TRUE(q.tryPop(v));
+    EXPECT_EQ(v, 1);
+    EXPECT_TRUE(q.tryPush(3));
+    EXPECT_EQ(q.pop(), 2);
+    EXPECT_EQ(q.pop(), 3);
+    EXPECT_FALSE(q.tryPop(v));
+}
+
+TEST(SpscQueueTest, BlockingTransferKeepsOrder)
+{
+    SpscQueue<uint32_t, 1> q;
+    constexpr uint32_t count = 20000;
+    std::thread producer([&] { for (uint32_t i = 1; i <= count; ++i) q.push(i); });
+    uint32_t expected = 1;
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        const uint32_t v = q.pop();
+        ASSERT_EQ(v, expected);
+        ++expected;
+    }
+    producer.join();
+}